@@ -0,0 +1,149 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : autosave.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "autosave.h"
+
+#include <utility>
+
+/*  ############################################################################
+ *  constructor: create the writer and start its thread
+ *  @param  parent: the parent object  */
+Autosave::Autosave(QObject* parent) : QObject(parent), numPending(0) {
+    //  the writer lives in the thread, and is deleted there
+    thread = new QThread(this);
+    writer = new Writer;
+    writer->moveToThread(thread);
+    connect(thread, &QThread::finished, writer, &QObject::deleteLater);
+
+    //  the results are delivered to the main thread
+    connect(writer, &Writer::saved, this, [&](int numRecords) {
+        --numPending;
+        emit saved(numRecords);
+    });
+    connect(writer, &Writer::failed, this, [&](const QString& error) {
+        --numPending;
+        emit failed(error);
+    });
+    //  the file is opened again when it is set next time
+    connect(writer, &Writer::unopened, this,
+            [&](const QString& file, const QString& error) {
+                if (this->file == file) this->file.clear();
+                emit unopened(file, error);
+            });
+    thread->start();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: finish the queued snapshots and stop the thread  */
+Autosave::~Autosave() {
+    //  the thread quits after the queued snapshots
+    QThread* worker = thread;
+    QMetaObject::invokeMethod(writer, [worker]() { worker->quit(); },
+                              Qt::QueuedConnection);
+    thread->wait();
+}
+
+/*  ############################################################################
+ *  setFile: set the project file, which is opened by the writer, and cleared
+ *  if it cannot be opened so that it is opened again next time
+ *  @param  file: the path of the project file  */
+void Autosave::setFile(const QString& file) {
+    if (this->file == file) return;
+    this->file = file;
+    Writer* worker = writer;
+    QMetaObject::invokeMethod(
+        writer, [worker, file]() { worker->open(file); },
+        Qt::QueuedConnection);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  submit: queue the snapshot to be written in one transaction
+ *  @param  records: the statements of the snapshot  */
+void Autosave::submit(const QVector<Record>& records) {
+    if (records.isEmpty()) return;
+    ++numPending;
+    Writer* worker = writer;
+    QMetaObject::invokeMethod(
+        writer, [worker, records]() { worker->write(records); },
+        Qt::QueuedConnection);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  close: wait for the queued snapshots and release the project file  */
+void Autosave::close() {
+    file.clear();
+    Writer* worker = writer;
+    QMetaObject::invokeMethod(
+        writer, [worker]() { worker->open(QString()); },
+        Qt::BlockingQueuedConnection);
+}
+
+/*  ############################################################################
+ *  open: open the project file, an empty file closes the connection, the
+ *  rolled back snapshots of another file are dropped
+ *  @param  file: the path of the project file  */
+void Writer::open(const QString& file) {
+    if (database == nullptr) database = new Database("AUTOSAVE");
+    if (this->file != file) unsaved.clear();
+    this->file = file;
+    if (file.isEmpty()) {
+        database->close();
+    } else if (!database->open(file)) {
+        this->file.clear();
+        emit unopened(file, database->getError());
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  write: write the rolled back snapshots and the snapshot in one
+ *  transaction, which are kept for the next one if it fails
+ *  @param  records: the statements of the snapshot  */
+void Writer::write(const QVector<Autosave::Record>& records) {
+    //  the dirty flags of the rolled back snapshots have been cleared
+    unsaved += records;
+    if (database == nullptr || !database->isOpen()) {
+        emit failed("The project file is not opened.");
+        return;
+    }
+    if (!database->begin()) {
+        emit failed(database->getError());
+        return;
+    }
+
+    for (const Autosave::Record& record : std::as_const(unsaved)) {
+        //  the indices of the sets are stored as the raw block
+        QVariantList values = record.values;
+        for (QVariant& value : values) {
+            if (value.metaType() != QMetaType::fromType<QVector<int>>()) {
+                continue;
+            }
+            QVector<int> data = value.value<QVector<int>>();
+            value = QByteArray(reinterpret_cast<const char*>(data.constData()),
+                               data.size() * sizeof(int));
+        }
+        if (!database->exec(record.sql, values)) {
+            database->rollback();
+            emit failed(database->getError());
+            return;
+        }
+    }
+
+    if (!database->commit()) {
+        emit failed(database->getError());
+        return;
+    }
+    emit saved(unsaved.size());
+    unsaved.clear();
+}
@@ -0,0 +1,147 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : autosave.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QVariantList>
+#include <QVector>
+
+#include "database.h"
+
+class Writer;
+
+/*  ############################################################################
+ *  class Autosave: write the snapshots of the project to the project file on
+ *      a background thread. The snapshot is the list of the statements with
+ *      their bound values, which are the implicitly shared copies of the
+ *      entities, so that taking the snapshot never copies the data of the
+ *      large sets and the UI is never blocked by the disk. The rolled back
+ *      snapshot is kept by the writer and written again before the next
+ *      one, so the snapshots stay incremental after a failure.  */
+class Autosave : public QObject {
+    Q_OBJECT
+
+public:
+    class Record;      // the statement and its values in the snapshot
+
+private:
+    QThread* thread;   // the thread of the writer
+    Writer* writer;    // the writer living in the thread
+    QString file;      // the project file to be written
+    int numPending;    // number of the snapshots in the queue
+
+public:
+    /*  ########################################################################
+     *  constructor: create the writer and start its thread
+     *  @param  parent: the parent object  */
+    explicit Autosave(QObject* parent = nullptr);
+
+    /*  destructor: finish the queued snapshots and stop the thread  */
+    ~Autosave();
+
+    /*  setFile: set the project file, which is opened by the writer, and
+     *  cleared if it cannot be opened so that it is opened again next time
+     *  @param  file: the path of the project file  */
+    void setFile(const QString& file);
+
+    /*  getFile: get the project file
+     *  @return  the path of the project file  */
+    const QString& getFile() { return file; }
+
+    /*  isBusy: check whether the snapshots are still being written
+     *  @return  true if any snapshot is in the queue  */
+    bool isBusy() { return numPending > 0; }
+
+    /*  submit: queue the snapshot to be written in one transaction
+     *  @param  records: the statements of the snapshot  */
+    void submit(const QVector<Record>& records);
+
+    /*  close: wait for the queued snapshots and release the project file  */
+    void close();
+
+signals:
+    /*  saved: the snapshot has been committed
+     *  @param  numRecords: the number of the written statements  */
+    void saved(int numRecords);
+
+    /*  failed: the snapshot has been rolled back
+     *  @param  error: the error of the database  */
+    void failed(const QString& error);
+
+    /*  unopened: the project file cannot be opened, and nothing is written
+     *  until another file is set
+     *  @param  file: the path of the project file
+     *  @param  error: the error of the database  */
+    void unopened(const QString& file, const QString& error);
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Autosave::Record: one statement of the snapshot, the sets are kept
+ *  as the QVector<int> and converted to the blob on the writer thread  */
+class Autosave::Record {
+public:
+    QString sql;          // the statement with the positional placeholders
+    QVariantList values;  // the values bound to the placeholders
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Writer: the worker of Autosave, which owns its own connection of the
+ *  project file and is only used on the thread of Autosave  */
+class Writer : public QObject {
+    Q_OBJECT
+
+private:
+    Database* database;                 // the connection of the writer thread
+    QString file;                       // the opened project file
+    QVector<Autosave::Record> unsaved;  // the rolled back snapshots
+
+public:
+    /*  constructor: create the writer, the connection is created lazily on
+     *  the writer thread  */
+    Writer() : database(nullptr) {}
+
+    /*  destructor: close the connection  */
+    ~Writer() { delete database; }
+
+    /*  open: open the project file, an empty file closes the connection, the
+     *  rolled back snapshots of another file are dropped
+     *  @param  file: the path of the project file  */
+    void open(const QString& file);
+
+    /*  write: write the rolled back snapshots and the snapshot in one
+     *  transaction, which are kept for the next one if it fails
+     *  @param  records: the statements of the snapshot  */
+    void write(const QVector<Autosave::Record>& records);
+
+signals:
+    /*  saved: the snapshot has been committed
+     *  @param  numRecords: the number of the written statements  */
+    void saved(int numRecords);
+
+    /*  failed: the snapshot has been rolled back
+     *  @param  error: the error of the database  */
+    void failed(const QString& error);
+
+    /*  unopened: the project file cannot be opened
+     *  @param  file: the path of the project file
+     *  @param  error: the error of the database  */
+    void unopened(const QString& file, const QString& error);
+};
+
+#endif  // AUTOSAVE_H
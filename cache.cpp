@@ -0,0 +1,216 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : cache.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "cache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+/*  ############################################################################
+ *  constructor: create the result cache with the memory budget
+ *  @param  size: the memory budget in mebibytes  */
+Cache::Cache(const qint64 size) {
+    budget = size * 1024;
+    usage  = 0;
+
+    /*  create the directory of the binary cache files  */
+    cacheDir =
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        "/fields";
+    QDir().mkpath(cacheDir);
+}
+
+/*  destructor: release the fields and remove the binary cache files  */
+Cache::~Cache() {
+    for (Entry* entry : entries) {
+        if (entry->field != nullptr) delete entry->field;
+        if (entry->isCached) QFile::remove(entry->cacheFile);
+        delete entry;
+    }
+    entries.clear();
+}
+
+/*  ============================================================================
+ *  getField: get the field of the result file, the field is loaded from the
+ *  result file or the binary cache file if it is not resident
+ *  @param  path: the path of the result file
+ *  @param  isViewed: the field becomes the current field, otherwise it is
+ *                    placed after the current one, e.g., the reference of
+ *                    the differencing
+ *  @return  the field of the result file, nullptr if it is unreadable  */
+Field* Cache::getField(const QString& path, const bool isViewed) {
+    /*  modification time of the result file  */
+    qint64 stamp = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+
+    /*  the new or modified result file is read first, so the resident field
+     *  is kept if the file cannot be read  */
+    Entry* entry = findEntry(path);
+    Field* field = nullptr;
+    if (entry == nullptr || entry->stamp != stamp) {
+        QString file = path;
+        field        = new Field(file);
+        if (!field->isFieldRead()) {
+            delete field;
+            return nullptr;
+        }
+    }
+
+    /*  drop the entry if the result file has been modified  */
+    if (entry != nullptr && entry->stamp != stamp) {
+        if (entry->field != nullptr) {
+            usage -= entry->size;
+            delete entry->field;
+        }
+        if (entry->isCached) QFile::remove(entry->cacheFile);
+        entries.removeOne(entry);
+        delete entry;
+        entry = nullptr;
+    }
+
+    /*  create the entry and load the field from the result file  */
+    if (entry == nullptr) {
+        entry        = new Entry;
+        entry->path  = path;
+        entry->stamp = stamp;
+        //  the binary cache file is named by the hash of the path and time
+        QByteArray key = (path + QString::number(stamp)).toUtf8();
+        entry->cacheFile =
+            cacheDir + "/" +
+            QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex() +
+            ".vtu";
+        entry->isCached = false;
+        entry->field    = field;
+        entry->meta     = entry->field->getMeta();
+        entry->size     = 0;
+        entries.insert(isViewed || entries.isEmpty() ? 0 : 1, entry);
+
+    } else {
+        /*  reload the released field from the binary cache file  */
+        if (entry->field == nullptr) {
+            if (entry->isCached) {
+                entry->field =
+                    new Field(entry->path, entry->cacheFile, entry->meta);
+            } else {
+                entry->field = new Field(entry->path);
+            }
+            //  the file or its cache cannot be read any more
+            if (!entry->field->isFieldRead()) {
+                delete entry->field;
+                if (entry->isCached) QFile::remove(entry->cacheFile);
+                entries.removeOne(entry);
+                delete entry;
+                return nullptr;
+            }
+            entry->size = 0;
+        }
+        //  move the entry to the most recently viewed
+        int pos = entries.indexOf(entry);
+        if (isViewed || pos == 0) {
+            entries.move(pos, 0);
+        } else {
+            entries.move(pos, 1);
+        }
+    }
+
+    /*  update the memory usage, the size may be changed by the mirror and
+     *  picking operations since it is measured  */
+    usage -= entry->size;
+    entry->size = entry->field->getMemorySize();
+    usage += entry->size;
+
+    /*  release the least recently viewed fields  */
+    evict(entry->field);
+    return entry->field;
+}
+
+/*  getMeta: get the resident meta data of the result file
+ *  @param  path: the path of the result file
+ *  @return  the meta data, nullptr if the result is never loaded  */
+const Field::Meta* Cache::getMeta(const QString& path) {
+    Entry* entry = findEntry(path);
+    if (entry == nullptr) return nullptr;
+    return &entry->meta;
+}
+
+/*  updateMeta: update the resident meta data of the field after the derived
+ *  arrays are added, the outdated binary cache file is removed so the arrays
+ *  are kept in the next one
+ *  @param  field: the resident field  */
+void Cache::updateMeta(Field* field) {
+    for (Entry* entry : entries) {
+        if (entry->field != field) continue;
+        entry->meta = field->getMeta();
+        if (entry->isCached) QFile::remove(entry->cacheFile);
+        entry->isCached = false;
+        return;
+    }
+}
+
+/*  setBudget: set the memory budget of the cache, the resident fields are
+ *  released immediately if the budget is exceeded
+ *  @param  size: the memory budget in mebibytes  */
+void Cache::setBudget(const qint64 size) {
+    budget = size * 1024;
+    evict(getCurrentField());
+}
+
+/*  getCurrentField: get the most recently viewed field
+ *  @return  the current field, nullptr if nothing is loaded  */
+Field* Cache::getCurrentField() {
+    if (entries.isEmpty()) return nullptr;
+    return entries.first()->field;
+}
+
+/*  ============================================================================
+ *  findEntry: find the entry of the result file
+ *  @param  path: the path of the result file
+ *  @return  the entry, nullptr if it is not found  */
+Cache::Entry* Cache::findEntry(const QString& path) {
+    for (Entry* entry : entries) {
+        if (entry->path == path) return entry;
+    }
+    return nullptr;
+}
+
+/*  evict: release the least recently viewed fields until the memory usage is
+ *  within the budget, the current field is always kept
+ *  @param  keep: the field that is requested  */
+void Cache::evict(Field* keep) {
+    /*  loop from the least recently viewed entry, the first entry is the
+     *  current field  */
+    for (int i = entries.size() - 1; i > 0 && usage > budget; --i) {
+        Entry* entry = entries[i];
+        if (entry->field == nullptr || entry->field == keep) continue;
+
+        /*  write the binary cache file for a fast reloading  */
+        if (!entry->isCached) {
+            entry->isCached = entry->field->saveCache(entry->cacheFile);
+            if (!entry->isCached) {
+                qDebug() << "Failed to write the cache file of" << entry->path;
+            }
+        }
+
+        /*  release the field  */
+        delete entry->field;
+        entry->field = nullptr;
+        usage -= entry->size;
+        entry->size = 0;
+    }
+}
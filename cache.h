@@ -0,0 +1,103 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : cache.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <QList>
+#include <QString>
+
+#include "field.h"
+
+/*  ############################################################################
+ *  class Cache: the result cache of the loaded fields with a memory budget. The
+ *      least recently viewed fields are released once the budget is exceeded,
+ *      while their meta data are kept resident. The released fields are
+ *      written to the binary cache files and reloaded transparently.  */
+class Cache {
+private:
+    class Entry;             // entry of the cached field
+    QList<Entry*> entries;   // entries, the most recently viewed at first
+    qint64 budget;           // memory budget in kibibytes
+    qint64 usage;            // memory used by the resident fields
+    QString cacheDir;        // directory of the binary cache files
+
+public:
+    /*  ########################################################################
+     *  constructor: create the result cache with the memory budget
+     *  @param  size: the memory budget in mebibytes  */
+    Cache(const qint64 size);
+
+    /*  destructor: release the fields and remove the binary cache files  */
+    ~Cache();
+
+    /*  getField: get the field of the result file, the field is loaded from
+     *  the result file or the binary cache file if it is not resident
+     *  @param  path: the path of the result file
+     *  @param  isViewed: the field becomes the current field, otherwise it
+     *                    is placed after the current one, e.g., the reference
+     *                    of the differencing
+     *  @return  the field of the result file, nullptr if it is unreadable  */
+    Field* getField(const QString& path, const bool isViewed = true);
+
+    /*  getMeta: get the resident meta data of the result file
+     *  @param  path: the path of the result file
+     *  @return  the meta data, nullptr if the result is never loaded  */
+    const Field::Meta* getMeta(const QString& path);
+
+    /*  updateMeta: update the resident meta data of the field after the
+     *  derived arrays are added, the outdated binary cache file is removed
+     *  so the arrays are kept in the next one
+     *  @param  field: the resident field  */
+    void updateMeta(Field* field);
+
+    /*  setBudget: set the memory budget of the cache, the resident fields
+     *  are released immediately if the budget is exceeded
+     *  @param  size: the memory budget in mebibytes  */
+    void setBudget(const qint64 size);
+
+    /*  getUsage: get the memory used by the resident fields
+     *  @return  the memory usage in kibibytes  */
+    qint64 getUsage() { return usage; }
+
+    /*  getCurrentField: get the most recently viewed field
+     *  @return  the current field, nullptr if nothing is loaded  */
+    Field* getCurrentField();
+
+private:
+    /*  findEntry: find the entry of the result file
+     *  @param  path: the path of the result file
+     *  @return  the entry, nullptr if it is not found  */
+    Entry* findEntry(const QString& path);
+
+    /*  evict: release the least recently viewed fields until the memory usage
+     *  is within the budget, the current field is always kept
+     *  @param  keep: the field that is requested  */
+    void evict(Field* keep);
+};
+
+/*  ############################################################################
+ *  class Cache::Entry: the entry of the cached field  */
+class Cache::Entry {
+public:
+    QString path;       // path of the result file
+    qint64 stamp;       // modification time of the result file
+    QString cacheFile;  // path of the binary cache file
+    bool isCached;      // whether the binary cache file is written
+    Field* field;       // resident field, nullptr if released
+    Field::Meta meta;   // resident meta data
+    qint64 size;        // memory size of the field in kibibytes
+};
+#endif  // CACHE_H
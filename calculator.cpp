@@ -0,0 +1,224 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : calculator.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "calculator.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkCellArray.h>
+#include <vtkDataArrayRange.h>
+#include <vtkIdList.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+
+#include "ui_calculator.h"
+
+/*  ############################################################################
+ *  CellAverageWorker: the parallel average of the nodal values over the
+ *  nodes of each cell, all the components are averaged  */
+struct CellAverageWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, vtkUnstructuredGrid* ugrid,
+                    vtkDoubleArray* output) {
+        vtkSMPThreadLocalObject<vtkIdList> ids;
+        vtkCellArray* connect = ugrid->GetCells();
+        const auto tuples     = vtk::DataArrayTupleRange(array);
+        const int numComps    = array->GetNumberOfComponents();
+        double* values        = output->GetPointer(0);
+
+        /*  average the blocks  */
+        vtkSMPTools::For(
+            0, ugrid->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+                vtkIdList* list = ids.Local();
+                for (vtkIdType i = begin; i < end; ++i) {
+                    vtkIdType npts;
+                    const vtkIdType* pts;
+                    connect->GetCellAtId(i, npts, pts, list);
+                    double* v = values + i * numComps;
+                    std::fill(v, v + numComps, 0.0);
+                    for (vtkIdType k = 0; k < npts; ++k) {
+                        const auto tuple = tuples[pts[k]];
+                        for (int c = 0; c < numComps; ++c) v[c] += tuple[c];
+                    }
+                    for (int c = 0; c < numComps; ++c) {
+                        v[c] /= std::max<vtkIdType>(npts, 1);
+                    }
+                }
+            });
+    }
+};
+
+/*  ############################################################################
+ *  constructor: create the Calculator object  */
+Calculator::Calculator(QWidget* parent)
+    : QDialog(parent), ui(new Ui::Calculator) {
+    /*  setup the UI interface  */
+    ui->setupUi(this);
+    field       = nullptr;
+    resultIndex = -1;
+    ui->functionList->addItems(Expression::getFunctionNames());
+
+    /*  connect to the buttons  */
+    connect(ui->btnCancel, &QPushButton::clicked, this, &QDialog::close);
+    connect(ui->btnOk, &QPushButton::clicked, this, &Calculator::evaluate);
+
+    /*  insert the variables and functions into the expression  */
+    connect(ui->variableList, &QListWidget::itemDoubleClicked, this,
+            [&](QListWidgetItem* item) {
+                ui->expression->insert(item->text());
+                ui->expression->setFocus();
+            });
+    connect(ui->functionList, &QListWidget::itemDoubleClicked, this,
+            [&](QListWidgetItem* item) {
+                QString text = item->text();
+                ui->expression->insert(text.left(text.indexOf('(') + 1));
+                ui->expression->setFocus();
+            });
+
+    /*  check the expression while it is edited  */
+    connect(ui->expression, &QLineEdit::textChanged, this, &Calculator::check);
+}
+
+/*  destructor: destroy the Calculator object  */
+Calculator::~Calculator() { delete ui; }
+
+/*  ============================================================================
+ *  setInputData: list the variables of the field
+ *  @param  input: the field variables  */
+void Calculator::setInputData(Field* input) {
+    /*  reset the variables  */
+    field = input;
+    names.clear();
+    fieldIds.clear();
+    compIds.clear();
+    ui->variableList->clear();
+    if (field == nullptr) return;
+
+    /*  the nodal fields are listed by the components  */
+    QStringList& fieldNames = field->getFieldNameList();
+    QStringList& compNames  = field->getCompNameList();
+    for (int i = 0; i < fieldNames.size(); ++i) {
+        if (i < field->getNumberOfPointData()) {
+            for (int j = 0; j < compNames.size(); ++j) {
+                names << fieldNames[i] + ":" + compNames[j];
+                fieldIds << i;
+                compIds << j;
+            }
+        } else {
+            names << fieldNames[i];
+            fieldIds << i;
+            compIds << 0;
+        }
+    }
+    ui->variableList->addItems(names);
+    check();
+}
+
+/*  ============================================================================
+ *  check: compile the expression and show the status  */
+void Calculator::check() {
+    Expression expr(ui->expression->text(), names);
+    if (!expr.isValid()) {
+        ui->status->setText(expr.getError());
+        return;
+    }
+
+    /*  determine the type of the result  */
+    bool isPoint = true;
+    for (const Expression::Variable& var : expr.getVariables()) {
+        int idx = fieldIds[names.indexOf(var.name)];
+        if (idx >= field->getNumberOfPointData()) isPoint = false;
+    }
+    ui->status->setText(isPoint ? "Nodal field" : "Element field");
+}
+
+/*  evaluate: evaluate the expression and add the derived field, the dialog is
+ *  accepted if it is successful  */
+void Calculator::evaluate() {
+    /*  check the name and the expression  */
+    QString label = ui->resultName->text().trimmed();
+    if (field == nullptr) return;
+    if (label.isEmpty() || label.contains(':')) {
+        ui->status->setText("The name should be non-empty without ':'");
+        return;
+    }
+    Expression expr(ui->expression->text(), names);
+    if (!expr.isValid()) {
+        ui->status->setText(expr.getError());
+        return;
+    }
+
+    /*  get the arrays of the variables  */
+    QList<Expression::Variable>& vars = expr.getVariables();
+    QVector<vtkDataArray*> arrays;
+    bool isPoint = true;
+    for (const Expression::Variable& var : vars) {
+        int pos = names.indexOf(var.name);
+        vtkDataArray* array = field->getFieldArray(fieldIds[pos], compIds[pos]);
+        if (array == nullptr || var.comp >= array->GetNumberOfComponents()) {
+            ui->status->setText("Invalid variable " + var.name);
+            return;
+        }
+        if (fieldIds[pos] >= field->getNumberOfPointData()) isPoint = false;
+        arrays << array;
+    }
+
+    /*  the inputs should be contiguous doubles on the result domain  */
+    vtkUnstructuredGrid* ugrid = field->getInputData();
+    QVector<Expression::Input> inputs;
+    QVector<vtkDoubleArray*> temps;
+    for (int i = 0; i < vars.size(); ++i) {
+        int pos               = names.indexOf(vars[i].name);
+        vtkDoubleArray* data  = vtkDoubleArray::FastDownCast(arrays[i]);
+        bool isPointVariable  = fieldIds[pos] < field->getNumberOfPointData();
+        if (!isPoint && isPointVariable) {
+            //  average the nodal values over the cells
+            data = vtkDoubleArray::New();
+            data->SetNumberOfComponents(arrays[i]->GetNumberOfComponents());
+            data->SetNumberOfTuples(ugrid->GetNumberOfCells());
+            CellAverageWorker worker;
+            if (!vtkArrayDispatch::Dispatch::Execute(arrays[i], worker, ugrid,
+                                                     data)) {
+                worker(arrays[i], ugrid, data);
+            }
+            temps << data;
+        } else if (data == nullptr) {
+            //  convert to the doubles
+            data = vtkDoubleArray::New();
+            data->DeepCopy(arrays[i]);
+            temps << data;
+        }
+        inputs.append(
+            {data->GetPointer(0), data->GetNumberOfComponents(), vars[i].comp});
+    }
+
+    /*  evaluate the expression  */
+    vtkIdType numTuples =
+        isPoint ? ugrid->GetNumberOfPoints() : ugrid->GetNumberOfCells();
+    vtkDoubleArray* result = vtkDoubleArray::New();
+    result->SetNumberOfTuples(numTuples);
+    expr.evaluate(inputs, numTuples, result->GetPointer(0));
+    for (vtkDoubleArray* temp : temps) temp->Delete();
+
+    /*  add the derived field  */
+    resultIndex = field->addDerivedField(label, result, isPoint);
+    result->Delete();
+    if (resultIndex < 0) {
+        ui->status->setText("The name is used by the original field");
+        return;
+    }
+    accept();
+}
@@ -0,0 +1,69 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : calculator.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef CALCULATOR_H
+#define CALCULATOR_H
+
+#include <QDialog>
+
+#include "expression.h"
+#include "field.h"
+
+namespace Ui {
+class Calculator;
+}
+
+/*  ############################################################################
+ *  class Calculator: the dialog to derive the new field from the expression
+ *      of the field variables. The result is an element field if any element
+ *      field is referenced, the nodal fields are then averaged over the nodes
+ *      of each cell; otherwise the result is a nodal field.  */
+class Calculator : public QDialog {
+    Q_OBJECT
+
+private:
+    Ui::Calculator* ui;       // UI interface
+    Field* field;             // field variables
+    QStringList names;        // names of the available variables
+    QVector<int> fieldIds;    // field index of each variable
+    QVector<int> compIds;     // component of each variable
+    int resultIndex;          // index of the derived field
+
+public:
+    /*  ########################################################################
+     *  constructor: create the Calculator object  */
+    explicit Calculator(QWidget* parent = nullptr);
+
+    /*  destructor: destroy the Calculator object  */
+    ~Calculator();
+
+    /*  setInputData: list the variables of the field
+     *  @param  input: the field variables  */
+    void setInputData(Field* input);
+
+    /*  getResultIndex: get the index of the derived field in the name list
+     *  @return  the index of the derived field  */
+    int getResultIndex() { return resultIndex; }
+
+private slots:
+    /*  ########################################################################
+     *  check: compile the expression and show the status  */
+    void check();
+
+    /*  evaluate: evaluate the expression and add the derived field, the
+     *  dialog is accepted if it is successful  */
+    void evaluate();
+};
+#endif  // CALCULATOR_H
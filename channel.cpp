@@ -0,0 +1,88 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : channel.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "channel.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <algorithm>
+
+#include "prenano.h"
+
+/*  ############################################################################
+ *  send: write the frame to the socket
+ *  @param  socket: the connected socket
+ *  @param  type: the type of the frame
+ *  @param  payload: the payload of the frame  */
+void Channel::send(QTcpSocket* socket, const quint8 type,
+                   const QByteArray& payload) {
+    //  the length counts the type and the payload
+    char header[5];
+    qToBigEndian<quint32>(quint32(payload.size() + 1), header);
+    header[4] = char(type);
+    socket->write(header, sizeof(header));
+    socket->write(payload);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  receive: read the next complete frame from the socket, the socket is
+ *  aborted if the frame is larger than REMOTE_MAX_FRAME
+ *  @param  socket: the connected socket
+ *  @param  type: the type of the frame
+ *  @param  payload: the payload of the frame
+ *  @return  false if no complete frame is received  */
+bool Channel::receive(QTcpSocket* socket, quint8& type, QByteArray& payload) {
+    //  the frame is read only after it is complete
+    char header[5];
+    if (socket->peek(header, sizeof(header)) < qint64(sizeof(header))) {
+        return false;
+    }
+    quint32 length = qFromBigEndian<quint32>(header);
+    if (length < 1 || length > quint32(PRENANO::REMOTE_MAX_FRAME)) {
+        socket->abort();
+        return false;
+    }
+    if (socket->bytesAvailable() < qint64(sizeof(header) - 1 + length)) {
+        return false;
+    }
+    socket->read(header, sizeof(header));
+    type    = quint8(header[4]);
+    payload = socket->read(length - 1);
+    return true;
+}
+
+/*  ============================================================================
+ *  digest: get the answer of the challenge
+ *  @param  nonce: the challenge of the server
+ *  @param  password: the password of the user
+ *  @return  the SHA-256 of the challenge and the password  */
+QByteArray Channel::digest(const QByteArray& nonce, const QString& password) {
+    return QCryptographicHash::hash(nonce + password.toUtf8(),
+                                    QCryptographicHash::Sha256);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  hashTail: get the hash of the bytes before the offset, at most
+ *  REMOTE_CHECK_SIZE bytes are hashed
+ *  @param  file: the opened file
+ *  @param  offset: the end of the hashed bytes
+ *  @return  the SHA-256 of the bytes, empty if they can not be read  */
+QByteArray Channel::hashTail(QIODevice* file, const qint64 offset) {
+    qint64 start = std::max<qint64>(offset - PRENANO::REMOTE_CHECK_SIZE, 0);
+    if (offset <= 0 || !file->seek(start)) return QByteArray();
+    QByteArray tail = file->read(offset - start);
+    if (tail.size() != offset - start) return QByteArray();
+    return QCryptographicHash::hash(tail, QCryptographicHash::Sha256);
+}
@@ -0,0 +1,91 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : channel.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QTcpSocket>
+
+/*  ############################################################################
+ *  class Channel: the framed messages between the result server and the GUI.
+ *      Each frame is the 32-bit length of the rest, the 8-bit type and the
+ *      payload written by QDataStream. The session starts with the challenge
+ *      of the server, which is answered by the user name and the SHA-256 of
+ *      the challenge and the password, so the password is never sent. The
+ *      files are streamed in the compressed chunks, and the resumed transfer
+ *      gives the offset of the local copy and the hash of its tail, so only
+ *      the missing or appended bytes are sent if the tail is unchanged.
+ *
+ *      CHALLENGE  server: nonce
+ *      HELLO      client: user, digest
+ *      WELCOME    server: name of the root
+ *      FAILURE    server: message
+ *      LIST       client: directory
+ *      LISTING    server: directory, number, {name, isDir, size, modified}
+ *      READ       client: path, offset, hash of the tail before the offset
+ *      DATA       server: offset, compressed bytes
+ *      END        server: size, modified
+ *      EXTRACT    client: request of Surface
+ *      SURFACE    server: path, size of the file, surface of Surface  */
+class Channel {
+public:
+    /*  the types of the frames  */
+    enum : quint8 {
+        CHALLENGE = 1,
+        HELLO,
+        WELCOME,
+        FAILURE,
+        LIST,
+        LISTING,
+        READ,
+        DATA,
+        END,
+        EXTRACT,
+        SURFACE
+    };
+
+public:
+    /*  ########################################################################
+     *  send: write the frame to the socket
+     *  @param  socket: the connected socket
+     *  @param  type: the type of the frame
+     *  @param  payload: the payload of the frame  */
+    static void send(QTcpSocket* socket, const quint8 type,
+                     const QByteArray& payload);
+
+    /*  receive: read the next complete frame from the socket, the socket is
+     *  aborted if the frame is larger than REMOTE_MAX_FRAME
+     *  @param  socket: the connected socket
+     *  @param  type: the type of the frame
+     *  @param  payload: the payload of the frame
+     *  @return  false if no complete frame is received  */
+    static bool receive(QTcpSocket* socket, quint8& type, QByteArray& payload);
+
+    /*  digest: get the answer of the challenge
+     *  @param  nonce: the challenge of the server
+     *  @param  password: the password of the user
+     *  @return  the SHA-256 of the challenge and the password  */
+    static QByteArray digest(const QByteArray& nonce, const QString& password);
+
+    /*  hashTail: get the hash of the bytes before the offset, at most
+     *  REMOTE_CHECK_SIZE bytes are hashed
+     *  @param  file: the opened file
+     *  @param  offset: the end of the hashed bytes
+     *  @return  the SHA-256 of the bytes, empty if they can not be read  */
+    static QByteArray hashTail(QIODevice* file, const qint64 offset);
+};
+#endif  // CHANNEL_H
@@ -0,0 +1,376 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : database.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "database.h"
+
+#include <QDebug>
+#include <QStringList>
+
+/*  migrations of the project file, the statements of the i-th step bring the
+ *  file of version i to version i + 1, and the files without version are
+ *  those of the key-value project table  */
+static const QList<QStringList> MIGRATIONS = {
+    //  1: the project table keyed by the key, and the entities keyed by the
+    //  row ids
+    {"CREATE TABLE IF NOT EXISTS project ("
+     "id INTEGER PRIMARY KEY, "
+     "key TEXT, "
+     "value TEXT)",
+     "ALTER TABLE project RENAME TO project_v0",
+     "CREATE TABLE project ("
+     "key TEXT PRIMARY KEY, "
+     "value TEXT)",
+     "INSERT OR REPLACE INTO project (key, value) "
+     "SELECT key, value FROM project_v0",
+     "DROP TABLE project_v0",
+     "CREATE TABLE models ("
+     "id INTEGER PRIMARY KEY, "
+     "name TEXT NOT NULL UNIQUE, "
+     "type INTEGER, "
+     "source TEXT, "
+     "source_type INTEGER, "
+     "create_type INTEGER)",
+     "CREATE TABLE sets ("
+     "id INTEGER PRIMARY KEY, "
+     "model_id INTEGER NOT NULL REFERENCES models(id) ON DELETE CASCADE, "
+     "name TEXT NOT NULL, "
+     "type INTEGER, "
+     "source TEXT, "
+     "create_type INTEGER, "
+     "data BLOB, "
+     "UNIQUE(model_id, name))",
+     "CREATE TABLE materials ("
+     "id INTEGER PRIMARY KEY, "
+     "name TEXT NOT NULL UNIQUE, "
+     "description TEXT, "
+     "density REAL, density_flag INTEGER, "
+     "linear_modulus REAL, linear_poisson REAL, linear_flag INTEGER, "
+     "neo_modulus REAL, neo_poisson REAL, neo_flag INTEGER, "
+     "expansion REAL, expansion_flag INTEGER, "
+     "conduction REAL, conduction_flag INTEGER)",
+     "CREATE INDEX sets_model ON sets(model_id)"},
+    //  2: the entities keyed by the unique ids, so that the changed ones are
+    //  written by the autosave, the row ids become the unique ids
+    {"ALTER TABLE sets RENAME TO sets_v1",
+     "ALTER TABLE models RENAME TO models_v1",
+     "ALTER TABLE materials RENAME TO materials_v1",
+     "DROP INDEX sets_model",
+     "CREATE TABLE models ("
+     "uid TEXT PRIMARY KEY, "
+     "name TEXT NOT NULL, "
+     "type INTEGER, "
+     "source TEXT, "
+     "source_type INTEGER, "
+     "create_type INTEGER)",
+     "CREATE TABLE sets ("
+     "uid TEXT PRIMARY KEY, "
+     "model_uid TEXT NOT NULL REFERENCES models(uid) ON DELETE CASCADE, "
+     "name TEXT NOT NULL, "
+     "type INTEGER, "
+     "source TEXT, "
+     "create_type INTEGER, "
+     "data BLOB)",
+     "CREATE TABLE materials ("
+     "uid TEXT PRIMARY KEY, "
+     "name TEXT NOT NULL, "
+     "description TEXT, "
+     "density REAL, density_flag INTEGER, "
+     "linear_modulus REAL, linear_poisson REAL, linear_flag INTEGER, "
+     "neo_modulus REAL, neo_poisson REAL, neo_flag INTEGER, "
+     "expansion REAL, expansion_flag INTEGER, "
+     "conduction REAL, conduction_flag INTEGER)",
+     "INSERT INTO models SELECT 'model-' || id, name, type, source, "
+     "source_type, create_type FROM models_v1",
+     "INSERT INTO sets SELECT 'set-' || id, 'model-' || model_id, name, type, "
+     "source, create_type, data FROM sets_v1",
+     "INSERT INTO materials SELECT 'material-' || id, name, description, "
+     "density, density_flag, linear_modulus, linear_poisson, linear_flag, "
+     "neo_modulus, neo_poisson, neo_flag, expansion, expansion_flag, "
+     "conduction, conduction_flag FROM materials_v1",
+     "DROP TABLE sets_v1",
+     "DROP TABLE models_v1",
+     "DROP TABLE materials_v1",
+     "CREATE INDEX sets_model ON sets(model_uid)"},
+    //  3: the jobs of the scheduler
+    {"CREATE TABLE jobs ("
+     "uid TEXT PRIMARY KEY, "
+     "name TEXT NOT NULL, "
+     "work_dir TEXT, "
+     "arguments TEXT, "
+     "priority INTEGER, "
+     "cores INTEGER, "
+     "state INTEGER, "
+     "sequence INTEGER, "
+     "submitted INTEGER, started INTEGER, ended INTEGER, "
+     "cpu_time REAL, peak_memory INTEGER, exit_code INTEGER)"},
+    //  4: the runs of the parameter sweep and their final states
+    {"CREATE TABLE runs ("
+     "hash TEXT PRIMARY KEY, "
+     "job_uid TEXT, "
+     "directory TEXT, "
+     "parameters TEXT, "
+     "created INTEGER, "
+     "state INTEGER)"}};
+
+/*  ############################################################################
+ *  constructor: create the connection of the project database, each thread
+ *  uses its own connection
+ *  @param  name: the name of the connection  */
+Database::Database(const QString& name)
+    : connection(name), migrations(MIGRATIONS) {
+    db = QSqlDatabase::addDatabase("QSQLITE", connection);
+}
+
+/*  constructor: create the connection of another file, which has its own
+ *  versions
+ *  @param  name: the name of the connection
+ *  @param  steps: the statements bringing the file of version i to version
+ *         i + 1  */
+Database::Database(const QString& name, const QList<QStringList>& steps)
+    : connection(name), migrations(steps) {
+    db = QSqlDatabase::addDatabase("QSQLITE", connection);
+}
+
+/*  destructor: release the statements and close the connection  */
+Database::~Database() {
+    close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connection);
+}
+
+/*  ============================================================================
+ *  open: open the project file in the WAL mode and create the schema, the
+ *  previous file is closed if another file is given
+ *  @param  file: the path of the project file
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::open(const QString& file) {
+    /*  reuse the opened file  */
+    if (db.isOpen() && db.databaseName() == file) return true;
+    close();
+
+    /*  open the file  */
+    db.setConnectOptions();
+    db.setDatabaseName(file);
+    if (!db.open()) {
+        error = db.lastError().text();
+        qDebug() << "Failed to open the database" << error;
+        return false;
+    }
+
+    /*  the readers never block the writer, and the WAL is only synchronized
+     *  at the checkpoints  */
+    QSqlQuery pragma(db);
+    pragma.exec("PRAGMA journal_mode=WAL");
+    pragma.exec("PRAGMA synchronous=NORMAL");
+    pragma.exec("PRAGMA foreign_keys=ON");
+    pragma.finish();
+
+    /*  create the tables  */
+    if (!createSchema()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/*  openReadOnly: open the file as it is, without the WAL, the pragmas and the
+ *  migrations, e.g., the project file imported from
+ *  @param  file: the path of the file
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::openReadOnly(const QString& file) {
+    close();
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    db.setDatabaseName(file);
+    if (!db.open()) {
+        error = db.lastError().text();
+        qDebug() << "Failed to open the database" << error;
+        return false;
+    }
+    return true;
+}
+
+/*  getVersion: get the schema version of the opened file
+ *  @return  the version, 0 for the files without version  */
+int Database::getVersion() {
+    QSqlQuery* query = select("PRAGMA user_version");
+    int version = query != nullptr && query->next() ? query->value(0).toInt()
+                                                    : 0;
+    if (query != nullptr) query->finish();
+    return version;
+}
+
+/*  getProjectVersion: get the current version of the project files
+ *  @return  the version written by the migrations  */
+int Database::getProjectVersion() { return int(MIGRATIONS.size()); }
+
+/*  close: release the statements and close the project file  */
+void Database::close() {
+    qDeleteAll(queries);
+    queries.clear();
+    if (db.isOpen()) db.close();
+}
+
+/*  ############################################################################
+ *  begin: begin the transaction
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::begin() {
+    if (db.transaction()) return true;
+    error = db.lastError().text();
+    return false;
+}
+
+/*  commit: commit the transaction
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::commit() {
+    if (db.commit()) return true;
+    error = db.lastError().text();
+    db.rollback();
+    return false;
+}
+
+/*  rollback: discard the transaction  */
+void Database::rollback() { db.rollback(); }
+
+/*  ============================================================================
+ *  exec: execute the statement, which is prepared once and reused
+ *  @param  sql: the SQL statement with the positional placeholders
+ *  @param  values: the values bound to the placeholders
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::exec(const QString& sql, const QVariantList& values) {
+    QSqlQuery* query = select(sql, values);
+    if (query == nullptr) return false;
+    query->finish();
+    return true;
+}
+
+/*  select: execute the query, which is prepared once and reused
+ *  @param  sql: the SQL query with the positional placeholders
+ *  @param  values: the values bound to the placeholders
+ *  @return  the query positioned before the first row, nullptr if failed. It
+ *           is valid until the same query is executed again  */
+QSqlQuery* Database::select(const QString& sql, const QVariantList& values) {
+    /*  get the prepared statement  */
+    QSqlQuery* query = prepare(sql);
+    if (query == nullptr) return nullptr;
+
+    /*  bind the values and execute  */
+    for (qsizetype i = 0; i < values.size(); ++i) {
+        query->bindValue(int(i), values[i]);
+    }
+    if (!query->exec()) {
+        error = query->lastError().text();
+        qDebug() << "Failed to execute" << sql << error;
+        return nullptr;
+    }
+    return query;
+}
+
+/*  query: execute the query without caching it, the query is owned by the
+ *  caller, e.g., the model fetching the rows lazily
+ *  @param  sql: the SQL query with the positional placeholders
+ *  @param  values: the values bound to the placeholders
+ *  @return  the query positioned before the first row, inactive if failed  */
+QSqlQuery Database::query(const QString& sql, const QVariantList& values) {
+    QSqlQuery query(db);
+    if (query.prepare(sql)) {
+        for (qsizetype i = 0; i < values.size(); ++i) {
+            query.bindValue(int(i), values[i]);
+        }
+        if (query.exec()) return query;
+    }
+    error = query.lastError().text();
+    qDebug() << "Failed to execute" << sql << error;
+    return QSqlQuery();
+}
+
+/*  getLastInsertId: get the row id of the last inserted row
+ *  @param  sql: the SQL statement of the insertion
+ *  @return  the row id, -1 if unknown  */
+qint64 Database::getLastInsertId(const QString& sql) {
+    QSqlQuery* query = queries.value(sql, nullptr);
+    if (query == nullptr) return -1;
+    QVariant id = query->lastInsertId();
+    return id.isValid() ? id.toLongLong() : -1;
+}
+
+/*  hasTable: check whether the table exists
+ *  @param  name: the name of the table
+ *  @return  true if the table exists  */
+bool Database::hasTable(const QString& name) {
+    QSqlQuery* query = select(
+        "SELECT COUNT(*) FROM sqlite_master WHERE type='table' AND name=?",
+        {name});
+    bool isExist = query != nullptr && query->next() && query->value(0).toInt();
+    if (query != nullptr) query->finish();
+    return isExist;
+}
+
+/*  ############################################################################
+ *  createSchema: bring the file to the current version by the migrations in
+ *  one transaction, the files of the later versions are refused
+ *  @return  the status, true for success, otherwise failed  */
+bool Database::createSchema() {
+    /*  version of the file  */
+    QSqlQuery query(db);
+    query.exec("PRAGMA user_version");
+    int version = query.next() ? query.value(0).toInt() : 0;
+    query.finish();
+    if (version == migrations.size()) return true;
+    if (version > migrations.size()) {
+        error = QString("The file of version %1 is newer than version %2.")
+                    .arg(version)
+                    .arg(migrations.size());
+        qDebug() << error;
+        return false;
+    }
+
+    /*  the steps from the version of the file  */
+    if (!begin()) return false;
+    for (qsizetype i = version; i < migrations.size(); ++i) {
+        for (const QString& sql : migrations[i]) {
+            if (!query.exec(sql)) {
+                error = query.lastError().text();
+                qDebug() << "Migration to version" << i + 1
+                         << "failed:" << error;
+                query.finish();
+                rollback();
+                return false;
+            }
+        }
+    }
+    query.exec(QString("PRAGMA user_version=%1").arg(migrations.size()));
+    query.finish();
+    return commit();
+}
+
+/*  prepare: get the cached statement, it is prepared for the first use
+ *  @param  sql: the SQL statement
+ *  @return  the prepared statement, nullptr if failed  */
+QSqlQuery* Database::prepare(const QString& sql) {
+    /*  reuse the prepared statement  */
+    QSqlQuery* query = queries.value(sql, nullptr);
+    if (query != nullptr) return query;
+
+    /*  prepare the statement for the first use  */
+    query = new QSqlQuery(db);
+    if (!query->prepare(sql)) {
+        error = query->lastError().text();
+        qDebug() << "Failed to prepare" << sql << error;
+        delete query;
+        return nullptr;
+    }
+    queries.insert(sql, query);
+    return query;
+}
@@ -0,0 +1,152 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : database.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+/*  ############################################################################
+ *  class Database: the single SQLite connection of the project file, which
+ *      stores the project, models, sets and materials. The file is opened in
+ *      the WAL mode, and the statements are prepared once and cached by their
+ *      SQL text, so that saving the project is one transaction with the
+ *      statements bound again for each row. Other files, e.g., the material
+ *      library, are opened with their own tables and versions.  */
+class Database {
+private:
+    QString connection;                   // name of the connection
+    QSqlDatabase db;                      // connection of the project file
+    QHash<QString, QSqlQuery*> queries;   // cached prepared statements
+    QList<QStringList> migrations;        // steps to the current version
+    QString error;                        // the last error
+
+public:
+    /*  ########################################################################
+     *  constructor: create the connection of the project database, each
+     *  thread uses its own connection
+     *  @param  name: the name of the connection  */
+    explicit Database(const QString& name = "PROJECT");
+
+    /*  constructor: create the connection of another file, which has its own
+     *  versions
+     *  @param  name: the name of the connection
+     *  @param  steps: the statements bringing the file of version i to
+     *         version i + 1  */
+    Database(const QString& name, const QList<QStringList>& steps);
+
+    /*  destructor: release the statements and close the connection  */
+    ~Database();
+
+    /*  open: open the project file in the WAL mode and create the schema, the
+     *  previous file is closed if another file is given
+     *  @param  file: the path of the project file
+     *  @return  the status, true for success, otherwise failed  */
+    bool open(const QString& file);
+
+    /*  openReadOnly: open the file as it is, without the WAL, the pragmas and
+     *  the migrations, e.g., the project file imported from
+     *  @param  file: the path of the file
+     *  @return  the status, true for success, otherwise failed  */
+    bool openReadOnly(const QString& file);
+
+    /*  getVersion: get the schema version of the opened file
+     *  @return  the version, 0 for the files without version  */
+    int getVersion();
+
+    /*  getProjectVersion: get the current version of the project files
+     *  @return  the version written by the migrations  */
+    static int getProjectVersion();
+
+    /*  close: release the statements and close the project file  */
+    void close();
+
+    /*  isOpen: check whether the project file is opened
+     *  @return  true if the project file is opened  */
+    bool isOpen() { return db.isOpen(); }
+
+    /*  getFileName: get the path of the opened project file
+     *  @return  the path of the project file  */
+    QString getFileName() { return db.databaseName(); }
+
+    /*  getError: get the last error of the database
+     *  @return  the error message  */
+    const QString& getError() { return error; }
+
+public:
+    /*  ########################################################################
+     *  begin: begin the transaction
+     *  @return  the status, true for success, otherwise failed  */
+    bool begin();
+
+    /*  commit: commit the transaction
+     *  @return  the status, true for success, otherwise failed  */
+    bool commit();
+
+    /*  rollback: discard the transaction  */
+    void rollback();
+
+    /*  exec: execute the statement, which is prepared once and reused
+     *  @param  sql: the SQL statement with the positional placeholders
+     *  @param  values: the values bound to the placeholders
+     *  @return  the status, true for success, otherwise failed  */
+    bool exec(const QString& sql, const QVariantList& values = {});
+
+    /*  select: execute the query, which is prepared once and reused
+     *  @param  sql: the SQL query with the positional placeholders
+     *  @param  values: the values bound to the placeholders
+     *  @return  the query positioned before the first row, nullptr if
+     *           failed. It is valid until the same query is executed again  */
+    QSqlQuery* select(const QString& sql, const QVariantList& values = {});
+
+    /*  query: execute the query without caching it, the query is owned by the
+     *  caller, e.g., the model fetching the rows lazily
+     *  @param  sql: the SQL query with the positional placeholders
+     *  @param  values: the values bound to the placeholders
+     *  @return  the query positioned before the first row, inactive if
+     *           failed  */
+    QSqlQuery query(const QString& sql, const QVariantList& values = {});
+
+    /*  getLastInsertId: get the row id of the last inserted row
+     *  @param  sql: the SQL statement of the insertion
+     *  @return  the row id, -1 if unknown  */
+    qint64 getLastInsertId(const QString& sql);
+
+    /*  hasTable: check whether the table exists
+     *  @param  name: the name of the table
+     *  @return  true if the table exists  */
+    bool hasTable(const QString& name);
+
+private:
+    /*  ########################################################################
+     *  createSchema: bring the file to the current version by the
+     *  migrations in one transaction, the files of the later versions are
+     *  refused
+     *  @return  the status, true for success, otherwise failed  */
+    bool createSchema();
+
+    /*  prepare: get the cached statement, it is prepared for the first use
+     *  @param  sql: the SQL statement
+     *  @return  the prepared statement, nullptr if failed  */
+    QSqlQuery* prepare(const QString& sql);
+};
+#endif  // DATABASE_H
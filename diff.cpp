@@ -0,0 +1,207 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : diff.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "diff.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkCellCenters.h>
+#include <vtkDataArrayRange.h>
+#include <vtkPolyData.h>
+#include <vtkProbeFilter.h>
+#include <vtkSMPTools.h>
+
+#include <cmath>
+
+/*  ############################################################################
+ *  SubtractWorker: the parallel subtraction of the arrays, the result is
+ *  written with the stride so that the components can be interleaved. The
+ *  contiguous loop of the typed values is vectorized by the compiler  */
+struct SubtractWorker {
+    template <typename ArrayA, typename ArrayB>
+    void operator()(ArrayA* a, ArrayB* b, double* out, const int stride) {
+        const int nc = a->GetNumberOfComponents();
+        vtkSMPTools::For(
+            0, a->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end) {
+                const auto va = vtk::DataArrayValueRange(a, begin * nc,
+                                                         end * nc);
+                const auto vb = vtk::DataArrayValueRange(b, begin * nc,
+                                                         end * nc);
+                double* o     = out + begin * stride;
+                vtkIdType num = end - begin;
+                if (nc == stride) {
+                    for (vtkIdType i = 0; i < num * nc; ++i) {
+                        o[i] = double(va[i]) - double(vb[i]);
+                    }
+                } else {
+                    for (vtkIdType i = 0; i < num; ++i) {
+                        for (int c = 0; c < nc; ++c) {
+                            o[i * stride + c] = double(va[i * nc + c]) -
+                                                double(vb[i * nc + c]);
+                        }
+                    }
+                }
+            });
+    }
+};
+
+/*  ############################################################################
+ *  constructor: compare the topology of the field and the reference
+ *  @param  field: the field to be compared
+ *  @param  reference: the reference field  */
+Diff::Diff(Field* _field, Field* _reference) {
+    field     = _field;
+    reference = _reference;
+    isMatched = field->getTopologyHash() == reference->getTopologyHash();
+}
+
+/*  ============================================================================
+ *  compute: subtract the reference from the field and add the difference as
+ *  the derived field
+ *  @param  idx: the index of the field in the name list
+ *  @return  the index of the difference, -1 if failed  */
+int Diff::compute(const int idx) {
+    /*  find the field in the reference  */
+    error.clear();
+    if (idx < 0 || idx >= field->getFieldNameList().size()) {
+        error = "No field is selected";
+        return -1;
+    }
+    QString label = field->getFieldNameList()[idx];
+    bool isPoint  = idx < field->getNumberOfPointData();
+    int refIdx    = reference->getFieldNameList().indexOf(label);
+    if (refIdx < 0 || (refIdx < reference->getNumberOfPointData()) != isPoint) {
+        error = "The field " + label + " is not found in the reference";
+        return -1;
+    }
+
+    /*  the nodal field is compared by the components, the magnitude is
+     *  computed again from the difference  */
+    QVector<vtkDataArray*> arrays, refArrays;
+    for (int c = 0; c < (isPoint ? 3 : 1); ++c) {
+        arrays << field->getFieldArray(idx, c);
+        refArrays << reference->getFieldArray(refIdx, c);
+        if (arrays.last() == nullptr || refArrays.last() == nullptr ||
+            arrays.last()->GetNumberOfComponents() !=
+                refArrays.last()->GetNumberOfComponents()) {
+            error = "The arrays of " + label + " are not compatible";
+            return -1;
+        }
+    }
+
+    /*  interpolate the reference if the meshes are different  */
+    vtkDataSet* probed  = nullptr;
+    vtkDataArray* valid = nullptr;
+    if (!isMatched) {
+        probed = probe(refArrays, isPoint);
+        for (vtkDataArray*& array : refArrays) {
+            array = probed->GetPointData()->GetArray(array->GetName());
+        }
+        valid = probed->GetPointData()->GetArray("vtkValidPointMask");
+    }
+
+    /*  subtract the arrays  */
+    int numComps           = arrays[0]->GetNumberOfComponents();
+    int stride             = isPoint ? 3 : numComps;
+    vtkDoubleArray* result = vtkDoubleArray::New();
+    result->SetNumberOfComponents(stride);
+    result->SetNumberOfTuples(arrays[0]->GetNumberOfTuples());
+    for (int c = 0; c < arrays.size(); ++c) {
+        using Reals = vtkArrayDispatch::Reals;
+        SubtractWorker worker;
+        double* out = result->GetPointer(0) + c;
+        if (refArrays[c] == nullptr ||
+            refArrays[c]->GetNumberOfTuples() != arrays[c]->GetNumberOfTuples())
+            continue;
+        if (!vtkArrayDispatch::Dispatch2ByValueType<Reals, Reals>::Execute(
+                arrays[c], refArrays[c], worker, out, stride)) {
+            worker(arrays[c], refArrays[c], out, stride);
+        }
+    }
+
+    /*  the locations outside the reference are invalid  */
+    if (valid != nullptr) {
+        double* out = result->GetPointer(0);
+        vtkSMPTools::For(0, result->GetNumberOfTuples(),
+                         [&](vtkIdType begin, vtkIdType end) {
+                             for (vtkIdType i = begin; i < end; ++i) {
+                                 if (valid->GetComponent(i, 0) != 0.0)
+                                     continue;
+                                 for (int c = 0; c < stride; ++c) {
+                                     out[i * stride + c] = NAN;
+                                 }
+                             }
+                         });
+    }
+    if (probed != nullptr) probed->Delete();
+
+    /*  add the difference to the field  */
+    int diffIdx = field->addDerivedField("Diff-" + label, result, isPoint);
+    result->Delete();
+    if (diffIdx < 0) error = "The field Diff-" + label + " already exists";
+    return diffIdx;
+}
+
+/*  ============================================================================
+ *  probe: interpolate the reference arrays at the nodes or the cell centers
+ *  of the field
+ *  @param  arrays: the reference arrays
+ *  @param  isPoint: nodal field or element field
+ *  @return  the probed data set, the arrays are kept by their names and the
+ *           invalid locations are marked by the valid point mask  */
+vtkDataSet* Diff::probe(const QVector<vtkDataArray*>& arrays,
+                        const bool isPoint) {
+    /*  the source only carries the compared arrays  */
+    vtkUnstructuredGrid* source = vtkUnstructuredGrid::New();
+    source->CopyStructure(reference->getInputData());
+    for (vtkDataArray* array : arrays) {
+        if (isPoint) {
+            source->GetPointData()->AddArray(array);
+        } else {
+            source->GetCellData()->AddArray(array);
+        }
+    }
+
+    /*  the locations are the nodes or the cell centers  */
+    vtkDataSet* locations = nullptr;
+    if (isPoint) {
+        vtkPolyData* nodes = vtkPolyData::New();
+        nodes->SetPoints(field->getInputData()->GetPoints());
+        locations = nodes;
+    } else {
+        vtkCellCenters* centers = vtkCellCenters::New();
+        centers->SetInputData(field->getInputData());
+        centers->SetVertexCells(false);
+        centers->SetCopyArrays(false);
+        centers->Update();
+        locations = centers->GetOutput();
+        locations->Register(nullptr);
+        centers->Delete();
+    }
+
+    /*  interpolate the source at the locations  */
+    vtkProbeFilter* filter = vtkProbeFilter::New();
+    filter->SetInputData(locations);
+    filter->SetSourceData(source);
+    filter->SetValidPointMaskArrayName("vtkValidPointMask");
+    filter->Update();
+    vtkDataSet* output = filter->GetOutput();
+    output->Register(nullptr);
+
+    /*  release the temporary objects  */
+    filter->Delete();
+    locations->Delete();
+    source->Delete();
+    return output;
+}
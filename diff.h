@@ -0,0 +1,70 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : diff.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef DIFF_H
+#define DIFF_H
+
+#include <vtkDataSet.h>
+
+#include <QString>
+#include <QVector>
+
+#include "field.h"
+
+/*  ############################################################################
+ *  class Diff: the difference between the field and the reference field,
+ *      e.g., the density change between two optimization iterations. The
+ *      arrays are subtracted directly if the meshes have the same topology
+ *      hash, otherwise the reference is interpolated at the nodes or the
+ *      cell centers by the probe filter. The difference is added to the
+ *      field as a derived field named by "Diff-" and the original name.  */
+class Diff {
+private:
+    Field* field;       // field to be compared
+    Field* reference;   // reference field
+    bool isMatched;     // whether the meshes have the same topology
+    QString error;      // error message of the last computation
+
+public:
+    /*  ########################################################################
+     *  constructor: compare the topology of the field and the reference
+     *  @param  field: the field to be compared
+     *  @param  reference: the reference field  */
+    Diff(Field* field, Field* reference);
+
+    /*  isSameTopology: check whether the meshes have the same topology
+     *  @return  true if the arrays are subtracted directly  */
+    bool isSameTopology() { return isMatched; }
+
+    /*  getError: get the error message of the last computation
+     *  @return  the error message  */
+    QString& getError() { return error; }
+
+    /*  compute: subtract the reference from the field and add the difference
+     *  as the derived field
+     *  @param  idx: the index of the field in the name list
+     *  @return  the index of the difference, -1 if failed  */
+    int compute(const int idx);
+
+private:
+    /*  probe: interpolate the reference arrays at the nodes or the cell
+     *  centers of the field
+     *  @param  arrays: the reference arrays
+     *  @param  isPoint: nodal field or element field
+     *  @return  the probed data set, the arrays are kept by their names and
+     *           the invalid locations are marked by the valid point mask  */
+    vtkDataSet* probe(const QVector<vtkDataArray*>& arrays, const bool isPoint);
+};
+#endif  // DIFF_H
@@ -0,0 +1,585 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : expression.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "expression.h"
+
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*  number of the tuples in a block  */
+static const int BLOCK_SIZE = 256;
+
+/*  operation codes of the bytecode, the left parenthesis is only used by the
+ *  operator stack in the compilation  */
+enum Opcode {
+    OP_CONST,   // push the constant
+    OP_VAR,     // push the variable
+    OP_NEG,     // negative of the top
+    OP_ADD,     // addition
+    OP_SUB,     // subtraction
+    OP_MUL,     // multiplication
+    OP_DIV,     // division
+    OP_POW,     // power
+    OP_CALL,    // call the function
+    OP_LPAREN   // left parenthesis
+};
+
+/*  ids of the builtin functions  */
+enum FunctionId {
+    FN_SQRT,
+    FN_ABS,
+    FN_EXP,
+    FN_LOG,
+    FN_SIN,
+    FN_COS,
+    FN_TAN,
+    FN_MIN,
+    FN_MAX,
+    FN_POW,
+    FN_MISES,
+    FN_PRINCIPAL
+};
+
+/*  Function: the builtin function  */
+struct Function {
+    const char* name;    // name of the function
+    int arity;           // number of the arguments
+    const char* usage;   // usage of the function
+};
+
+/*  builtin functions, indexed by the function id  */
+static const Function FUNCTIONS[] = {
+    {"sqrt", 1, "sqrt(x)"},
+    {"abs", 1, "abs(x)"},
+    {"exp", 1, "exp(x)"},
+    {"log", 1, "log(x)"},
+    {"sin", 1, "sin(x)"},
+    {"cos", 1, "cos(x)"},
+    {"tan", 1, "tan(x)"},
+    {"min", 2, "min(x, y)"},
+    {"max", 2, "max(x, y)"},
+    {"pow", 2, "pow(x, y)"},
+    {"mises", 6, "mises(sxx, syy, szz, sxy, syz, sxz)"},
+    {"principal", 7, "principal(sxx, syy, szz, sxy, syz, sxz, k)"}};
+static const int NUM_FUNCTIONS = sizeof(FUNCTIONS) / sizeof(Function);
+
+/*  ratio of the circumference to the diameter  */
+static const double PI = 3.14159265358979323846;
+
+/*  precedences of the operators  */
+static const int PREC_ADD = 1;
+static const int PREC_MUL = 2;
+static const int PREC_NEG = 3;
+static const int PREC_POW = 4;
+
+/*  ############################################################################
+ *  principal: get the principal values of the symmetric tensor in the
+ *  descending order by the trigonometric solution of the characteristic
+ *  equation
+ *  @param  s: the components xx, yy, zz, xy, yz, xz
+ *  @param  e: the principal values  */
+static void principal(const double s[6], double e[3]) {
+    double off = s[3] * s[3] + s[4] * s[4] + s[5] * s[5];
+    double q   = (s[0] + s[1] + s[2]) / 3.0;
+
+    /*  the tensor is diagonal  */
+    if (off == 0.0) {
+        e[0] = s[0];
+        e[1] = s[1];
+        e[2] = s[2];
+        std::sort(e, e + 3, [](double a, double b) { return a > b; });
+        return;
+    }
+
+    /*  the deviatoric part scaled by p  */
+    double dx = s[0] - q, dy = s[1] - q, dz = s[2] - q;
+    double p  = std::sqrt((dx * dx + dy * dy + dz * dz + 2.0 * off) / 6.0);
+    double bx = dx / p, by = dy / p, bz = dz / p;
+    double bxy = s[3] / p, byz = s[4] / p, bxz = s[5] / p;
+    double det = bx * (by * bz - byz * byz) - bxy * (bxy * bz - byz * bxz) +
+                 bxz * (bxy * byz - by * bxz);
+    double phi = std::acos(std::clamp(0.5 * det, -1.0, 1.0)) / 3.0;
+
+    /*  the principal values  */
+    e[0] = q + 2.0 * p * std::cos(phi);
+    e[2] = q + 2.0 * p * std::cos(phi + 2.0 * PI / 3.0);
+    e[1] = 3.0 * q - e[0] - e[2];
+}
+
+/*  call: evaluate the function over the block, the arguments are stored in
+ *  the consecutive slots of the stack and the result overwrites the first
+ *  @param  id: the id of the function
+ *  @param  x: the first argument in the stack
+ *  @param  size: the number of the tuples in the block  */
+static void call(const int id, double* x, const int size) {
+    double* y = x + BLOCK_SIZE;
+    switch (id) {
+        case FN_SQRT:
+            for (int i = 0; i < size; ++i) x[i] = std::sqrt(x[i]);
+            break;
+        case FN_ABS:
+            for (int i = 0; i < size; ++i) x[i] = std::fabs(x[i]);
+            break;
+        case FN_EXP:
+            for (int i = 0; i < size; ++i) x[i] = std::exp(x[i]);
+            break;
+        case FN_LOG:
+            for (int i = 0; i < size; ++i) x[i] = std::log(x[i]);
+            break;
+        case FN_SIN:
+            for (int i = 0; i < size; ++i) x[i] = std::sin(x[i]);
+            break;
+        case FN_COS:
+            for (int i = 0; i < size; ++i) x[i] = std::cos(x[i]);
+            break;
+        case FN_TAN:
+            for (int i = 0; i < size; ++i) x[i] = std::tan(x[i]);
+            break;
+        case FN_MIN:
+            for (int i = 0; i < size; ++i) x[i] = std::min(x[i], y[i]);
+            break;
+        case FN_MAX:
+            for (int i = 0; i < size; ++i) x[i] = std::max(x[i], y[i]);
+            break;
+        case FN_POW:
+            for (int i = 0; i < size; ++i) x[i] = std::pow(x[i], y[i]);
+            break;
+        case FN_MISES: {
+            const double* s[6];
+            for (int k = 0; k < 6; ++k) s[k] = x + k * BLOCK_SIZE;
+            for (int i = 0; i < size; ++i) {
+                double a = s[0][i] - s[1][i];
+                double b = s[1][i] - s[2][i];
+                double c = s[2][i] - s[0][i];
+                double t = s[3][i] * s[3][i] + s[4][i] * s[4][i] +
+                           s[5][i] * s[5][i];
+                x[i] = std::sqrt(0.5 * (a * a + b * b + c * c) + 3.0 * t);
+            }
+            break;
+        }
+        case FN_PRINCIPAL: {
+            for (int i = 0; i < size; ++i) {
+                double s[6], e[3];
+                for (int k = 0; k < 6; ++k) s[k] = x[k * BLOCK_SIZE + i];
+                principal(s, e);
+                int k = std::clamp(int(x[6 * BLOCK_SIZE + i]), 0, 2);
+                x[i]  = e[k];
+            }
+            break;
+        }
+    }
+}
+
+/*  ############################################################################
+ *  constructor: compile the expression
+ *  @param  text: the text of the expression
+ *  @param  names: the names of the available variables  */
+Expression::Expression(const QString& _text, const QStringList& _names) {
+    text  = _text;
+    names = _names;
+    depth = 0;
+    if (!compile()) code.clear();
+}
+
+/*  getFunctionNames: get the names of the builtin functions
+ *  @return  the names and arguments of the functions  */
+QStringList Expression::getFunctionNames() {
+    QStringList list;
+    for (int i = 0; i < NUM_FUNCTIONS; ++i) list << FUNCTIONS[i].usage;
+    list << "pi";
+    return list;
+}
+
+/*  ============================================================================
+ *  evaluate: evaluate the expression over the tuples in parallel
+ *  @param  inputs: the values of the variables
+ *  @param  numTuples: the number of the tuples
+ *  @param  output: the result of each tuple  */
+void Expression::evaluate(const QVector<Input>& inputs,
+                          const vtkIdType numTuples, double* output) {
+    if (!isValid() || inputs.size() != variables.size()) return;
+
+    /*  the stack of each thread  */
+    std::vector<double> exemplar(size_t(depth) * BLOCK_SIZE, 0.0);
+    vtkSMPThreadLocal<std::vector<double>> local(exemplar);
+
+    /*  execute the blocks  */
+    vtkSMPTools::For(0, numTuples, BLOCK_SIZE * 16,
+                     [&](vtkIdType begin, vtkIdType end) {
+                         std::vector<double>& stack = local.Local();
+                         for (vtkIdType b = begin; b < end; b += BLOCK_SIZE) {
+                             int size = int(std::min<vtkIdType>(BLOCK_SIZE,
+                                                                end - b));
+                             execute(inputs, b, size, stack.data(),
+                                     output + b);
+                         }
+                     });
+}
+
+/*  ============================================================================
+ *  compile: translate the expression to the postfix bytecode by the
+ *  shunting-yard algorithm, and check the stack of the bytecode
+ *  @return  true if the expression is valid  */
+bool Expression::compile() {
+    /*  define the temporary variables  */
+    QVector<Instruction> ops;   // operator stack, value is the precedence
+    QVector<int> numArgs;       // number of the arguments of each parenthesis
+    bool isOperand = true;      // an operand is expected
+    int pos        = 0;         // position in the text
+
+    /*  loop over the tokens  */
+    while (pos < text.size()) {
+        QChar c = text[pos];
+        if (c.isSpace()) {
+            ++pos;
+            continue;
+        }
+
+        /*  ************************************************************
+         *  operand, unary operator or left parenthesis  */
+        if (isOperand) {
+            //  number
+            if (c.isDigit() || c == '.') {
+                int end = pos;
+                while (end < text.size() &&
+                       (text[end].isDigit() || text[end] == '.')) {
+                    ++end;
+                }
+                if (end < text.size() &&
+                    (text[end] == 'e' || text[end] == 'E')) {
+                    int exp = end + 1;
+                    if (exp < text.size() &&
+                        (text[exp] == '+' || text[exp] == '-')) {
+                        ++exp;
+                    }
+                    if (exp < text.size() && text[exp].isDigit()) {
+                        end = exp;
+                        while (end < text.size() && text[end].isDigit()) ++end;
+                    }
+                }
+                bool isOk    = false;
+                double value = text.mid(pos, end - pos).toDouble(&isOk);
+                if (!isOk) {
+                    error = QString("Invalid number at %1").arg(pos + 1);
+                    return false;
+                }
+                code.append({OP_CONST, 0, value});
+                pos       = end;
+                isOperand = false;
+                continue;
+            }
+            //  left parenthesis
+            if (c == '(') {
+                ops.append({OP_LPAREN, -1, 0.0});
+                numArgs.append(1);
+                ++pos;
+                continue;
+            }
+            //  unary operator
+            if (c == '-' || c == '+') {
+                if (c == '-') ops.append({OP_NEG, 0, double(PREC_NEG)});
+                ++pos;
+                continue;
+            }
+            //  variable
+            int start = pos;
+            int idx   = matchVariable(pos);
+            if (idx >= 0) {
+                Variable variable = {names[idx], -1};
+                if (pos < text.size() && text[pos] == '[') {
+                    int end = text.indexOf(']', pos);
+                    bool isOk = false;
+                    if (end > 0) {
+                        variable.comp =
+                            text.mid(pos + 1, end - pos - 1).toInt(&isOk);
+                    }
+                    if (!isOk || variable.comp < 0) {
+                        error = QString("Invalid component at %1").arg(pos + 1);
+                        return false;
+                    }
+                    pos = end + 1;
+                }
+                int slot = -1;
+                for (int i = 0; i < variables.size(); ++i) {
+                    if (variables[i].name == variable.name &&
+                        variables[i].comp == variable.comp) {
+                        slot = i;
+                    }
+                }
+                if (slot < 0) {
+                    slot = variables.size();
+                    variables.append(variable);
+                }
+                code.append({OP_VAR, slot, 0.0});
+                isOperand = false;
+                continue;
+            }
+            if (c == '{') {
+                error = QString("Unknown variable at %1").arg(start + 1);
+                return false;
+            }
+            //  constant or function
+            if (c.isLetter() || c == '_') {
+                int end = pos;
+                while (end < text.size() &&
+                       (text[end].isLetterOrNumber() || text[end] == '_')) {
+                    ++end;
+                }
+                QString word = text.mid(pos, end - pos);
+                if (word == "pi") {
+                    code.append({OP_CONST, 0, PI});
+                    pos       = end;
+                    isOperand = false;
+                    continue;
+                }
+                int id = -1;
+                for (int i = 0; i < NUM_FUNCTIONS; ++i) {
+                    if (word == FUNCTIONS[i].name) id = i;
+                }
+                while (end < text.size() && text[end].isSpace()) ++end;
+                if (id < 0 || end >= text.size() || text[end] != '(') {
+                    error = QString("Unknown name '%1' at %2")
+                                .arg(word)
+                                .arg(pos + 1);
+                    return false;
+                }
+                ops.append({OP_CALL, id, -1.0});
+                ops.append({OP_LPAREN, id, 0.0});
+                numArgs.append(1);
+                pos = end + 1;
+                continue;
+            }
+            error = QString("Operand expected at %1").arg(pos + 1);
+            return false;
+        }
+
+        /*  ************************************************************
+         *  binary operator, comma or right parenthesis  */
+        int opcode = -1, prec = 0;
+        switch (c.unicode()) {
+            case '+':
+                opcode = OP_ADD;
+                prec   = PREC_ADD;
+                break;
+            case '-':
+                opcode = OP_SUB;
+                prec   = PREC_ADD;
+                break;
+            case '*':
+                opcode = OP_MUL;
+                prec   = PREC_MUL;
+                break;
+            case '/':
+                opcode = OP_DIV;
+                prec   = PREC_MUL;
+                break;
+            case '^':
+                opcode = OP_POW;
+                prec   = PREC_POW;
+                break;
+        }
+        if (opcode >= 0) {
+            //  the power is right associative
+            while (!ops.isEmpty() && ops.last().opcode != OP_LPAREN &&
+                   (ops.last().value > prec ||
+                    (ops.last().value == prec && opcode != OP_POW))) {
+                code.append(ops.takeLast());
+            }
+            ops.append({opcode, 0, double(prec)});
+            ++pos;
+            isOperand = true;
+            continue;
+        }
+        if (c == ',' || c == ')') {
+            while (!ops.isEmpty() && ops.last().opcode != OP_LPAREN) {
+                code.append(ops.takeLast());
+            }
+            if (ops.isEmpty()) {
+                error = QString("Unmatched '%1' at %2").arg(c).arg(pos + 1);
+                return false;
+            }
+            //  next argument of the function
+            if (c == ',') {
+                if (ops.last().operand < 0) {
+                    error = QString("Unexpected ',' at %1").arg(pos + 1);
+                    return false;
+                }
+                numArgs.last()++;
+                ++pos;
+                isOperand = true;
+                continue;
+            }
+            //  close the parenthesis and call the function
+            int id    = ops.takeLast().operand;
+            int count = numArgs.takeLast();
+            if (id >= 0) {
+                ops.removeLast();
+                if (count != FUNCTIONS[id].arity) {
+                    error = QString("%1 expects %2 arguments")
+                                .arg(FUNCTIONS[id].usage)
+                                .arg(FUNCTIONS[id].arity);
+                    return false;
+                }
+                code.append({OP_CALL, id, 0.0});
+            } else if (count != 1) {
+                error = QString("Unexpected ',' before %1").arg(pos + 1);
+                return false;
+            }
+            ++pos;
+            continue;
+        }
+        error = QString("Operator expected at %1").arg(pos + 1);
+        return false;
+    }
+
+    /*  pop the remaining operators  */
+    if (isOperand) {
+        error = text.trimmed().isEmpty() ? QString("Empty expression")
+                                         : QString("Incomplete expression");
+        return false;
+    }
+    while (!ops.isEmpty()) {
+        if (ops.last().opcode == OP_LPAREN) {
+            error = "Unmatched '('";
+            return false;
+        }
+        code.append(ops.takeLast());
+    }
+
+    /*  check the stack of the bytecode  */
+    int size = 0;
+    for (const Instruction& ins : code) {
+        if (ins.opcode == OP_CONST || ins.opcode == OP_VAR) {
+            ++size;
+        } else if (ins.opcode == OP_CALL) {
+            size -= FUNCTIONS[ins.operand].arity - 1;
+        } else if (ins.opcode != OP_NEG) {
+            --size;
+        }
+        depth = std::max(depth, size);
+    }
+    if (size != 1) {
+        error = "Invalid expression";
+        return false;
+    }
+    return true;
+}
+
+/*  matchVariable: match the longest variable name at the position
+ *  @param  pos: the position in the text, moved to the end of the name
+ *  @return  the slot of the variable, -1 if no name is matched  */
+int Expression::matchVariable(int& pos) {
+    /*  the name quoted by the braces  */
+    if (text[pos] == '{') {
+        int end = text.indexOf('}', pos);
+        if (end < 0) return -1;
+        int idx = names.indexOf(text.mid(pos + 1, end - pos - 1));
+        if (idx >= 0) pos = end + 1;
+        return idx;
+    }
+
+    /*  the longest name that is not followed by the identifier  */
+    int idx = -1;
+    for (int i = 0; i < names.size(); ++i) {
+        const QString& name = names[i];
+        if (name.isEmpty() || (idx >= 0 && name.size() <= names[idx].size()))
+            continue;
+        if (!QStringView(text).mid(pos).startsWith(name)) continue;
+        int end = pos + name.size();
+        if (end < text.size() &&
+            (text[end].isLetterOrNumber() || text[end] == '_'))
+            continue;
+        idx = i;
+    }
+    if (idx >= 0) pos += names[idx].size();
+    return idx;
+}
+
+/*  ============================================================================
+ *  execute: execute the bytecode over a block of tuples
+ *  @param  inputs: the values of the variables
+ *  @param  begin: the first tuple of the block
+ *  @param  size: the number of the tuples in the block
+ *  @param  stack: the stack of the block values
+ *  @param  output: the result of the block  */
+void Expression::execute(const QVector<Input>& inputs, const vtkIdType begin,
+                         const int size, double* stack, double* output) {
+    int top = 0;  // number of the values in the stack
+    for (const Instruction& ins : code) {
+        double* r = stack + top * BLOCK_SIZE;  // the slot above the top
+        double* a = r - BLOCK_SIZE;            // the top value
+        double* b = a - BLOCK_SIZE;            // the value below the top
+        switch (ins.opcode) {
+            case OP_CONST:
+                for (int i = 0; i < size; ++i) r[i] = ins.value;
+                ++top;
+                break;
+            case OP_VAR: {
+                const Input& in = inputs[ins.operand];
+                const int nc    = in.numComps;
+                const double* d = in.data + begin * nc;
+                if (nc == 1) {
+                    for (int i = 0; i < size; ++i) r[i] = d[i];
+                } else if (in.comp >= 0) {
+                    for (int i = 0; i < size; ++i) r[i] = d[i * nc + in.comp];
+                } else {
+                    for (int i = 0; i < size; ++i) {
+                        double sum = 0.0;
+                        for (int k = 0; k < nc; ++k) {
+                            sum += d[i * nc + k] * d[i * nc + k];
+                        }
+                        r[i] = std::sqrt(sum);
+                    }
+                }
+                ++top;
+                break;
+            }
+            case OP_NEG:
+                for (int i = 0; i < size; ++i) a[i] = -a[i];
+                break;
+            case OP_ADD:
+                for (int i = 0; i < size; ++i) b[i] += a[i];
+                --top;
+                break;
+            case OP_SUB:
+                for (int i = 0; i < size; ++i) b[i] -= a[i];
+                --top;
+                break;
+            case OP_MUL:
+                for (int i = 0; i < size; ++i) b[i] *= a[i];
+                --top;
+                break;
+            case OP_DIV:
+                for (int i = 0; i < size; ++i) b[i] /= a[i];
+                --top;
+                break;
+            case OP_POW:
+                for (int i = 0; i < size; ++i) b[i] = std::pow(b[i], a[i]);
+                --top;
+                break;
+            case OP_CALL: {
+                int arity = FUNCTIONS[ins.operand].arity;
+                call(ins.operand, stack + (top - arity) * BLOCK_SIZE, size);
+                top -= arity - 1;
+                break;
+            }
+        }
+    }
+    std::copy(stack, stack + size, output);
+}
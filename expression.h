@@ -0,0 +1,127 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : expression.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <vtkType.h>
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*  ############################################################################
+ *  class Expression: the arithmetic expression of the field variables, e.g.,
+ *      "U:Magnitude * Var-0" or "mises(S[0], S[1], S[2], S[3], S[4], S[5])".
+ *      The expression is compiled once into the postfix bytecode, which is
+ *      executed by the parallel threads over the blocks of tuples, so that
+ *      each instruction is a tight loop over the block. The variables are
+ *      matched by the longest available name, the name can also be quoted
+ *      by the braces, e.g., {Var-0}, and the component of a multi-component
+ *      array is selected by the index, e.g., S[2].  */
+class Expression {
+public:
+    class Variable;      // variable referenced by the expression
+    class Input;         // values of the variable
+    class Instruction;   // instruction of the bytecode
+
+private:
+    QString text;                // text of the expression
+    QString error;               // error message, empty if it is valid
+    QStringList names;           // names of the available variables
+    QList<Variable> variables;   // variables referenced by the expression
+    QVector<Instruction> code;   // postfix bytecode
+    int depth;                   // maximum depth of the stack
+
+public:
+    /*  ########################################################################
+     *  constructor: compile the expression
+     *  @param  text: the text of the expression
+     *  @param  names: the names of the available variables  */
+    Expression(const QString& text, const QStringList& names);
+
+    /*  isValid: check whether the expression has been compiled
+     *  @return  true if the expression is valid  */
+    bool isValid() { return error.isEmpty(); }
+
+    /*  getError: get the error message of the compilation
+     *  @return  the error message  */
+    QString& getError() { return error; }
+
+    /*  getVariables: get the variables referenced by the expression, the
+     *  inputs of the evaluation are given in the same order
+     *  @return  the list of the variables  */
+    QList<Variable>& getVariables() { return variables; }
+
+    /*  getFunctionNames: get the names of the builtin functions
+     *  @return  the names and arguments of the functions  */
+    static QStringList getFunctionNames();
+
+    /*  evaluate: evaluate the expression over the tuples in parallel
+     *  @param  inputs: the values of the variables
+     *  @param  numTuples: the number of the tuples
+     *  @param  output: the result of each tuple  */
+    void evaluate(const QVector<Input>& inputs, const vtkIdType numTuples,
+                  double* output);
+
+private:
+    /*  compile: translate the expression to the postfix bytecode by the
+     *  shunting-yard algorithm, and check the stack of the bytecode
+     *  @return  true if the expression is valid  */
+    bool compile();
+
+    /*  matchVariable: match the longest variable name at the position
+     *  @param  pos: the position in the text, moved to the end of the name
+     *  @return  the slot of the variable, -1 if no name is matched  */
+    int matchVariable(int& pos);
+
+    /*  execute: execute the bytecode over a block of tuples
+     *  @param  inputs: the values of the variables
+     *  @param  begin: the first tuple of the block
+     *  @param  size: the number of the tuples in the block
+     *  @param  stack: the stack of the block values
+     *  @param  output: the result of the block  */
+    void execute(const QVector<Input>& inputs, const vtkIdType begin,
+                 const int size, double* stack, double* output);
+};
+
+/*  ############################################################################
+ *  class Expression::Variable: the variable referenced by the expression  */
+class Expression::Variable {
+public:
+    QString name;   // name of the array
+    int comp;       // component, -1 for the magnitude or scalar
+};
+
+/*  ############################################################################
+ *  class Expression::Input: the values of the variable, i.e., the contiguous
+ *      tuples of an array  */
+class Expression::Input {
+public:
+    const double* data;   // values of the tuples
+    int numComps;         // number of the components
+    int comp;             // component, -1 for the magnitude or scalar
+};
+
+/*  ############################################################################
+ *  class Expression::Instruction: the instruction of the bytecode  */
+class Expression::Instruction {
+public:
+    int opcode;     // operation code
+    int operand;    // slot of the variable, or id of the function
+    double value;   // value of the constant
+};
+#endif  // EXPRESSION_H
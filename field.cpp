@@ -16,8 +16,27 @@
 
 #include "field.h"
 
+#include <vtkCellArray.h>
+#include <vtkSMPTools.h>
+#include <vtkSTLWriter.h>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "partition.h"
 #include "prenano.h"
 
+/*  parameters of the FNV-1a hash  */
+static const quint64 FNV_OFFSET = 14695981039346656037ULL;
+static const quint64 FNV_PRIME  = 1099511628211ULL;
+
+/*  size of the chunks hashed by each thread in bytes  */
+static const vtkIdType HASH_CHUNK = 1 << 20;
+
 /*  ############################################################################
  *  CLASS Field: the class to define the filed that will have a interaction with
  *      the Viewer object. It includes the nodes, elements, vector field (
@@ -29,32 +48,163 @@ Field::Field(QString& _name) {
     /*  assign the name of the filed  */
     name = _name;
 
-    /*  setup the ugrd reader  */
-    reader = vtkXMLUnstructuredGridReader::New();
-    reader->SetFileName(name.toStdString().c_str());
-    reader->Update();
-
-    /*  read the field data  */
-    ugridAll = reader->GetOutput();
-    portAll  = reader->GetOutputPort();
+    /*  read the field data, only the anchors are read if the arrays are
+     *  loaded on demand  */
+    isLazy = isLazyFormat(name);
+    isRead = readFile(name, isLazy);
+    if (!isRead) return;
 
     /*  get the field data  */
-    pointData     = ugridAll->GetPointData();
-    cellData      = ugridAll->GetCellData();
-    numPointField = pointData->GetNumberOfArrays();
-    numCellField  = cellData->GetNumberOfArrays();
+    pointData = ugridAll->GetPointData();
+    cellData  = ugridAll->GetCellData();
     //  determine the field name list  */
     assignFieldNameList();
     initializePointData();
 
+    /*  setup the picking array, warper and filters  */
+    setupPipeline();
+}
+
+/*  ============================================================================
+ *  constructor: reload the Field object from the binary cache file that is
+ *  written by saveCache, the derived arrays are not generated again
+ *  @param  name: the name of the field
+ *  @param  cache: the binary cache file of the field
+ *  @param  meta: the resident meta data of the field  */
+Field::Field(QString& _name, const QString& cache, const Meta& meta) {
+    /*  assign the name of the filed  */
+    name = _name;
+
+    /*  read the field data from the cache file, the missing arrays are
+     *  loaded from the result file on demand  */
+    isLazy = isLazyFormat(name);
+    isRead = readFile(cache, false);
+    if (!isRead) return;
+
+    /*  get the field data, the name lists are restored from the meta data  */
+    pointData     = ugridAll->GetPointData();
+    cellData      = ugridAll->GetCellData();
+    numPointField = meta.numPointField;
+    numCellField  = meta.numCellField;
+    fieldNameList = meta.fieldNameList;
+    compNameList  = meta.compNameList;
+    derivedList   = meta.derivedList;
+
+    /*  setup the picking array, warper and filters  */
+    setupPipeline();
+}
+
+/*  ============================================================================
+ *  readFile: read the field data from the vtu file, or assemble it from the
+ *  pieces if the partitioned pvtu file is given
+ *  @param  file: the path of the result file
+ *  @param  isAnchorOnly: only read the anchor arrays, i.e., U and Var-0
+ *  @return  the status, true for success, otherwise failed  */
+bool Field::readFile(const QString& file, const bool isAnchorOnly) {
+    arrayReader = nullptr;
+    reader      = createReader(file);
+    if (reader == nullptr) {
+        /*  assemble the pieces, the producer takes the global ugrid  */
+        Partition partition(file);
+        vtkUnstructuredGrid* ugrid = partition.assemble();
+        if (ugrid == nullptr) return false;
+        vtkTrivialProducer* producer = vtkTrivialProducer::New();
+        producer->SetOutput(ugrid);
+        ugrid->Delete();
+        reader = producer;
+
+    } else if (isAnchorOnly) {
+        /*  read the array names, and then select the anchors  */
+        reader->UpdateInformation();
+        vtkDataArraySelection* pointSelect = getArraySelection(reader, true);
+        vtkDataArraySelection* cellSelect  = getArraySelection(reader, false);
+        pointSelect->DisableAllArrays();
+        cellSelect->DisableAllArrays();
+        if (pointSelect->ArrayExists("U")) pointSelect->EnableArray("U");
+        if (cellSelect->ArrayExists("Var-0")) cellSelect->EnableArray("Var-0");
+    }
+    reader->Update();
+
+    /*  read the field data, the unreadable file gives no points  */
+    vtkDataObject* output = reader->GetOutputDataObject(0);
+    ugridAll              = vtkUnstructuredGrid::SafeDownCast(output);
+    portAll               = reader->GetOutputPort();
+    return ugridAll != nullptr && ugridAll->GetNumberOfPoints() > 0;
+}
+
+/*  createReader: create the reader according to the suffix of the file, the
+ *  partitioned pvtu file has no reader
+ *  @param  file: the path of the result file
+ *  @return  the reader, nullptr for the partitioned file  */
+vtkAlgorithm* Field::createReader(const QString& file) {
+    QString suffix = QFileInfo(file).suffix().toLower();
+    if (suffix == "pvtu") return nullptr;
+
+    /*  the chunked HDF5 based format  */
+    if (suffix == "vtkhdf" || suffix == "hdf") {
+        vtkHDFReader* hdfReader = vtkHDFReader::New();
+        hdfReader->SetFileName(file.toStdString().c_str());
+        return hdfReader;
+    }
+
+    /*  the XML format  */
+    vtkXMLUnstructuredGridReader* xmlReader =
+        vtkXMLUnstructuredGridReader::New();
+    xmlReader->SetFileName(file.toStdString().c_str());
+    return xmlReader;
+}
+
+/*  isLazyFormat: check whether the arrays of the file can be loaded on demand,
+ *  i.e., the reader supports the array selection
+ *  @param  file: the path of the result file
+ *  @return  true if the arrays are loaded on demand  */
+bool Field::isLazyFormat(const QString& file) {
+    //  all formats except the partitioned pvtu support the array selection
+    return QFileInfo(file).suffix().toLower() != "pvtu";
+}
+
+/*  getArraySelection: get the array selection of the reader
+ *  @param  alg: the reader of the result file
+ *  @param  isPoint: point data or cell data
+ *  @return  the array selection, nullptr if not supported  */
+vtkDataArraySelection* Field::getArraySelection(vtkAlgorithm* alg,
+                                                const bool isPoint) {
+    if (vtkHDFReader* hdfReader = vtkHDFReader::SafeDownCast(alg)) {
+        return isPoint ? hdfReader->GetPointDataArraySelection()
+                       : hdfReader->GetCellDataArraySelection();
+    }
+    if (vtkXMLReader* xmlReader = vtkXMLReader::SafeDownCast(alg)) {
+        return isPoint ? xmlReader->GetPointDataArraySelection()
+                       : xmlReader->GetCellDataArraySelection();
+    }
+    return nullptr;
+}
+
+/*  ============================================================================
+ *  setupPipeline: setup the picking array, warper and filters after the field
+ *  data has been read  */
+void Field::setupPipeline() {
+    /*  the loaded fields are treated as just requested  */
+    lastUsed.fill(QDateTime::currentMSecsSinceEpoch(), fieldNameList.size());
+    idxShown = -1;
+
+    /*  range service of the arrays  */
+    range        = new Range;
+    cellVolumes  = nullptr;
+    locator      = vtkStaticCellLocator::New();
+    topologyHash = 0;
+
     /*  cell picking  */
-    isPicked  = false;
-    pickArray = vtkDoubleArray::New();
-    pickArray->SetNumberOfTuples(cellData->GetArray(0)->GetNumberOfTuples());
-    pickArray->SetNumberOfComponents(1);
-    pickArray->Fill(1.0);
-    pickArray->SetName("PickCells");
-    cellData->SetScalars(pickArray);
+    isPicked = false;
+    pickIds  = nullptr;
+    vtkDoubleArray* pickCells = vtkDoubleArray::New();
+    pickCells->SetNumberOfComponents(1);
+    pickCells->SetNumberOfTuples(ugridAll->GetNumberOfCells());
+    pickCells->Fill(1.0);
+    pickCells->SetName("PickCells");
+    cellData->SetScalars(pickCells);
+    pickCells->Delete();
+    pickArray = cellData->GetArray("PickCells");
 
     /*  create the warpper object  */
     warp = vtkWarpVector::New();
@@ -65,6 +215,45 @@ Field::Field(QString& _name) {
     pickFilter    = vtkThreshold::New();
     contourFilter = vtkContourFilter::New();
     cleanFilter   = vtkCleanUnstructuredGrid::New();
+    appendFilter  = nullptr;
+
+    /*  create the iso-surface filters  */
+    isoPoint    = vtkCellDataToPointData::New();
+    isoLinear   = vtkContour3DLinearGrid::New();
+    isoDecimate = vtkQuadricClustering::New();
+    isoSmooth   = vtkWindowedSincPolyDataFilter::New();
+    isoNormals  = vtkPolyDataNormals::New();
+
+    /*  configure the iso-surface filters once, so only the contour and the
+     *  downstream filters are executed again if the level is changed  */
+    isoPoint->SetInputConnection(warp->GetOutputPort());
+    isoPoint->ProcessAllArraysOff();
+    isoPoint->AddCellDataArray("Var-0");
+    isoPoint->PassCellDataOff();
+    isoLinear->SetInputConnection(isoPoint->GetOutputPort());
+    isoLinear->SetInputArrayToProcess(
+        0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Var-0");
+    isoLinear->MergePointsOn();
+    isoLinear->InterpolateAttributesOff();
+    isoLinear->ComputeNormalsOff();
+    isoLinear->SequentialProcessingOff();
+    contourFilter->SetInputConnection(isoPoint->GetOutputPort());
+    contourFilter->SetInputArrayToProcess(
+        0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "Var-0");
+    contourFilter->ComputeScalarsOff();
+    contourFilter->ComputeNormalsOff();
+    isoDecimate->SetNumberOfDivisions(PRENANO::ISO_DIVISIONS,
+                                      PRENANO::ISO_DIVISIONS,
+                                      PRENANO::ISO_DIVISIONS);
+    isoDecimate->AutoAdjustNumberOfDivisionsOn();
+    isoSmooth->SetNumberOfIterations(PRENANO::ISO_SMOOTH_ITERATIONS);
+    isoSmooth->SetPassBand(0.05);
+    isoSmooth->BoundarySmoothingOff();
+    isoSmooth->FeatureEdgeSmoothingOff();
+    isoSmooth->NonManifoldSmoothingOn();
+    isoSmooth->NormalizeCoordinatesOn();
+    isoNormals->SplittingOff();
+    isoNormals->ComputePointNormalsOn();
 
     /*  initialize the anchor  */
     limitType  = 0;
@@ -81,12 +270,30 @@ Field::Field(QString& _name) {
  *  destructor: destroy the vtk related object, such as reader, ugrid, point
  *  data, cell data, port, set, warp and so on   */
 Field::~Field() {
-    /*  delete the variables  */
-    portAll->Delete();
-    cellData->Delete();
-    pointData->Delete();
+    /*  the field that failed to be read only has its reader  */
+    if (!isRead) {
+        if (reader != nullptr) reader->Delete();
+        return;
+    }
+
+    /*  delete the variables, the ugrid, port, point data and cell data are
+     *  owned by the reader  */
+    delete range;
+    if (cellVolumes != nullptr) cellVolumes->Delete();
+    locator->Delete();
+    if (pickIds != nullptr) pickIds->Delete();
+    if (arrayReader != nullptr) arrayReader->Delete();
+    if (appendFilter != nullptr) appendFilter->Delete();
+    cleanFilter->Delete();
+    isoNormals->Delete();
+    isoSmooth->Delete();
+    isoDecimate->Delete();
+    isoLinear->Delete();
+    isoPoint->Delete();
+    contourFilter->Delete();
+    pickFilter->Delete();
+    denFilter->Delete();
     warp->Delete();
-    ugridAll->Delete();
     reader->Delete();
 
     /*  assign the variable to null  */
@@ -103,76 +310,287 @@ Field::~Field() {
  *  @return  the path of the current model  */
 QString& Field::getPathName() { return name; }
 
+/*  getMeta: get the lightweight meta data of the field, i.e., the name lists
+ *  and the range of each field
+ *  @return  the meta data of the field  */
+Field::Meta Field::getMeta() {
+    /*  copy the name lists  */
+    Meta meta;
+    meta.fieldNameList = fieldNameList;
+    meta.compNameList  = compNameList;
+    meta.derivedList   = derivedList;
+    meta.numPointField = numPointField;
+    meta.numCellField  = numCellField;
+
+    /*  determine the range of each field, the magnitude is used for the
+     *  nodal fields  */
+    vtkDataArray* array = nullptr;
+    for (int i = 0; i < fieldNameList.size(); ++i) {
+        if (i < numPointField) {
+            QString arrayName = fieldNameList[i] + ":" + compNameList[3];
+            array = pointData->GetArray(arrayName.toStdString().c_str());
+        } else {
+            array = cellData->GetArray(fieldNameList[i].toStdString().c_str());
+        }
+        //  the missing array is recorded with an empty range
+        if (array == nullptr) {
+            meta.ranges << 0.0 << 0.0;
+        } else {
+            meta.ranges << array->GetRange()[0] << array->GetRange()[1];
+        }
+    }
+    return meta;
+}
+
+/*  getMemorySize: get the memory occupied by the field data
+ *  @return  the memory size in kibibytes  */
+qint64 Field::getMemorySize() {
+    /*  the complete ugrid, the warped points and the threshold output  */
+    qint64 size = ugridAll->GetActualMemorySize();
+    //  the warped points are missing if the grid has no points yet
+    vtkPoints* warped = warp->GetOutput()->GetPoints();
+    if (warped != nullptr) size += warped->GetData()->GetActualMemorySize();
+    size += denFilter->GetOutput()->GetActualMemorySize();
+
+    /*  the mirrored and picked ugrid  */
+    if (appendFilter != nullptr) {
+        size += cleanFilter->GetOutput()->GetActualMemorySize();
+    }
+    if (isPicked) size += pickFilter->GetOutput()->GetActualMemorySize();
+    return size;
+}
+
+/*  saveCache: write the field data to a binary file, which can be loaded much
+ *  faster than the original compressed or encoded vtu file
+ *  @param  file: the path of the binary cache file
+ *  @return  the status, true for success, otherwise failed  */
+bool Field::saveCache(const QString& file) {
+    /*  write the raw binary data without compression and encoding  */
+    vtkXMLUnstructuredGridWriter* writer = vtkXMLUnstructuredGridWriter::New();
+    writer->SetFileName(file.toStdString().c_str());
+    writer->SetInputData(ugridAll);
+    writer->SetDataModeToAppended();
+    writer->EncodeAppendedDataOff();
+    writer->SetCompressorTypeToNone();
+    int status = writer->Write();
+
+    /*  release the writer  */
+    writer->Delete();
+    return status == 1;
+}
+
 /*  getInputPort: get the initial port, i.e., the input port of the field
  *  variables
  *  @return  the initial port of the field data  */
-vtkAlgorithmOutput* Field::getInputPort() { return reader->GetOutputPort(); }
+vtkAlgorithmOutput* Field::getInputPort() { return portAll; }
 
 /*  getInputData: get the initial unstructured grid of the field
  *  @return  the initial ugrid  */
-vtkUnstructuredGrid* Field::getInputData() { return reader->GetOutput(); }
+vtkUnstructuredGrid* Field::getInputData() { return ugridAll; }
 
 /*  ############################################################################
  *  initliztePointData: initialize the point data in the field  */
 void Field::initializePointData() {
+    /*  extract the components of the loaded point data  */
+    for (int i = 0; i < numPointField; ++i) splitPointData(i);
+}
+
+/*  splitPointData: split the point data into the components and the magnitude,
+ *  the original array is removed except the displacement
+ *  @param  idx: the index of the point data in the name list  */
+void Field::splitPointData(const int idx) {
     /*  define the temporary variables  */
     vtkDataArray* dtOld;     // the old data
     vtkDoubleArray* dtCur;   // the extracted data
     std::stringstream name;  // name of the field components
     double x, y, z;          // variable to store the value of components
 
-    /*  extract the components in the field  */
-    //  loop over point data
-    for (vtkIdType i = 0; i < numPointField; ++i) {
-        /*  get the current point data  */
-        dtOld = pointData->GetArray(i);
-        /*  extract the components  */
-        //  loop over components
-        for (vtkIdType j = 0; j < dtOld->GetNumberOfComponents(); ++j) {
-            //  initialize the temporary variable
-            dtCur = vtkDoubleArray::New();
-            dtCur->SetNumberOfComponents(1);
-            //  extract the sub components
-            for (vtkIdType k = 0; k < dtOld->GetNumberOfTuples(); ++k) {
-                dtCur->InsertNextValue(dtOld->GetTuple(k)[j]);
-            }
-            //  determine the name of the components
-            name.str("");
-            name << fieldNameList[i].toStdString() << ":"
-                 << compNameList[j].toStdString();
-            std::string arrayName;
-            arrayName.assign(name.str().data());
-            dtCur->SetName(name.str().data());
-            pointData->AddArray(dtCur);
-            //  release the temporary variable
-            dtCur->Delete();
-        }
-        /*  assign the amplitude of current field  */
+    /*  get the current point data, skip the array not loaded  */
+    dtOld = pointData->GetArray(fieldNameList[idx].toStdString().c_str());
+    if (dtOld == nullptr) return;
+
+    /*  extract the components  */
+    //  loop over components
+    for (vtkIdType j = 0; j < dtOld->GetNumberOfComponents(); ++j) {
         //  initialize the temporary variable
         dtCur = vtkDoubleArray::New();
         dtCur->SetNumberOfComponents(1);
-        //  calcualte the amplitude
-        for (vtkIdType j = 0; j < dtOld->GetNumberOfTuples(); ++j) {
-            x = dtOld->GetTuple(j)[0];
-            y = dtOld->GetTuple(j)[1];
-            z = dtOld->GetTuple(j)[2];
-            dtCur->InsertNextValue(sqrt(x * x + y * y + z * z));
+        //  extract the sub components
+        for (vtkIdType k = 0; k < dtOld->GetNumberOfTuples(); ++k) {
+            dtCur->InsertNextValue(dtOld->GetTuple(k)[j]);
         }
         //  determine the name of the components
-        name.clear();
         name.str("");
-        name << fieldNameList[i].toStdString() << ":"
-             << compNameList[3].toStdString();
-        dtCur->SetName(name.str().c_str());
+        name << fieldNameList[idx].toStdString() << ":"
+             << compNameList[j].toStdString();
+        dtCur->SetName(name.str().data());
         pointData->AddArray(dtCur);
         //  release the temporary variable
         dtCur->Delete();
+    }
+    /*  assign the amplitude of current field  */
+    //  initialize the temporary variable
+    dtCur = vtkDoubleArray::New();
+    dtCur->SetNumberOfComponents(1);
+    //  calcualte the amplitude
+    for (vtkIdType j = 0; j < dtOld->GetNumberOfTuples(); ++j) {
+        x = dtOld->GetTuple(j)[0];
+        y = dtOld->GetTuple(j)[1];
+        z = dtOld->GetTuple(j)[2];
+        dtCur->InsertNextValue(sqrt(x * x + y * y + z * z));
+    }
+    //  determine the name of the components
+    name.clear();
+    name.str("");
+    name << fieldNameList[idx].toStdString() << ":"
+         << compNameList[3].toStdString();
+    dtCur->SetName(name.str().c_str());
+    pointData->AddArray(dtCur);
+    //  release the temporary variable
+    dtCur->Delete();
+
+    /*  remove the unused point data  */
+    if (fieldNameList[idx] != "U") {
+        pointData->RemoveArray(fieldNameList[idx].toStdString().data());
+    }
+}
+
+/*  ============================================================================
+ *  requestField: load the field from the result file if it has not been
+ *  loaded, only the requested array is read by the array selection of the
+ *  reader, and then the downstream filters are refreshed
+ *  @param  idx: the index of the field in the name list
+ *  @return  true if the field is newly loaded  */
+bool Field::requestField(const int idx) {
+    /*  check the field  */
+    if (!isLazy || idx < 0 || idx >= fieldNameList.size()) return false;
+    lastUsed[idx] = QDateTime::currentMSecsSinceEpoch();
+    if (isFieldResident(idx)) return false;
+
+    /*  the array reader always reads the original result file  */
+    if (arrayReader == nullptr) {
+        arrayReader = createReader(name);
+        arrayReader->UpdateInformation();
+    }
+
+    /*  select and read the requested array only  */
+    bool isPoint      = idx < numPointField;
+    std::string array = fieldNameList[idx].toStdString();
+    getArraySelection(arrayReader, true)->DisableAllArrays();
+    getArraySelection(arrayReader, false)->DisableAllArrays();
+    getArraySelection(arrayReader, isPoint)->EnableArray(array.c_str());
+    arrayReader->Update();
+
+    /*  add the array to the ugrid  */
+    vtkDataSet* output =
+        vtkDataSet::SafeDownCast(arrayReader->GetOutputDataObject(0));
+    vtkDataArray* data = nullptr;
+    if (output != nullptr) {
+        data = isPoint ? output->GetPointData()->GetArray(array.c_str())
+                       : output->GetCellData()->GetArray(array.c_str());
+    }
+    if (data == nullptr) {
+        qDebug() << "Failed to load the field" << fieldNameList[idx];
+        return false;
+    }
+    if (isPoint) {
+        pointData->AddArray(data);
+        splitPointData(idx);
+    } else {
+        cellData->AddArray(data);
+    }
+    ugridAll->Modified();
+
+    /*  release the idle arrays and refresh the downstream filters  */
+    releaseIdleFields(idx);
+    refreshPipeline();
+    return true;
+}
+
+/*  isFieldResident: check whether the field has been loaded
+ *  @param  idx: the index of the field in the name list
+ *  @return  true if the field is in the memory  */
+bool Field::isFieldResident(const int idx) {
+    if (idx < 0 || idx >= fieldNameList.size()) return false;
+    if (idx < numPointField) {
+        QString array = fieldNameList[idx] + ":" + compNameList[3];
+        return pointData->HasArray(array.toStdString().c_str());
+    }
+    return cellData->HasArray(fieldNameList[idx].toStdString().c_str());
+}
+
+/*  setShownField: request the field that is displayed in the viewer, which is
+ *  never released as idle until another field is displayed
+ *  @param  idx: the index of the field in the name list  */
+void Field::setShownField(const int idx) {
+    idxShown = idx;
+    requestField(idx);
+}
 
-        /*  remove the unused point data  */
-        if (fieldNameList[i].toStdString() !=
-            fieldNameList[idxU].toStdString()) {
-            pointData->RemoveArray(fieldNameList[i].toStdString().data());
+/*  releaseIdleFields: remove the arrays that have not been requested for the
+ *  idle timeout, the anchors, the displayed and the requested field are
+ *  kept
+ *  @param  keep: the index of the requested field
+ *  @return  true if any array is removed  */
+bool Field::releaseIdleFields(const int keep) {
+    /*  define the temporary variables  */
+    qint64 expired = QDateTime::currentMSecsSinceEpoch() -
+                     qint64(PRENANO::FIELD_IDLE_TIMEOUT) * 1000;
+    bool isReleased = false;
+
+    /*  loop over the loaded fields  */
+    for (int i = 0; i < fieldNameList.size(); ++i) {
+        if (i == keep || i == idxShown) continue;
+        if (i == idxU || i == idxDen + numPointField) continue;
+        if (derivedList.contains(fieldNameList[i])) continue;
+        if (lastUsed[i] > expired || !isFieldResident(i)) continue;
+        std::string array = fieldNameList[i].toStdString();
+        if (i < numPointField) {
+            //  remove the components and the magnitude
+            for (const QString& comp : compNameList) {
+                QString compArray = fieldNameList[i] + ":" + comp;
+                pointData->RemoveArray(compArray.toStdString().c_str());
+            }
+        } else {
+            cellData->RemoveArray(array.c_str());
+        }
+        isReleased = true;
+    }
+
+    /*  the ugrid is modified  */
+    if (isReleased) ugridAll->Modified();
+    return isReleased;
+}
+
+/*  removeField: remove the arrays and the entry of the field
+ *  @param  idx: the index of the field in the name list  */
+void Field::removeField(const int idx) {
+    /*  remove the arrays  */
+    if (idx < numPointField) {
+        for (const QString& comp : compNameList) {
+            QString compArray = fieldNameList[idx] + ":" + comp;
+            pointData->RemoveArray(compArray.toStdString().c_str());
         }
+        numPointField--;
+    } else {
+        cellData->RemoveArray(fieldNameList[idx].toStdString().c_str());
+        numCellField--;
+    }
+
+    /*  remove the entry  */
+    derivedList.removeAll(fieldNameList[idx]);
+    fieldNameList.removeAt(idx);
+    lastUsed.removeAt(idx);
+}
+
+/*  refreshPipeline: refresh the warper and the downstream filters after the
+ *  arrays of the ugrid have been changed, the last picking is applied again */
+void Field::refreshPipeline() {
+    warp->Update();
+    denFilter->Update();
+    if (appendFilter != nullptr) cleanFilter->Update();
+    if (isPicked && pickIds != nullptr) {
+        performCellPick(pickOperate, pickModelMode, pickHideMode, pickIds);
     }
 }
 
@@ -207,11 +625,83 @@ const char* Field::getPointDataArrayName(const int& idx) {
  *  @the number of cell data  */
 int Field::getNumberOfCellData() { return numCellField; }
 
+/*  addDerivedField: add the derived array to the field, which is listed in
+ *  the name list and never released. The nodal scalar is shared by all the
+ *  components, and the nodal vector is splitted into the components and the
+ *  magnitude. The derived field with the same name is replaced
+ *  @param  label: the name of the derived field
+ *  @param  data: the derived array of each node or cell
+ *  @param  isPoint: nodal field or element field
+ *  @return  the index in the name list, -1 if the name is used by the
+ *           original fields  */
+int Field::addDerivedField(const QString& label, vtkDoubleArray* data,
+                           const bool isPoint) {
+    /*  replace the derived field with the same name  */
+    int idx = fieldNameList.indexOf(label);
+    if (idx >= 0 && !derivedList.contains(label)) return -1;
+    if (idx >= 0) removeField(idx);
+
+    /*  register the field, the nodal field is placed after the other nodal
+     *  fields and the element field is placed at the end  */
+    if (isPoint) {
+        idx = numPointField++;
+    } else {
+        idx = fieldNameList.size();
+        numCellField++;
+    }
+    fieldNameList.insert(idx, label);
+    lastUsed.insert(idx, QDateTime::currentMSecsSinceEpoch());
+    derivedList << label;
+    checkAnchor();
+
+    /*  the nodal vector is splitted as the original nodal fields  */
+    if (isPoint && data->GetNumberOfComponents() > 1) {
+        vtkDoubleArray* array = vtkDoubleArray::New();
+        array->ShallowCopy(data);
+        array->SetName(label.toStdString().c_str());
+        pointData->AddArray(array);
+        array->Delete();
+        splitPointData(idx);
+    }
+    /*  the arrays of the components share the buffer of the nodal scalar  */
+    else if (isPoint) {
+        for (const QString& comp : compNameList) {
+            QString compArray     = label + ":" + comp;
+            vtkDoubleArray* array = vtkDoubleArray::New();
+            array->ShallowCopy(data);
+            array->SetName(compArray.toStdString().c_str());
+            pointData->AddArray(array);
+            array->Delete();
+        }
+    }
+    /*  the element field  */
+    else {
+        vtkDoubleArray* array = vtkDoubleArray::New();
+        array->ShallowCopy(data);
+        array->SetName(label.toStdString().c_str());
+        cellData->AddArray(array);
+        array->Delete();
+    }
+
+    /*  refresh the downstream filters  */
+    ugridAll->Modified();
+    refreshPipeline();
+    return idx;
+}
+
+/*  isDerivedField: check whether the field is derived by the user
+ *  @param  idx: the index of the field in the name list
+ *  @return  true if the field is derived  */
+bool Field::isDerivedField(const int idx) {
+    if (idx < 0 || idx >= fieldNameList.size()) return false;
+    return derivedList.contains(fieldNameList[idx]);
+}
+
 /*  addPointData: add a new point data to the field
  *  @param  pointDataArray: the array will be added to the field  */
 void Field::addPointData(vtkDoubleArray* data) {
     //  get the data name
-    pointData = reader->GetOutput()->GetPointData();
+    pointData = ugridAll->GetPointData();
     pointData->SetScalars(data);
     //  update the anchor
     updateAnchor();
@@ -237,28 +727,15 @@ void Field::setLimits(const int& type, const double& lower,
  *  checkAnchor: check the anchor filed variable is included or not?
  *  @return  the checked status, ture for sucessed, otherwise failed  */
 bool Field::checkAnchor() {
-    /*  define the temporary varaible  */
-    int idx = 0;
-
     /*  extract the anchor of the warpping  */
-    for (idx = 0; idx < numPointField; ++idx) {
-        if (std::strcmp(pointData->GetArrayName(idx), "U") == 0) {
-            idxU = idx;
-            break;
-        }
-    }
+    idxU = fieldNameList.indexOf("U");
     /*  check the warping anchor  */
-    if (idxU >= numPointField) return false;
+    if (idxU < 0 || idxU >= numPointField) return false;
 
     /*  extract the anchor of the threshold  */
-    for (idx = 0; idx < numCellField; ++idx) {
-        if (std::strcmp(cellData->GetArrayName(idx), "Var-0") == 0) {
-            idxDen = idx;
-            break;
-        }
-    }
+    idxDen = fieldNameList.indexOf("Var-0") - numPointField;
     /*  check the threshold status  */
-    if (idxDen >= numCellField) return false;
+    if (idxDen < 0 || idxDen >= numCellField) return false;
 
     /*  return successed  */
     return true;
@@ -270,7 +747,7 @@ void Field::updateAnchor() {
     /*  update the warper  */
     warp->SetInputArrayToProcess(0, 0, 0,
                                  vtkDataObject::FIELD_ASSOCIATION_POINTS,
-                                 pointData->GetArray(idxU)->GetName());
+                                 "U");
     warp->SetInputData(ugridAll);
     warp->SetScaleFactor(warpScale);
     warp->Update();
@@ -278,16 +755,16 @@ void Field::updateAnchor() {
     /*  handle for the limit type, i.e., determine the lower and upper limit  */
     switch (limitType) {
         case 0: {
-            lowerLimit = cellData->GetArray(idxDen)->GetRange()[0];
-            upperLimit = cellData->GetArray(idxDen)->GetRange()[1];
+            lowerLimit = cellData->GetArray("Var-0")->GetRange()[0];
+            upperLimit = cellData->GetArray("Var-0")->GetRange()[1];
             break;
         }
         case 2: {
-            upperLimit = cellData->GetArray(idxDen)->GetRange()[1];
+            upperLimit = cellData->GetArray("Var-0")->GetRange()[1];
             break;
         }
         case 3: {
-            lowerLimit = cellData->GetArray(idxDen)->GetRange()[0];
+            lowerLimit = cellData->GetArray("Var-0")->GetRange()[0];
             break;
         }
     }
@@ -298,7 +775,7 @@ void Field::updateAnchor() {
     denFilter->SetInputData(warp->GetOutput());
     denFilter->SetInputArrayToProcess(0, 0, 0,
                                       vtkDataObject::FIELD_ASSOCIATION_CELLS,
-                                      cellData->GetArray(idxDen)->GetName());
+                                      cellData->GetArray("Var-0")->GetName());
     denFilter->SetLowerThreshold(lowerLimit);
     denFilter->SetUpperThreshold(upperLimit);
     denFilter->Update();
@@ -333,14 +810,32 @@ vtkUnstructuredGrid* Field::getThresholdOutput() {
  *  operation
  *  @return  the range of the point data  */
 double* Field::getPointDataRange(char* name) {
-    return denFilter->GetOutput()->GetPointData()->GetArray(name)->GetRange();
+    range->getRange(denFilter->GetOutput()->GetPointData()->GetArray(name),
+                    dataRange);
+    return dataRange;
 }
 
 /*  getCellDataRange: get the range of the point after density filter
  *  operation
  *  @return  the range of the cell data  */
 double* Field::getCellDataRange(char* name) {
-    return denFilter->GetOutput()->GetCellData()->GetArray(name)->GetRange();
+    range->getRange(denFilter->GetOutput()->GetCellData()->GetArray(name),
+                    dataRange);
+    return dataRange;
+}
+
+/*  getArrayRange: get the cached range of the array, the robust range clips
+ *  the outliers by the 1% and 99% percentiles
+ *  @param  array: the data array
+ *  @param  isClipped: whether the outliers are clipped
+ *  @return  the range of the array  */
+double* Field::getArrayRange(vtkDataArray* array, const bool isClipped) {
+    if (isClipped) {
+        range->getRobustRange(array, arrayRange);
+    } else {
+        range->getRange(array, arrayRange);
+    }
+    return arrayRange;
 }
 
 /*  ############################################################################
@@ -354,6 +849,15 @@ void Field::performCellPick(const int operateType, const bool isModelMode,
     /*  update the picking flag  */
     isPicked = true;
 
+    /*  record the picking, which is applied again after refreshing  */
+    pickOperate   = operateType;
+    pickModelMode = isModelMode;
+    pickHideMode  = isHideMode;
+    if (cellIdsCur != pickIds) {
+        if (pickIds == nullptr) pickIds = vtkIdTypeArray::New();
+        pickIds->DeepCopy(cellIdsCur);
+    }
+
     /*  handling for the model or field mode  */
     if (isModelMode) {
         //  using the model mode
@@ -447,6 +951,73 @@ vtkAlgorithmOutput* Field::getPickOutputPort() {
  *  @return  the data after the pick filter  */
 vtkUnstructuredGrid* Field::getPickOutput() { return pickFilter->GetOutput(); }
 
+/*  ############################################################################
+ *  getIsoSurfacePort: extract the iso-surface of the density, i.e., the
+ *  "Var-0" averaged at the nodes of the deformed geometry. The parallel
+ *  contour of the linear grid is used if all the cells are linear, otherwise
+ *  the general contour filter is used. Only the contour and the downstream
+ *  filters are executed again if the level is changed
+ *  @param  level: the iso-value of the density
+ *  @param  isSmoothed: smooth the iso-surface by the windowed sinc
+ *  @param  isDecimated: decimate the iso-surface by the clustering
+ *  @return  the port of the iso-surface, nullptr if no density  */
+vtkAlgorithmOutput* Field::getIsoSurfacePort(const double level,
+                                             const bool isSmoothed,
+                                             const bool isDecimated) {
+    /*  check the density  */
+    if (!checkAnchor()) return nullptr;
+
+    /*  average the density at the nodes of the deformed geometry, which is
+     *  only executed again if the warped geometry is changed  */
+    isoPoint->Update();
+
+    /*  contour the nodal density  */
+    vtkAlgorithmOutput* port = nullptr;
+    if (vtkContour3DLinearGrid::CanFullyProcessDataObject(
+            isoPoint->GetOutput(), "Var-0")) {
+        isoLinear->SetValue(0, level);
+        port = isoLinear->GetOutputPort();
+    } else {
+        contourFilter->SetValue(0, level);
+        port = contourFilter->GetOutputPort();
+    }
+
+    /*  decimate the triangles by the clustering of the vertices  */
+    if (isDecimated) {
+        isoDecimate->SetInputConnection(port);
+        port = isoDecimate->GetOutputPort();
+    }
+
+    /*  smooth the surface without shrinking  */
+    if (isSmoothed) {
+        isoSmooth->SetInputConnection(port);
+        port = isoSmooth->GetOutputPort();
+    }
+
+    /*  compute the normals for the shading  */
+    isoNormals->SetInputConnection(port);
+    isoNormals->Update();
+    return isoNormals->GetOutputPort();
+}
+
+/*  exportIsoSurface: write the last extracted iso-surface to the binary STL
+ *  file for manufacturing
+ *  @param  file: the path of the STL file
+ *  @return  the status, true for success, otherwise failed  */
+bool Field::exportIsoSurface(const QString& file) {
+    /*  check the iso-surface  */
+    if (isoNormals->GetNumberOfInputConnections(0) == 0) return false;
+
+    /*  write the triangles  */
+    vtkSTLWriter* writer = vtkSTLWriter::New();
+    writer->SetInputConnection(isoNormals->GetOutputPort());
+    writer->SetFileName(file.toStdString().c_str());
+    writer->SetFileTypeToBinary();
+    int status = writer->Write();
+    writer->Delete();
+    return status == 1;
+}
+
 /*  ############################################################################
  *  mirror: mirror the unstructured grid according to the specifed
  *  parameters
@@ -484,6 +1055,7 @@ void Field::mirror(const bool isUseAll, const bool* planes,
     transformFilter->Update();
 
     /*  merge the ugrid  */
+    if (appendFilter != nullptr) appendFilter->Delete();
     appendFilter = vtkAppendFilter::New();
     appendFilter->AddInputConnection(sourcePort);
     appendFilter->AddInputConnection(transformFilter->GetOutputPort());
@@ -521,18 +1093,148 @@ vtkDataArray* Field::getCellDataArray(const int& idx) {
     return cellData->GetArray(idx);
 }
 
+/*  getFieldArray: get the complete array of the field in the original ugrid,
+ *  the field is loaded on demand if it has not been loaded
+ *  @param  idx: the index of the field in the name list
+ *  @param  comp: the component of the nodal field
+ *  @return  the array, nullptr if it is not found  */
+vtkDataArray* Field::getFieldArray(const int idx, const int comp) {
+    /*  check the index  */
+    if (idx < 0 || idx >= fieldNameList.size()) return nullptr;
+    requestField(idx);
+
+    /*  the nodal field is splitted into the components  */
+    if (idx < numPointField) {
+        if (comp < 0 || comp >= compNameList.size()) return nullptr;
+        QString array = fieldNameList[idx] + ":" + compNameList[comp];
+        return pointData->GetArray(array.toStdString().c_str());
+    }
+    return cellData->GetArray(fieldNameList[idx].toStdString().c_str());
+}
+
+/*  getTopologyHash: get the hash of the mesh, i.e., the coordinates, the
+ *  connectivity and the types of the cells, which is computed once by hashing
+ *  the fixed chunks in parallel
+ *  @return  the hash of the mesh  */
+quint64 Field::getTopologyHash() {
+    /*  return the cached hash  */
+    if (topologyHash != 0) return topologyHash;
+
+    /*  the raw buffers of the mesh  */
+    vtkCellArray* cells     = ugridAll->GetCells();
+    vtkDataArray* arrays[4] = {ugridAll->GetPoints()->GetData(),
+                               cells->GetConnectivityArray(),
+                               cells->GetOffsetsArray(),
+                               ugridAll->GetCellTypesArray()};
+
+    /*  hash the buffers by the chunks, the chunk hashes are combined in
+     *  order so that the result does not depend on the threads  */
+    quint64 hash = FNV_OFFSET;
+    for (vtkDataArray* array : arrays) {
+        const unsigned char* bytes =
+            static_cast<const unsigned char*>(array->GetVoidPointer(0));
+        vtkIdType size =
+            array->GetNumberOfValues() * array->GetDataTypeSize();
+        vtkIdType numChunks = (size + HASH_CHUNK - 1) / HASH_CHUNK;
+        std::vector<quint64> chunks(numChunks);
+        vtkSMPTools::For(0, numChunks, [&](vtkIdType begin, vtkIdType end) {
+            for (vtkIdType i = begin; i < end; ++i) {
+                vtkIdType first = i * HASH_CHUNK;
+                vtkIdType last  = std::min(first + HASH_CHUNK, size);
+                quint64 h       = FNV_OFFSET;
+                for (vtkIdType k = first; k < last; ++k) {
+                    h = (h ^ bytes[k]) * FNV_PRIME;
+                }
+                chunks[i] = h;
+            }
+        });
+        hash = (hash ^ quint64(size)) * FNV_PRIME;
+        for (quint64 h : chunks) hash = (hash ^ h) * FNV_PRIME;
+    }
+    topologyHash = hash == 0 ? 1 : hash;
+    return topologyHash;
+}
+
+/*  getCellVolumes: get the volumes of the undeformed cells, the area is used
+ *  for the planar cells. The volumes are computed once and cached
+ *  @return  the volume array of the cells  */
+vtkDoubleArray* Field::getCellVolumes() {
+    /*  return the cached volumes  */
+    if (cellVolumes != nullptr) return cellVolumes;
+
+    /*  compute the size of the cells  */
+    vtkCellSizeFilter* size = vtkCellSizeFilter::New();
+    size->SetInputData(ugridAll);
+    size->SetComputeVertexCount(false);
+    size->SetComputeLength(false);
+    size->SetComputeSum(false);
+    size->Update();
+    vtkCellData* sizeData = size->GetOutput()->GetCellData();
+    vtkDataArray* area    = sizeData->GetArray(size->GetAreaArrayName());
+    vtkDataArray* volume  = sizeData->GetArray(size->GetVolumeArrayName());
+
+    /*  only one of the area and volume is non-zero for each cell  */
+    cellVolumes = vtkDoubleArray::New();
+    cellVolumes->SetName("CellVolume");
+    cellVolumes->SetNumberOfTuples(ugridAll->GetNumberOfCells());
+    for (vtkIdType i = 0; i < cellVolumes->GetNumberOfTuples(); ++i) {
+        double v = volume == nullptr ? 0.0 : volume->GetTuple1(i);
+        if (v == 0.0 && area != nullptr) v = area->GetTuple1(i);
+        cellVolumes->SetValue(i, std::fabs(v));
+    }
+    size->Delete();
+    return cellVolumes;
+}
+
+/*  getCellLocator: get the cell locator of the threshold output, i.e., the
+ *  displayed cells of the deformed geometry. The locator is cached and only
+ *  rebuilt after the output has been modified
+ *  @return  the locator of the threshold output  */
+vtkStaticCellLocator* Field::getCellLocator() {
+    /*  the locator checks the modified time of the data set  */
+    denFilter->Update();
+    locator->SetDataSet(denFilter->GetOutput());
+    locator->UseExistingSearchStructureOff();
+    locator->BuildLocator();
+    return locator;
+}
+
 /*  ############################################################################
  *  assignFieldNameList: determine the list of the conbo box in viewerport */
 void Field::assignFieldNameList() {
+    /*  the arrays are listed by the reader if they are loaded on demand  */
+    vtkDataArraySelection* pointSelect = getArraySelection(reader, true);
+    vtkDataArraySelection* cellSelect  = getArraySelection(reader, false);
+    if (!isLazy) {
+        pointSelect = nullptr;
+        cellSelect  = nullptr;
+    }
+
     /*  get the list of the point data  */
     fieldName.clear();
-    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i) {
-        fieldNameList << pointData->GetArrayName(i);
+    if (pointSelect != nullptr) {
+        numPointField = pointSelect->GetNumberOfArrays();
+        for (int i = 0; i < numPointField; ++i) {
+            fieldNameList << pointSelect->GetArrayName(i);
+        }
+    } else {
+        numPointField = pointData->GetNumberOfArrays();
+        for (int i = 0; i < numPointField; ++i) {
+            fieldNameList << pointData->GetArrayName(i);
+        }
     }
 
     /*  get the list of the cell data  */
-    for (int i = 0; i < cellData->GetNumberOfArrays(); ++i) {
-        fieldNameList << cellData->GetArrayName(i);
+    if (cellSelect != nullptr) {
+        numCellField = cellSelect->GetNumberOfArrays();
+        for (int i = 0; i < numCellField; ++i) {
+            fieldNameList << cellSelect->GetArrayName(i);
+        }
+    } else {
+        numCellField = cellData->GetNumberOfArrays();
+        for (int i = 0; i < numCellField; ++i) {
+            fieldNameList << cellData->GetArrayName(i);
+        }
     }
 
     /*  determine the component name  */
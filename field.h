@@ -21,19 +21,34 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkAppendFilter.h>
 #include <vtkCellData.h>
+#include <vtkCellDataToPointData.h>
+#include <vtkCellSizeFilter.h>
 #include <vtkCleanUnstructuredGrid.h>
+#include <vtkContour3DLinearGrid.h>
 #include <vtkContourFilter.h>
+#include <vtkDataArraySelection.h>
 #include <vtkDoubleArray.h>
+#include <vtkHDFReader.h>
+#include <vtkIdTypeArray.h>
 #include <vtkPointData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkQuadricClustering.h>
+#include <vtkStaticCellLocator.h>
 #include <vtkThreshold.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
+#include <vtkTrivialProducer.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkWarpVector.h>
+#include <vtkWindowedSincPolyDataFilter.h>
 #include <vtkXMLUnstructuredGridReader.h>
+#include <vtkXMLUnstructuredGridWriter.h>
 
 #include <QString>
 #include <QStringList>
+#include <QVector>
+
+#include "range.h"
 
 /*  ############################################################################
  *  CLASS Field: the class to define the filed that will have a interaction with
@@ -41,6 +56,18 @@
  *      displacement field, reaction force and so on), scalar field (material,
  *      Mises stress, design variables in Topology optimization and so on)  */
 class Field {
+public:
+    /*  Meta: the lightweight information of the field, which is kept resident
+     *  in the memory even if the vtk data of the field has been released  */
+    struct Meta {
+        QStringList fieldNameList;  // name list of the field
+        QStringList compNameList;   // name list of the components
+        QStringList derivedList;    // fields derived by the user
+        int numPointField;          // number of nodal field variables
+        int numCellField;           // number of element field variables
+        QVector<double> ranges;     // [min, max] of each field in name list
+    };
+
 private:
     QString name;                           // the name of the filed
     int numPointField;                      // number of nodal field variables
@@ -48,7 +75,13 @@ private:
 
     bool ifMeshed;                          // whether show the mesh
 
-    vtkXMLUnstructuredGridReader* reader;   // reader of the vtu file
+    vtkAlgorithm* reader;                   // reader of the vtu/pvtu file
+    bool isRead;                            // the file has been read
+    bool isLazy;                            // arrays are loaded on demand
+    vtkAlgorithm* arrayReader;              // reader of the requested arrays
+    QVector<qint64> lastUsed;               // last requested time of fields
+    int idxShown;                           // index of the displayed field
+    QStringList derivedList;                // fields derived by the user
     vtkUnstructuredGrid* ugridAll;          // grid of the FEM model
     vtkAlgorithmOutput* portAll;            // complete port of vtu file
 
@@ -67,13 +100,27 @@ private:
     double upperLimit;                      // upper limit of displayed field
     double lowerLimit;                      // lower limit of displayed field
     double dataRange[2];                    // range of the current field
+    double arrayRange[2];                   // range of the requested array
+    Range* range;                           // cached range service
+    vtkDoubleArray* cellVolumes;            // cached volumes of the cells
+    vtkStaticCellLocator* locator;          // cached locator of the cells
+    quint64 topologyHash;                   // hash of the mesh, 0 if unknown
 
     double pickValue;                       // value for picked sequence
     bool isPicked;                          // has cells been picked
     vtkThreshold* pickFilter;               // filter for picking
     vtkDataArray* pickArray;                // array for picking
+    int pickOperate;                        // source type of the last pick
+    bool pickModelMode;                     // model mode of the last pick
+    bool pickHideMode;                      // hide mode of the last pick
+    vtkIdTypeArray* pickIds;                // cells of the last pick
 
     vtkContourFilter* contourFilter;        // contour ploting object
+    vtkCellDataToPointData* isoPoint;       // nodal density for iso-surface
+    vtkContour3DLinearGrid* isoLinear;      // contour of the linear cells
+    vtkQuadricClustering* isoDecimate;      // decimation of the iso-surface
+    vtkWindowedSincPolyDataFilter* isoSmooth;  // smoothing of iso-surface
+    vtkPolyDataNormals* isoNormals;            // normals of the iso-surface
 
     vtkTransform* transform;                // stransform object
     vtkTransformFilter* transformFilter;    // filter for transforming
@@ -90,14 +137,41 @@ public:
      *  @param  name: the name of the field     */
     Field(QString& _name);
 
+    /*  constructor: reload the Field object from the binary cache file that is
+     *  written by saveCache, the derived arrays are not generated again
+     *  @param  name: the name of the field
+     *  @param  cache: the binary cache file of the field
+     *  @param  meta: the resident meta data of the field  */
+    Field(QString& _name, const QString& cache, const Meta& meta);
+
     /*  destructor: destroy the vtk related object, such as reader, ugrid, point
      *  data, cell data, port, set, warp and so on   */
     ~Field();
 
+    /*  isFieldRead: check whether the result file has been read, the field
+     *  that failed to be read has no pipeline and is only to be deleted
+     *  @return  true if the field data is read  */
+    bool isFieldRead() { return isRead; }
+
     /*  getPathName: get the full path name of the field varaible
      *  @return  the path of the current model  */
     QString& getPathName();
 
+    /*  getMeta: get the lightweight meta data of the field, i.e., the name
+     *  lists and the range of each field
+     *  @return  the meta data of the field  */
+    Meta getMeta();
+
+    /*  getMemorySize: get the memory occupied by the field data
+     *  @return  the memory size in kibibytes  */
+    qint64 getMemorySize();
+
+    /*  saveCache: write the field data to a binary file, which can be loaded
+     *  much faster than the original compressed or encoded vtu file
+     *  @param  file: the path of the binary cache file
+     *  @return  the status, true for success, otherwise failed  */
+    bool saveCache(const QString& file);
+
     /*  getInputPort: get the initial port, i.e., the input port of the field
      *  variables
      *  @return  the initial port of the field data  */
@@ -110,6 +184,23 @@ public:
     /*  initliztePointData: initialize the point data in the field  */
     void initializePointData();
 
+    /*  requestField: load the field from the result file if it has not been
+     *  loaded, only the requested array is read by the array selection of
+     *  the reader, and then the downstream filters are refreshed
+     *  @param  idx: the index of the field in the name list
+     *  @return  true if the field is newly loaded  */
+    bool requestField(const int idx);
+
+    /*  isFieldResident: check whether the field has been loaded
+     *  @param  idx: the index of the field in the name list
+     *  @return  true if the field is in the memory  */
+    bool isFieldResident(const int idx);
+
+    /*  setShownField: request the field that is displayed in the viewer,
+     *  which is never released as idle until another field is displayed
+     *  @param  idx: the index of the field in the name list  */
+    void setShownField(const int idx);
+
     /*  getNumberOfPointData: get the number of the point datas in the field
      *  @return  the number of the point data  */
     int getNumberOfPointData();
@@ -138,6 +229,24 @@ public:
      *  @the number of cell data  */
     int getNumberOfCellData();
 
+    /*  addDerivedField: add the derived array to the field, which is listed
+     *  in the name list and never released. The nodal scalar is shared by
+     *  all the components, and the nodal vector is splitted into the
+     *  components and the magnitude. The derived field with the same name is
+     *  replaced
+     *  @param  label: the name of the derived field
+     *  @param  data: the derived array of each node or cell
+     *  @param  isPoint: nodal field or element field
+     *  @return  the index in the name list, -1 if the name is used by the
+     *           original fields  */
+    int addDerivedField(const QString& label, vtkDoubleArray* data,
+                        const bool isPoint);
+
+    /*  isDerivedField: check whether the field is derived by the user
+     *  @param  idx: the index of the field in the name list
+     *  @return  true if the field is derived  */
+    bool isDerivedField(const int idx);
+
 public:
     /*  setWarpScale: set the coefficient of the warping scale
      *  @param scale: the warping scale */
@@ -182,6 +291,33 @@ public:
      *  @return  the range of the cell data  */
     double* getCellDataRange(char* name);
 
+    /*  getArrayRange: get the cached range of the array, the robust range
+     *  clips the outliers by the 1% and 99% percentiles
+     *  @param  array: the data array
+     *  @param  isClipped: whether the outliers are clipped
+     *  @return  the range of the array  */
+    double* getArrayRange(vtkDataArray* array, const bool isClipped);
+
+public:
+    /*  getIsoSurfacePort: extract the iso-surface of the density, i.e., the
+     *  "Var-0" averaged at the nodes of the deformed geometry. The parallel
+     *  contour of the linear grid is used if all the cells are linear,
+     *  otherwise the general contour filter is used. Only the contour and
+     *  the downstream filters are executed again if the level is changed
+     *  @param  level: the iso-value of the density
+     *  @param  isSmoothed: smooth the iso-surface by the windowed sinc
+     *  @param  isDecimated: decimate the iso-surface by the clustering
+     *  @return  the port of the iso-surface, nullptr if no density  */
+    vtkAlgorithmOutput* getIsoSurfacePort(const double level,
+                                          const bool isSmoothed,
+                                          const bool isDecimated);
+
+    /*  exportIsoSurface: write the last extracted iso-surface to the binary
+     *  STL file for manufacturing
+     *  @param  file: the path of the STL file
+     *  @return  the status, true for success, otherwise failed  */
+    bool exportIsoSurface(const QString& file);
+
 public:
     /*  mirror: mirror the unstructured grid according to the specifed
      *  parameters
@@ -258,7 +394,82 @@ public:
      *  @param  idx: the index of the cell data array  */
     vtkDataArray* getCellDataArray(const int& idx);
 
+    /*  getFieldArray: get the complete array of the field in the original
+     *  ugrid, the field is loaded on demand if it has not been loaded
+     *  @param  idx: the index of the field in the name list
+     *  @param  comp: the component of the nodal field
+     *  @return  the array, nullptr if it is not found  */
+    vtkDataArray* getFieldArray(const int idx, const int comp);
+
+    /*  getTopologyHash: get the hash of the mesh, i.e., the coordinates, the
+     *  connectivity and the types of the cells, which is computed once by
+     *  hashing the fixed chunks in parallel
+     *  @return  the hash of the mesh  */
+    quint64 getTopologyHash();
+
+    /*  getCellVolumes: get the volumes of the undeformed cells, the area is
+     *  used for the planar cells. The volumes are computed once and cached
+     *  @return  the volume array of the cells  */
+    vtkDoubleArray* getCellVolumes();
+
+    /*  getCellLocator: get the cell locator of the threshold output, i.e.,
+     *  the displayed cells of the deformed geometry. The locator is cached
+     *  and only rebuilt after the output has been modified
+     *  @return  the locator of the threshold output  */
+    vtkStaticCellLocator* getCellLocator();
+
 private:
+    /*  readFile: read the field data from the vtu file, or assemble it from
+     *  the pieces if the partitioned pvtu file is given
+     *  @param  file: the path of the result file
+     *  @param  isAnchorOnly: only read the anchor arrays, i.e., U and Var-0
+     *  @return  the status, true for success, otherwise failed  */
+    bool readFile(const QString& file, const bool isAnchorOnly);
+
+    /*  createReader: create the reader according to the suffix of the file,
+     *  the partitioned pvtu file has no reader
+     *  @param  file: the path of the result file
+     *  @return  the reader, nullptr for the partitioned file  */
+    vtkAlgorithm* createReader(const QString& file);
+
+    /*  isLazyFormat: check whether the arrays of the file can be loaded on
+     *  demand, i.e., the reader supports the array selection
+     *  @param  file: the path of the result file
+     *  @return  true if the arrays are loaded on demand  */
+    bool isLazyFormat(const QString& file);
+
+    /*  getArraySelection: get the array selection of the reader
+     *  @param  alg: the reader of the result file
+     *  @param  isPoint: point data or cell data
+     *  @return  the array selection, nullptr if not supported  */
+    vtkDataArraySelection* getArraySelection(vtkAlgorithm* alg,
+                                             const bool isPoint);
+
+    /*  splitPointData: split the point data into the components and the
+     *  magnitude, the original array is removed except the displacement
+     *  @param  idx: the index of the point data in the name list  */
+    void splitPointData(const int idx);
+
+    /*  releaseIdleFields: remove the arrays that have not been requested for
+     *  the idle timeout, the anchors, the displayed and the requested field
+     *  are kept
+     *  @param  keep: the index of the requested field
+     *  @return  true if any array is removed  */
+    bool releaseIdleFields(const int keep);
+
+    /*  removeField: remove the arrays and the entry of the field
+     *  @param  idx: the index of the field in the name list  */
+    void removeField(const int idx);
+
+    /*  refreshPipeline: refresh the warper and the downstream filters after
+     *  the arrays of the ugrid have been changed, the last picking is applied
+     *  again  */
+    void refreshPipeline();
+
+    /*  setupPipeline: setup the picking array, warper and filters after the
+     *  field data has been read  */
+    void setupPipeline();
+
     /*  createNodalSet: create the node set using the given node sequence or by
      *  selecting from the viewerport  */
     void createNodalSet(double*& seq);
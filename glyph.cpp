@@ -0,0 +1,276 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : glyph.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "glyph.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayRange.h>
+#include <vtkDoubleArray.h>
+#include <vtkPointData.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/*  Bin: the largest squared magnitude in the bin and the id of its node  */
+using Bin = std::pair<double, vtkIdType>;
+
+/*  ############################################################################
+ *  MaxWorker: the parallel reduction of the largest squared magnitude  */
+struct MaxWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* vectors, double& largest) {
+        vtkSMPThreadLocal<double> local(0.0);
+        vtkSMPTools::For(0, vectors->GetNumberOfTuples(),
+                         [&](vtkIdType begin, vtkIdType end) {
+                             double& m = local.Local();
+                             for (const auto tuple : vtk::DataArrayTupleRange(
+                                      vectors, begin, end)) {
+                                 double sum = 0.0;
+                                 for (const auto comp : tuple) {
+                                     sum += double(comp) * double(comp);
+                                 }
+                                 m = std::max(m, sum);
+                             }
+                         });
+        largest = 0.0;
+        for (double m : local) largest = std::max(largest, m);
+    }
+};
+
+/*  BinWorker: bin the nodes in parallel, each thread keeps the node with the
+ *  largest vector of each bin, and the threads are merged afterward  */
+struct BinWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* vectors, vtkPoints* points, const double* origin,
+                    const int* dims, const double spacing,
+                    const double threshold, std::vector<Bin>& bins) {
+        std::vector<Bin> exemplar(bins.size(), Bin(-1.0, -1));
+        vtkSMPThreadLocal<std::vector<Bin>> local(exemplar);
+        const auto coords = vtk::DataArrayTupleRange<3>(points->GetData());
+        const auto tuples = vtk::DataArrayTupleRange(vectors);
+
+        /*  bin the nodes  */
+        vtkSMPTools::For(
+            0, vectors->GetNumberOfTuples(),
+            [&](vtkIdType begin, vtkIdType end) {
+                std::vector<Bin>& b = local.Local();
+                for (vtkIdType i = begin; i < end; ++i) {
+                    //  cull the negligible vectors
+                    double sum = 0.0;
+                    for (const auto comp : tuples[i]) {
+                        sum += double(comp) * double(comp);
+                    }
+                    if (sum <= threshold) continue;
+                    //  index of the bin
+                    vtkIdType idx = 0;
+                    for (int k = 2; k >= 0; --k) {
+                        int cell = int((coords[i][k] - origin[k]) / spacing);
+                        cell     = std::clamp(cell, 0, dims[k] - 1);
+                        idx      = idx * dims[k] + cell;
+                    }
+                    if (sum > b[idx].first) b[idx] = Bin(sum, i);
+                }
+            });
+
+        /*  merge the bins of the threads  */
+        for (const std::vector<Bin>& b : local) {
+            for (size_t j = 0; j < bins.size(); ++j) {
+                if (b[j].first > bins[j].first) bins[j] = b[j];
+            }
+        }
+    }
+};
+
+/*  assemble: get the nodal vectors of the field, which is the array of three
+ *  components, or assembled from the arrays of its components named as
+ *  field:X, field:Y and field:Z
+ *  @param  pd: the point data of the surface
+ *  @param  field: the name of the field
+ *  @return  the new reference of the vectors, nullptr if not found  */
+static vtkDataArray* assemble(vtkPointData* pd, const std::string& field) {
+    vtkDataArray* array = pd->GetArray(field.c_str());
+    if (array != nullptr && array->GetNumberOfComponents() == 3) {
+        array->Register(nullptr);
+        return array;
+    }
+
+    /*  the components of the vectors  */
+    const char* axes[3] = {":X", ":Y", ":Z"};
+    vtkDataArray* comps[3];
+    for (int k = 0; k < 3; ++k) {
+        comps[k] = pd->GetArray((field + axes[k]).c_str());
+        if (comps[k] == nullptr) return nullptr;
+    }
+    vtkDoubleArray* vectors = vtkDoubleArray::New();
+    vectors->SetName(field.c_str());
+    vectors->SetNumberOfComponents(3);
+    vectors->SetNumberOfTuples(comps[0]->GetNumberOfTuples());
+    vtkSMPTools::For(0, vectors->GetNumberOfTuples(),
+                     [&](vtkIdType begin, vtkIdType end) {
+                         for (vtkIdType i = begin; i < end; ++i) {
+                             for (int k = 0; k < 3; ++k) {
+                                 vectors->SetTypedComponent(
+                                     i, k, comps[k]->GetComponent(i, 0));
+                             }
+                         }
+                     });
+    return vectors;
+}
+
+/*  ############################################################################
+ *  constructor: create the Glyph object  */
+Glyph::Glyph() {
+    surface     = vtkDataSetSurfaceFilter::New();
+    seeds       = vtkPolyData::New();
+    stamp       = 0;
+    scaleFactor = 1.0;
+}
+
+/*  destructor: destroy the Glyph object  */
+Glyph::~Glyph() {
+    seeds->Delete();
+    surface->Delete();
+}
+
+/*  ============================================================================
+ *  getSeeds: get the seeds of the arrows, which are sampled again only if the
+ *  surface of the input or the field has been changed
+ *  @param  port: the port of the displayed cells
+ *  @param  field: the name of the nodal vector field
+ *  @param  budget: the maximum number of the arrows
+ *  @param  cutoff: the culled magnitude relative to the maximum
+ *  @return  the seeds with the point data of the input  */
+vtkPolyData* Glyph::getSeeds(vtkAlgorithmOutput* port, const char* field,
+                             const int budget, const double cutoff) {
+    /*  extract the outer surface  */
+    if (surface->GetInputConnection(0, 0) != port) {
+        surface->SetInputConnection(port);
+    }
+    surface->Update();
+
+    /*  sample the surface again if it or the field has been changed  */
+    if (surface->GetOutput()->GetMTime() != stamp || name != field) {
+        name = field;
+        sample(budget, cutoff);
+        stamp = surface->GetOutput()->GetMTime();
+    }
+    return seeds;
+}
+
+/*  ============================================================================
+ *  sample: bin the nodes of the surface and keep the largest vector of each
+ *  bin
+ *  @param  budget: the maximum number of the arrows
+ *  @param  cutoff: the culled magnitude relative to the maximum  */
+void Glyph::sample(const int budget, const double cutoff) {
+    /*  clear the seeds  */
+    vtkPolyData* input    = surface->GetOutput();
+    vtkPointData* pd      = input->GetPointData();
+    vtkDataArray* vectors = assemble(pd, name);
+    seeds->Initialize();
+    scaleFactor = 1.0;
+    if (vectors == nullptr) return;
+    if (input->GetNumberOfPoints() == 0) {
+        vectors->Delete();
+        return;
+    }
+
+    /*  the bins are cubic, and only the non-degenerate axes are counted for
+     *  the planar models, so that the number of bins is about the budget  */
+    double bounds[6];
+    input->GetBounds(bounds);
+    double diagonal = input->GetLength();
+    double measure  = 1.0;
+    int numAxes     = 0;
+    for (int k = 0; k < 3; ++k) {
+        double extent = bounds[2 * k + 1] - bounds[2 * k];
+        if (extent > 1.0e-6 * diagonal) {
+            measure *= extent;
+            numAxes += 1;
+        }
+    }
+    double spacing = numAxes == 0 ? 1.0 : std::pow(measure / budget,
+                                                   1.0 / numAxes);
+    double origin[3];
+    int dims[3];
+    for (int k = 0; k < 3; ++k) {
+        double extent = bounds[2 * k + 1] - bounds[2 * k];
+        origin[k]     = bounds[2 * k];
+        dims[k]       = std::max(int(std::ceil(extent / spacing)), 1);
+    }
+
+    /*  the largest vector determines the culling and scale factor  */
+    double largest = 0.0;
+    MaxWorker maxWorker;
+    if (!vtkArrayDispatch::Dispatch::Execute(vectors, maxWorker, largest)) {
+        maxWorker(vectors, largest);
+    }
+    if (largest <= 0.0) {
+        vectors->Delete();
+        return;
+    }
+    scaleFactor = spacing / std::sqrt(largest);
+
+    /*  keep the largest vector of each bin  */
+    std::vector<Bin> bins(size_t(dims[0]) * dims[1] * dims[2], Bin(-1.0, -1));
+    double threshold = cutoff * cutoff * largest;
+    BinWorker binWorker;
+    if (!vtkArrayDispatch::Dispatch::Execute(vectors, binWorker,
+                                             input->GetPoints(), origin, dims,
+                                             spacing, threshold, bins)) {
+        binWorker(vectors, input->GetPoints(), origin, dims, spacing,
+                  threshold, bins);
+    }
+
+    /*  the rounded bins may exceed the budget, so only the largest vectors
+     *  of the occupied bins are kept  */
+    std::vector<Bin> occupied;
+    for (const Bin& bin : bins) {
+        if (bin.second >= 0) occupied.push_back(bin);
+    }
+    if (occupied.size() > size_t(budget)) {
+        std::nth_element(occupied.begin(), occupied.begin() + budget,
+                         occupied.end(), std::greater<Bin>());
+        occupied.resize(size_t(budget));
+    }
+
+    /*  copy the seeds with the point data, and the vectors of the seeds
+     *  are active so that the arrows are oriented and scaled by them  */
+    std::vector<vtkIdType> ids;
+    for (const Bin& bin : occupied) ids.push_back(bin.second);
+    std::sort(ids.begin(), ids.end());
+    vtkPoints* points      = vtkPoints::New();
+    vtkDoubleArray* arrows = vtkDoubleArray::New();
+    points->SetNumberOfPoints(vtkIdType(ids.size()));
+    arrows->SetName(name.c_str());
+    arrows->SetNumberOfComponents(3);
+    arrows->SetNumberOfTuples(vtkIdType(ids.size()));
+    seeds->GetPointData()->CopyAllocate(pd, vtkIdType(ids.size()));
+    for (size_t i = 0; i < ids.size(); ++i) {
+        points->SetPoint(vtkIdType(i), input->GetPoint(ids[i]));
+        arrows->SetTuple(vtkIdType(i), vectors->GetTuple(ids[i]));
+        seeds->GetPointData()->CopyData(pd, ids[i], vtkIdType(i));
+    }
+    seeds->SetPoints(points);
+    seeds->GetPointData()->SetVectors(arrows);
+    points->Delete();
+    arrows->Delete();
+    vectors->Delete();
+}
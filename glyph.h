@@ -0,0 +1,73 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : glyph.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef GLYPH_H
+#define GLYPH_H
+
+#include <vtkAlgorithmOutput.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkPolyData.h>
+
+#include <string>
+
+/*  ############################################################################
+ *  class Glyph: the seeds of the arrows in the arrow field. Only the nodes on
+ *      the outer surface are seeded, and they are binned into a uniform grid
+ *      whose number of bins is limited by the budget. The node with the
+ *      largest vector in each bin is kept, and the nodes with a negligible
+ *      vector are culled, so that the number of arrows is bounded regardless
+ *      of the size of the mesh. The scale factor is chosen so that the
+ *      longest arrow fills a bin. The vectors are the nodal array of the
+ *      field, or assembled from the arrays of its components, and they are
+ *      the active vectors of the seeds.  */
+class Glyph {
+private:
+    vtkDataSetSurfaceFilter* surface;  // outer surface of the cells
+    vtkPolyData* seeds;                // decimated seeds of the arrows
+    vtkMTimeType stamp;                // modification time of the surface
+    std::string name;                  // name of the sampled field
+    double scaleFactor;                // scale factor of the arrows
+
+public:
+    /*  ########################################################################
+     *  constructor: create the Glyph object  */
+    Glyph();
+
+    /*  destructor: destroy the Glyph object  */
+    ~Glyph();
+
+    /*  getSeeds: get the seeds of the arrows, which are sampled again only
+     *  if the surface of the input or the field has been changed
+     *  @param  port: the port of the displayed cells
+     *  @param  field: the name of the nodal vector field
+     *  @param  budget: the maximum number of the arrows
+     *  @param  cutoff: the culled magnitude relative to the maximum
+     *  @return  the seeds with the point data of the input  */
+    vtkPolyData* getSeeds(vtkAlgorithmOutput* port, const char* field,
+                          const int budget, const double cutoff);
+
+    /*  getScaleFactor: get the scale factor of the arrows, the longest
+     *  arrow is as long as the bin
+     *  @return  the scale factor  */
+    double getScaleFactor() { return scaleFactor; }
+
+private:
+    /*  sample: bin the nodes of the surface and keep the largest vector of
+     *  each bin
+     *  @param  budget: the maximum number of the arrows
+     *  @param  cutoff: the culled magnitude relative to the maximum  */
+    void sample(const int budget, const double cutoff);
+};
+#endif  // GLYPH_H
@@ -0,0 +1,100 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : iso.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "iso.h"
+
+#include <QFileDialog>
+#include <QSignalBlocker>
+
+#include "ui_iso.h"
+
+/*  number of the steps of the level slider  */
+static const int SLIDER_STEPS = 1000;
+
+/*  ############################################################################
+ *  constructor: create the Iso object  */
+Iso::Iso(QWidget* parent) : QDialog(parent), ui(new Ui::Iso) {
+    /*  setup the UI interface  */
+    ui->setupUi(this);
+    setRange(0.0, 1.0);
+    ui->level->setValue(0.5);
+
+    /*  connect to the CLOSE button  */
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+
+    /*  connect the level and the slider  */
+    connect(ui->level, &QDoubleSpinBox::valueChanged, this, [&](double value) {
+        QSignalBlocker blocker(ui->levelSlider);
+        double span  = range[1] - range[0];
+        double ratio = span > 0.0 ? (value - range[0]) / span : 0.0;
+        ui->levelSlider->setValue(qRound(ratio * SLIDER_STEPS));
+        emit changed();
+    });
+    connect(ui->levelSlider, &QSlider::valueChanged, this, [&](int step) {
+        double ratio = double(step) / SLIDER_STEPS;
+        ui->level->setValue(range[0] + ratio * (range[1] - range[0]));
+    });
+
+    /*  connect the options  */
+    connect(ui->useSmooth, &QCheckBox::toggled, this, &Iso::changed);
+    connect(ui->useDecimate, &QCheckBox::toggled, this, &Iso::changed);
+
+    /*  connect to the EXPORT button  */
+    connect(ui->btnExport, &QPushButton::clicked, this, [&]() {
+        QString file = QFileDialog::getSaveFileName(
+            this, "Export the iso-surface", "", "STL files (*.stl)");
+        if (file.isEmpty()) return;
+        if (!file.endsWith(".stl", Qt::CaseInsensitive)) file += ".stl";
+        emit exported(file);
+    });
+}
+
+/*  destructor: destroy the Iso object  */
+Iso::~Iso() { delete ui; }
+
+/*  ============================================================================
+ *  setRange: set the range of the density for the level
+ *  @param  lower: the lower limit of the density
+ *  @param  upper: the upper limit of the density  */
+void Iso::setRange(const double lower, const double upper) {
+    range[0] = lower;
+    range[1] = upper;
+
+    /*  keep the level in the range without updating the iso-surface  */
+    QSignalBlocker blocker(ui->level);
+    double value = ui->level->value();
+    ui->level->setRange(lower, upper);
+    ui->level->setSingleStep((upper - lower) / 100.0);
+    ui->level->setValue(qBound(lower, value, upper));
+    double span  = upper - lower;
+    double ratio = span > 0.0 ? (ui->level->value() - lower) / span : 0.0;
+    QSignalBlocker sliderBlocker(ui->levelSlider);
+    ui->levelSlider->setValue(qRound(ratio * SLIDER_STEPS));
+}
+
+/*  ============================================================================
+ *  getLevel: get the iso-value of the density
+ *  @return  the iso-value  */
+double Iso::getLevel() { return ui->level->value(); }
+
+/*  ============================================================================
+ *  isUseSmooth: smooth the iso-surface or not
+ *  @return  the flag of the smoothing  */
+bool Iso::isUseSmooth() { return ui->useSmooth->isChecked(); }
+
+/*  ============================================================================
+ *  isUseDecimate: decimate the iso-surface or not
+ *  @return  the flag of the decimation  */
+bool Iso::isUseDecimate() { return ui->useDecimate->isChecked(); }
@@ -0,0 +1,70 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : iso.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef ISO_H
+#define ISO_H
+
+#include <QDialog>
+
+namespace Ui {
+class Iso;
+}
+
+/*  ############################################################################
+ *  class Iso: the dialog to configure the iso-surface of the density in the
+ *      topology optimization. The iso-surface is extracted again whenever the
+ *      level or the options are changed, and it can be exported to the STL
+ *      file for manufacturing.  */
+class Iso : public QDialog {
+    Q_OBJECT
+
+private:
+    Ui::Iso* ui;       // UI interface
+    double range[2];   // range of the density
+
+public:
+    /*  ########################################################################
+     *  constructor: create the Iso object  */
+    explicit Iso(QWidget* parent = nullptr);
+
+    /*  destructor: destroy the Iso object  */
+    ~Iso();
+
+    /*  setRange: set the range of the density for the level
+     *  @param  lower: the lower limit of the density
+     *  @param  upper: the upper limit of the density  */
+    void setRange(const double lower, const double upper);
+
+    /*  getLevel: get the iso-value of the density
+     *  @return  the iso-value  */
+    double getLevel();
+
+    /*  isUseSmooth: smooth the iso-surface or not
+     *  @return  the flag of the smoothing  */
+    bool isUseSmooth();
+
+    /*  isUseDecimate: decimate the iso-surface or not
+     *  @return  the flag of the decimation  */
+    bool isUseDecimate();
+
+signals:
+    /*  changed: the level or the options of the iso-surface are changed  */
+    void changed();
+
+    /*  exported: the STL file of the iso-surface is selected
+     *  @param  file: the path of the STL file  */
+    void exported(const QString& file);
+};
+#endif  // ISO_H
@@ -0,0 +1,417 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : library.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "library.h"
+
+#include <QDir>
+#include <QDoubleValidator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <algorithm>
+
+#include "ui_library.h"
+
+/*  name of the connection and the library file  */
+static const QString CONNECTION   = "LIBRARY";
+static const QString LIBRARY_FILE = "materials.db";
+
+/*  columns of the material, the name is the first  */
+static const QStringList COLUMNS = {
+    "name",        "category",       "description",
+    "density",     "linear_modulus", "linear_poisson",
+    "neo_modulus", "neo_poisson",    "expansion",
+    "conduction"};
+
+/*  migrations of the library, which is versioned apart from the projects, the
+ *  names are case insensitive so that the prefix search is answered by the
+ *  unique index  */
+static const QList<QStringList> MIGRATIONS = {{
+    //  1: the materials and the indexes of the filters
+    "CREATE TABLE IF NOT EXISTS library ("
+    "id INTEGER PRIMARY KEY, "
+    "name TEXT NOT NULL UNIQUE COLLATE NOCASE, "
+    "category TEXT NOT NULL DEFAULT '', "
+    "description TEXT, "
+    "density REAL, "
+    "linear_modulus REAL, "
+    "linear_poisson REAL, "
+    "neo_modulus REAL, "
+    "neo_poisson REAL, "
+    "expansion REAL, "
+    "conduction REAL)",
+    "CREATE INDEX IF NOT EXISTS library_category ON library(category, name)",
+    "CREATE INDEX IF NOT EXISTS library_density ON library(density)",
+    "CREATE INDEX IF NOT EXISTS library_modulus ON library(linear_modulus)",
+    "CREATE INDEX IF NOT EXISTS library_poisson ON library(linear_poisson)",
+    "CREATE INDEX IF NOT EXISTS library_expansion ON library(expansion)",
+    "CREATE INDEX IF NOT EXISTS library_conduction ON library(conduction)"}};
+
+/*  upsert of the imported material  */
+static const QString UPSERT =
+    "INSERT INTO library (name, category, description, density, "
+    "linear_modulus, linear_poisson, neo_modulus, neo_poisson, expansion, "
+    "conduction) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(name) DO UPDATE SET category = excluded.category, "
+    "description = excluded.description, density = excluded.density, "
+    "linear_modulus = excluded.linear_modulus, "
+    "linear_poisson = excluded.linear_poisson, "
+    "neo_modulus = excluded.neo_modulus, neo_poisson = excluded.neo_poisson, "
+    "expansion = excluded.expansion, conduction = excluded.conduction";
+
+/*  ############################################################################
+ *  normalize: get the column of the header in the imported file, e.g.,
+ *  "Linear Modulus" is the column linear_modulus  */
+static QString normalize(const QString& key) {
+    return key.trimmed().toLower().replace(' ', '_');
+}
+
+/*  escapeLike: escape the wildcards of the LIKE pattern with the backslash  */
+static QString escapeLike(QString text) {
+    text.replace('\\', "\\\\");
+    text.replace('%', "\\%");
+    return text.replace('_', "\\_");
+}
+
+/*  splitCsv: split the line of the CSV file, the fields can be quoted  */
+static QStringList splitCsv(const QString& line) {
+    QStringList fields;
+    QString field;
+    bool isQuoted = false;
+    for (qsizetype i = 0; i < line.size(); ++i) {
+        QChar c = line[i];
+        if (isQuoted) {
+            //  the doubled quote is a quote in the field
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                field += c;
+                ++i;
+            } else if (c == '"') {
+                isQuoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            isQuoted = true;
+        } else if (c == ',') {
+            fields << field.trimmed();
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field.trimmed();
+    return fields;
+}
+
+/*  ############################################################################
+ *  constructor: open the library file and show all the materials  */
+Library::Library(QWidget* parent) : QDialog(parent), ui(new Ui::Library) {
+    ui->setupUi(this);
+
+    //  the property filter and its bounds
+    properties = {"density", "linear_modulus", "linear_poisson", "expansion",
+                  "conduction"};
+    ui->minimum->setValidator(new QDoubleValidator(this));
+    ui->maximum->setValidator(new QDoubleValidator(this));
+
+    //  the table fetches the result while it is scrolled
+    result = new QSqlQueryModel(this);
+    ui->table->setModel(result);
+
+    //  the library is shared by all the projects
+    QString dir =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    database = new Database(CONNECTION, MIGRATIONS);
+    if (open(dir + "/" + LIBRARY_FILE)) {
+        updateCategories();
+        search();
+    }
+
+    //  the filters
+    connect(ui->name, &QLineEdit::textChanged, this, &Library::search);
+    connect(ui->category, &QComboBox::currentIndexChanged, this,
+            &Library::search);
+    connect(ui->property, &QComboBox::currentIndexChanged, this,
+            &Library::search);
+    connect(ui->minimum, &QLineEdit::editingFinished, this, &Library::search);
+    connect(ui->maximum, &QLineEdit::editingFinished, this, &Library::search);
+
+    //  the buttons
+    connect(ui->btnImport, &QPushButton::clicked, this, &Library::openFile);
+    connect(ui->btnAdd, &QPushButton::clicked, this, &Library::addSelected);
+    connect(ui->table, &QTableView::doubleClicked, this,
+            &Library::addSelected);
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: close the library file  */
+Library::~Library() {
+    delete ui;
+    //  the result holds the statement on the connection
+    result->clear();
+    delete database;
+}
+
+/*  ############################################################################
+ *  importFile: import the materials from the CSV or JSON file in one
+ *  transaction, the materials of the same name are updated
+ *  @param  file: the path of the CSV or JSON file
+ *  @param  error: the error message if failed
+ *  @return  the number of the imported materials, -1 if failed  */
+int Library::importFile(const QString& file, QString& error) {
+    if (!database->isOpen()) {
+        error = "The material library is not opened.";
+        return -1;
+    }
+
+    /*  read the materials  */
+    QVector<QVariantMap> materials;
+    bool status = file.endsWith(".json", Qt::CaseInsensitive)
+                      ? readJson(file, materials)
+                      : readCsv(file, materials);
+    if (!status) {
+        error = "Failed to read " + file;
+        return -1;
+    }
+
+    /*  write them in one transaction with the statement bound again  */
+    result->clear();
+    if (!database->begin()) {
+        error = database->getError();
+        return -1;
+    }
+    int numImported = 0;
+    for (const QVariantMap& material : materials) {
+        QString name = material.value("name").toString().trimmed();
+        if (name.isEmpty()) continue;
+        QVariantList values = {name,
+                               material.value("category").toString().trimmed(),
+                               material.value("description").toString()};
+        //  the missing properties are stored as NULL
+        for (int i = 3; i < COLUMNS.size(); ++i) {
+            bool ok      = false;
+            double value = material.value(COLUMNS[i]).toDouble(&ok);
+            values << (ok ? QVariant(value) : QVariant());
+        }
+        if (!database->exec(UPSERT, values)) {
+            error = database->getError();
+            database->rollback();
+            return -1;
+        }
+        ++numImported;
+    }
+    if (!database->commit()) {
+        error = database->getError();
+        return -1;
+    }
+    return numImported;
+}
+
+/*  ############################################################################
+ *  search: query the materials by the filters of the dialog  */
+void Library::search() {
+    if (!database->isOpen()) return;
+
+    /*  the filters, the wildcards in the name are matched literally  */
+    QStringList where;
+    QVariantList values;
+    if (!ui->name->text().isEmpty()) {
+        where << "name LIKE ? ESCAPE '\\'";
+        values << escapeLike(ui->name->text()) + "%";
+    }
+    if (ui->category->currentIndex() > 0) {
+        where << "category = ?";
+        values << ui->category->currentText();
+    }
+    QString column = properties[ui->property->currentIndex()];
+    bool ok        = false;
+    double bound   = ui->minimum->text().toDouble(&ok);
+    if (ok) {
+        where << column + " >= ?";
+        values << bound;
+    }
+    bound = ui->maximum->text().toDouble(&ok);
+    if (ok) {
+        where << column + " <= ?";
+        values << bound;
+    }
+
+    /*  the query  */
+    QString sql =
+        "SELECT id, name, category, density, linear_modulus, linear_poisson, "
+        "expansion, conduction FROM library";
+    if (!where.isEmpty()) sql += " WHERE " + where.join(" AND ");
+    sql += " ORDER BY name";
+    QSqlQuery query = database->query(sql, values);
+    if (!query.isActive()) {
+        ui->status->setText(database->getError());
+        return;
+    }
+
+    /*  only the visible rows are fetched  */
+    result->setQuery(std::move(query));
+    QStringList headers = {"Id",        "Name",       "Category",
+                           "Density",   "Modulus",    "Poisson's Ratio",
+                           "Expansion", "Conduction"};
+    for (int i = 0; i < headers.size(); ++i) {
+        result->setHeaderData(i, Qt::Horizontal, headers[i]);
+    }
+    ui->table->hideColumn(0);
+    ui->status->setText(QString("%1%2 materials found")
+                            .arg(result->rowCount())
+                            .arg(result->canFetchMore() ? "+" : ""));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  openFile: select the CSV or JSON file and import it  */
+void Library::openFile() {
+    QString name = QFileDialog::getOpenFileName(
+        this, "Import the materials", "", "Material files (*.csv *.json)");
+    if (name.isEmpty()) return;
+
+    QElapsedTimer clock;
+    clock.start();
+    QString error;
+    int numImported = importFile(name, error);
+    if (numImported < 0) {
+        ui->status->setText(error);
+        search();
+        return;
+    }
+    updateCategories();
+    search();
+    ui->status->setText(QString("Imported %1 materials in %2 ms")
+                            .arg(numImported)
+                            .arg(clock.elapsed()));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  addSelected: add the selected materials to the project  */
+void Library::addSelected() {
+    QString sql = "SELECT " + COLUMNS.join(", ") + " FROM library WHERE id = ?";
+    int numAdded = 0;
+    for (const QModelIndex& row : ui->table->selectionModel()->selectedRows()) {
+        QSqlQuery* query = database->select(sql, {result->data(row)});
+        if (query == nullptr) continue;
+        if (query->next()) {
+            QVariantMap material;
+            for (int i = 0; i < COLUMNS.size(); ++i) {
+                material[COLUMNS[i]] = query->value(i);
+            }
+            emit added(material);
+            ++numAdded;
+        }
+        query->finish();
+    }
+    ui->status->setText(
+        QString("Added %1 materials to the project").arg(numAdded));
+}
+
+/*  ############################################################################
+ *  open: open the library file and create the tables and indexes
+ *  @param  file: the path of the library file
+ *  @return  the status, true for success, otherwise failed  */
+bool Library::open(const QString& file) {
+    if (database->open(file)) return true;
+    ui->status->setText("Failed to open the material library " +
+                        database->getError());
+    return false;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  updateCategories: list the categories in the category filter  */
+void Library::updateCategories() {
+    QString current = ui->category->currentText();
+    ui->category->blockSignals(true);
+    ui->category->clear();
+    ui->category->addItem("All");
+    QSqlQuery* query = database->select(
+        "SELECT DISTINCT category FROM library WHERE category != '' "
+        "ORDER BY category");
+    if (query != nullptr) {
+        while (query->next()) ui->category->addItem(query->value(0).toString());
+        query->finish();
+    }
+    ui->category->setCurrentIndex(
+        std::max(0, ui->category->findText(current)));
+    ui->category->blockSignals(false);
+}
+
+/*  ############################################################################
+ *  readCsv: read the materials from the CSV file, the first line names the
+ *  columns
+ *  @param  file: the path of the CSV file
+ *  @param  materials: the materials read from the file
+ *  @return  the status, true for success, otherwise failed  */
+bool Library::readCsv(const QString& file, QVector<QVariantMap>& materials) {
+    QFile input(file);
+    if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    QTextStream in(&input);
+
+    /*  the header  */
+    QStringList header;
+    for (const QString& key : splitCsv(in.readLine())) {
+        header << normalize(key);
+    }
+    if (!header.contains("name")) return false;
+
+    /*  the materials  */
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        if (line.trimmed().isEmpty()) continue;
+        QStringList fields = splitCsv(line);
+        QVariantMap material;
+        for (qsizetype i = 0; i < std::min(header.size(), fields.size()); ++i) {
+            material[header[i]] = fields[i];
+        }
+        materials.append(material);
+    }
+    return true;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  readJson: read the materials from the JSON file, which is an array of the
+ *  objects or an object with the "materials" array
+ *  @param  file: the path of the JSON file
+ *  @param  materials: the materials read from the file
+ *  @return  the status, true for success, otherwise failed  */
+bool Library::readJson(const QString& file, QVector<QVariantMap>& materials) {
+    QFile input(file);
+    if (!input.open(QIODevice::ReadOnly)) return false;
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(input.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) return false;
+
+    QJsonArray array = document.isObject()
+                           ? document.object().value("materials").toArray()
+                           : document.array();
+    materials.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        QJsonObject object = value.toObject();
+        QVariantMap material;
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            material[normalize(it.key())] = it.value().toVariant();
+        }
+        materials.append(material);
+    }
+    return true;
+}
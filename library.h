@@ -0,0 +1,102 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : library.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef LIBRARY_H
+#define LIBRARY_H
+
+#include <QDialog>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QtSql/QSqlQueryModel>
+
+#include "database.h"
+
+namespace Ui {
+class Library;
+}
+
+/*  ############################################################################
+ *  class Library: the material library shared by all the projects, which is
+ *      one SQLite file in the application data. The materials are indexed by
+ *      the name, the category and the main property values, so the filtered
+ *      search is answered by the indexes, and the result is fetched lazily
+ *      by the table view while it is scrolled. The materials are imported
+ *      from the CSV or JSON files in one transaction.  */
+class Library : public QDialog {
+    Q_OBJECT
+
+private:
+    Ui::Library* ui;          // UI interface
+    Database* database;       // connection of the library file
+    QSqlQueryModel* result;   // lazily fetched search result
+    QStringList properties;   // columns of the property filter
+
+public:
+    /*  ########################################################################
+     *  constructor: open the library file and show all the materials  */
+    explicit Library(QWidget* parent = nullptr);
+
+    /*  destructor: close the library file  */
+    ~Library();
+
+    /*  importFile: import the materials from the CSV or JSON file in one
+     *  transaction, the materials of the same name are updated
+     *  @param  file: the path of the CSV or JSON file
+     *  @param  error: the error message if failed
+     *  @return  the number of the imported materials, -1 if failed  */
+    int importFile(const QString& file, QString& error);
+
+signals:
+    /*  added: the library material is added to the project
+     *  @param  material: the columns of the material by their names  */
+    void added(const QVariantMap& material);
+
+private slots:
+    /*  ########################################################################
+     *  search: query the materials by the filters of the dialog  */
+    void search();
+
+    /*  openFile: select the CSV or JSON file and import it  */
+    void openFile();
+
+    /*  addSelected: add the selected materials to the project  */
+    void addSelected();
+
+private:
+    /*  ########################################################################
+     *  open: open the library file and create the tables and indexes
+     *  @param  file: the path of the library file
+     *  @return  the status, true for success, otherwise failed  */
+    bool open(const QString& file);
+
+    /*  updateCategories: list the categories in the category filter  */
+    void updateCategories();
+
+    /*  readCsv: read the materials from the CSV file, the first line names
+     *  the columns
+     *  @param  file: the path of the CSV file
+     *  @param  materials: the materials read from the file
+     *  @return  the status, true for success, otherwise failed  */
+    bool readCsv(const QString& file, QVector<QVariantMap>& materials);
+
+    /*  readJson: read the materials from the JSON file, which is an array of
+     *  the objects or an object with the "materials" array
+     *  @param  file: the path of the JSON file
+     *  @param  materials: the materials read from the file
+     *  @return  the status, true for success, otherwise failed  */
+    bool readJson(const QString& file, QVector<QVariantMap>& materials);
+};
+#endif  // LIBRARY_H
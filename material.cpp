@@ -15,8 +15,27 @@
  *  */
 #include "material.h"
 
+#include <QUuid>
+
 #include "ui_material.h"
 
+/*  upsert of the material  */
+static const QString MATERIAL_UPSERT =
+    "INSERT INTO materials (uid, name, description, density, density_flag, "
+    "linear_modulus, linear_poisson, linear_flag, neo_modulus, neo_poisson, "
+    "neo_flag, expansion, expansion_flag, conduction, conduction_flag) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(uid) DO UPDATE SET name = excluded.name, "
+    "description = excluded.description, density = excluded.density, "
+    "density_flag = excluded.density_flag, "
+    "linear_modulus = excluded.linear_modulus, "
+    "linear_poisson = excluded.linear_poisson, "
+    "linear_flag = excluded.linear_flag, neo_modulus = excluded.neo_modulus, "
+    "neo_poisson = excluded.neo_poisson, neo_flag = excluded.neo_flag, "
+    "expansion = excluded.expansion, expansion_flag = excluded.expansion_flag, "
+    "conduction = excluded.conduction, "
+    "conduction_flag = excluded.conduction_flag";
+
 /*  ############################################################################
  *  constructor:
     create the mateiral creation dialog  */
@@ -38,8 +57,9 @@ Material::Material(QWidget* parent) : QDialog(parent), ui(new Ui::Material) {
     validator = new QDoubleValidator(this);
 
     //  create the new material property
-    index  = 0;
-    proNew = new Property(index);
+    index    = 0;
+    proNew   = new Property(index);
+    database = nullptr;
 
     //  create listview model
     setupMatProListview();
@@ -415,6 +435,7 @@ void Material::edit(int idx) {
     //  get the current property
     item   = itemModel->item(idx, 0);
     proOld = item->data(Qt::UserRole).value<Property*>();
+    hydrate(proOld);
 
     //  clean the items
     itemPro->clear();
@@ -538,6 +559,7 @@ void Material::saveMaterial() {
     } else {
         proCur->expan->flag[0] = 0;
     }
+    proCur->isDirty = true;
 
     //  update the model name if in edit mode
     if (editmode) {
@@ -574,6 +596,7 @@ void Material::remove(int idx) {
         item = itemModel->item(idx, 0);
         //  get the current model property in edit
         proOld = item->data(Qt::UserRole).value<Property*>();
+        removedList << proOld->uid;
         //  remove the item from the list view
         itemModel->removeRow(idx);
         //  remove the property object
@@ -639,7 +662,8 @@ void Material::getNewName() {
     //  set the new name of the model
     QString text;
     rename->getNameNew(text);
-    proOld->name = text;
+    proOld->name    = text;
+    proOld->isDirty = true;
     //  update the name of the current item
     item->setText(text);
     //  rest the pointer
@@ -798,6 +822,181 @@ void Material::showEvent(QShowEvent* event) {
     QDialog::showEvent(event);
 }
 
+/*  ############################################################################
+ *  snapshot: append the deleted and the changed materials to the snapshot of
+ *  the project, and clear their dirty flags
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write all the materials rather than the changed ones  */
+void Material::snapshot(QVector<Autosave::Record>& records, const bool isFull) {
+    //  the deleted materials
+    for (const QString& uid : removedList) {
+        records.append({"DELETE FROM materials WHERE uid = ?", {uid}});
+    }
+    removedList.clear();
+    //  iterate through all items in the list view
+    for (int i = 0; i < itemModel->rowCount(); ++i) {
+        Property* pro =
+            itemModel->item(i, 0)->data(Qt::UserRole).value<Property*>();
+        if (!isFull && !pro->isDirty) continue;
+        //  another file needs the properties of all the materials
+        if (isFull) hydrate(pro);
+        pro->isDirty = false;
+        //  only the name of the unloaded material can be changed
+        if (!pro->isLoaded) {
+            records.append({"UPDATE materials SET name = ? WHERE uid = ?",
+                            {pro->name, pro->uid}});
+            continue;
+        }
+        records.append(
+            {MATERIAL_UPSERT,
+             {pro->uid, pro->name, pro->descrip, pro->den->data[0],
+              pro->den->flag[0], pro->linear->data[0], pro->linear->data[1],
+              pro->linear->flag[0], pro->neo->data[0], pro->neo->data[1],
+              pro->neo->flag[0], pro->expan->data[0], pro->expan->flag[0],
+              pro->conduct->data[0], pro->conduct->flag[0]}});
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  loadProjectDatabase: replace the materials by those in the project file,
+ *  only the names are read and the properties are fetched on their first use
+ *  @param  database: the database of the project  */
+void Material::loadProjectDatabase(Database* database) {
+    this->database = database;
+    //  remove the current materials
+    while (itemModel->rowCount() > 0) {
+        item = itemModel->item(0, 0);
+        delete item->data(Qt::UserRole).value<Property*>();
+        itemModel->removeRow(0);
+    }
+    removedList.clear();
+
+    //  the names of the materials in the order of creation
+    QSqlQuery* query =
+        database->select("SELECT uid, name FROM materials ORDER BY rowid");
+    while (query != nullptr && query->next()) {
+        ++index;
+        proCur           = new Property(index);
+        proCur->uid      = query->value(0).toString();
+        proCur->name     = query->value(1).toString();
+        proCur->assigned = true;
+        proCur->isDirty  = false;
+        proCur->isLoaded = false;
+        //  add the material to the list view
+        item = new QStandardItem(proCur->name);
+        item->setData(QVariant::fromValue(proCur), Qt::UserRole);
+        itemModel->appendRow(item);
+    }
+    if (query != nullptr) query->finish();
+    item   = nullptr;
+    proCur = nullptr;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  append: append the material from the material library to the project, the
+ *  missing properties of the library material are not assigned
+ *  @param  material: the columns of the library material by their names  */
+void Material::append(const QVariantMap& material) {
+    ++index;
+    proCur          = new Property(index);
+    proCur->name    = material.value("name").toString();
+    proCur->descrip = material.value("description").toString();
+
+    //  the properties and their assignment
+    proCur->den->data[0]     = material.value("density").toDouble();
+    proCur->linear->data[0]  = material.value("linear_modulus").toDouble();
+    proCur->linear->data[1]  = material.value("linear_poisson").toDouble();
+    proCur->neo->data[0]     = material.value("neo_modulus").toDouble();
+    proCur->neo->data[1]     = material.value("neo_poisson").toDouble();
+    proCur->expan->data[0]   = material.value("expansion").toDouble();
+    proCur->conduct->data[0] = material.value("conduction").toDouble();
+    proCur->den->updateAssign(!material.value("density").isNull());
+    proCur->linear->updateAssign(!material.value("linear_modulus").isNull());
+    proCur->neo->updateAssign(!material.value("neo_modulus").isNull());
+    proCur->expan->updateAssign(!material.value("expansion").isNull());
+    proCur->conduct->updateAssign(!material.value("conduction").isNull());
+    proCur->den->flag[0]     = 0;
+    proCur->linear->flag[0]  = 0;
+    proCur->neo->flag[0]     = 0;
+    proCur->expan->flag[0]   = proCur->expan->assigned ? 1 : 0;
+    proCur->conduct->flag[0] = proCur->conduct->assigned ? 1 : 0;
+    proCur->assigned         = true;
+
+    //  add the material to the list view
+    item = new QStandardItem(proCur->name);
+    item->setData(QVariant::fromValue(proCur), Qt::UserRole);
+    itemModel->appendRow(item);
+    item   = nullptr;
+    proCur = nullptr;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getMaterials: get the assigned properties of all the materials, which are
+ *  fetched from the project file if they are not loaded
+ *  @return  the columns of the materials by their names as the library, the
+ *           unassigned properties are absent  */
+QVector<QVariantMap> Material::getMaterials() {
+    QVector<QVariantMap> materials;
+    for (int i = 0; i < itemModel->rowCount(); ++i) {
+        Property* pro =
+            itemModel->item(i, 0)->data(Qt::UserRole).value<Property*>();
+        hydrate(pro);
+        QVariantMap material = {{"name", pro->name}};
+        if (pro->den->assigned) material["density"] = pro->den->data[0];
+        if (pro->linear->assigned) {
+            material["linear_modulus"] = pro->linear->data[0];
+            material["linear_poisson"] = pro->linear->data[1];
+        }
+        if (pro->neo->assigned) {
+            material["neo_modulus"] = pro->neo->data[0];
+            material["neo_poisson"] = pro->neo->data[1];
+        }
+        if (pro->expan->assigned) material["expansion"] = pro->expan->data[0];
+        if (pro->conduct->assigned) {
+            material["conduction"] = pro->conduct->data[0];
+        }
+        materials.append(material);
+    }
+    return materials;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  hydrate: fetch the properties of the material from the project file on its
+ *  first use, only the names are read when the project is opened
+ *  @param  pro: the material property  */
+void Material::hydrate(Property* pro) {
+    if (pro->isLoaded || database == nullptr) return;
+    QSqlQuery* query = database->select(
+        "SELECT description, density, density_flag, linear_modulus, "
+        "linear_poisson, linear_flag, neo_modulus, neo_poisson, neo_flag, "
+        "expansion, expansion_flag, conduction, conduction_flag "
+        "FROM materials WHERE uid = ?",
+        {pro->uid});
+    if (query != nullptr && query->next()) {
+        pro->descrip          = query->value(0).toString();
+        pro->den->data[0]     = query->value(1).toDouble();
+        pro->den->flag[0]     = query->value(2).toInt();
+        pro->linear->data[0]  = query->value(3).toDouble();
+        pro->linear->data[1]  = query->value(4).toDouble();
+        pro->linear->flag[0]  = query->value(5).toInt();
+        pro->neo->data[0]     = query->value(6).toDouble();
+        pro->neo->data[1]     = query->value(7).toDouble();
+        pro->neo->flag[0]     = query->value(8).toInt();
+        pro->expan->data[0]   = query->value(9).toDouble();
+        pro->expan->flag[0]   = query->value(10).toInt();
+        pro->conduct->data[0] = query->value(11).toDouble();
+        pro->conduct->flag[0] = query->value(12).toInt();
+        //  the assigned items are not stored
+        pro->den->updateAssign(pro->den->data[0] != 0);
+        pro->linear->updateAssign(pro->linear->data[0] != 0);
+        pro->neo->updateAssign(pro->neo->data[0] != 0);
+        pro->expan->updateAssign(pro->expan->flag[0] == 1);
+        pro->conduct->updateAssign(pro->conduct->flag[0] == 1);
+        pro->isLoaded = true;
+    }
+    if (query != nullptr) query->finish();
+}
+
 /*  ############################################################################
  *  constructor:  create the material property object
     @argc  _index: the inner order of the current material  */
@@ -805,6 +1004,11 @@ Material::Property::Property(const int& _index) {
     //  assign the index
     index = _index;
 
+    //  the new material is written by the next snapshot
+    uid      = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    isDirty  = true;
+    isLoaded = true;
+
     //  if material assigned
     assigned = false;
 
@@ -22,7 +22,9 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QStandardItemModel>
+#include <QVariantMap>
 
+#include "autosave.h"
 #include "manager.h"
 #include "rename.h"
 
@@ -50,10 +52,12 @@ private:
 
     QMessageBox msgbox;  // message box to show the information
 
-    class Property;      // the class of material property
-    Property* proNew;    // the newly created property
-    Property* proOld;    // the old material property
-    Property* proCur;    // current material property for operation
+    class Property;           // the class of material property
+    Property* proNew;         // the newly created property
+    Property* proOld;         // the old material property
+    Property* proCur;         // current material property for operation
+    QStringList removedList;  // unique ids of the deleted materials
+    Database* database;       // project file of the unloaded materials
 
     //  other needed varaibles
     int index;                         // the current index of material property
@@ -107,6 +111,11 @@ private:
     /*  reset: reset the dialog to the default  */
     void reset();
 
+    /*  hydrate: fetch the properties of the material from the project file on
+     *  its first use, only the names are read when the project is opened
+     *  @param  pro: the material property  */
+    void hydrate(Property* pro);
+
 private slots:
     /*  Properties listview  */
     void addItemDen();     // density
@@ -147,6 +156,28 @@ public:
     void create();   //  create a material
     void manager();  // show the mananager
 
+    /*  snapshot: append the deleted and the changed materials to the
+     *  snapshot of the project, and clear their dirty flags
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the materials rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, const bool isFull);
+
+    /*  loadProjectDatabase: replace the materials by those in the project
+     *  file, only the names are read and the properties are fetched on their
+     *  first use
+     *  @param  database: the database of the project  */
+    void loadProjectDatabase(Database* database);
+
+    /*  append: append the material from the material library to the project
+     *  @param  material: the columns of the library material by their names */
+    void append(const QVariantMap& material);
+
+    /*  getMaterials: get the assigned properties of all the materials, which
+     *  are fetched from the project file if they are not loaded
+     *  @return  the columns of the materials by their names as the library,
+     *           the unassigned properties are absent  */
+    QVector<QVariantMap> getMaterials();
+
 protected:
     /*  closeEvent: override the close event  */
     void closeEvent(QCloseEvent* event) override;
@@ -159,6 +190,9 @@ protected:
 class Material::Property {
 public:
     //  basic configuration
+    QString uid;      // the unique id in the project file
+    bool isDirty;     // changed since the last snapshot
+    bool isLoaded;    // the properties are read from the project file
     int index;        // inner index of the current material
     QString name;     // name of material
     QString descrip;  // description of material
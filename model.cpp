@@ -15,8 +15,17 @@
  *  */
 #include "model.h"
 
+#include <QUuid>
+
 #include "ui_model.h"
 
+/*  upsert of the model, a replacement would delete its sets in cascade  */
+static const QString MODEL_UPSERT =
+    "INSERT INTO models (uid, name, type, source, source_type, create_type) "
+    "VALUES (?, ?, ?, ?, ?, ?) ON CONFLICT(uid) DO UPDATE SET "
+    "name = excluded.name, type = excluded.type, source = excluded.source, "
+    "source_type = excluded.source_type, create_type = excluded.create_type";
+
 /*  ############################################################################
  *  constructor:  create the model object   */
 Model::Model(QWidget* parent, QString*& projName, QString*& workPath)
@@ -29,8 +38,9 @@ Model::Model(QWidget* parent, QString*& projName, QString*& workPath)
     workDir = workPath;
 
     //  create a new property model
-    index  = 0;
-    proNew = new ModelProperty(index, project, workDir);
+    index    = 0;
+    proNew   = new ModelProperty(index, project, workDir);
+    database = nullptr;
 
     //  other moduled environment
     setupSourceSelect();  // the source selection
@@ -205,6 +215,7 @@ void Model::saveModelDialog() {
     //  creation type
     if (ui->useNew->isChecked()) proTem->createType = 0;
     if (ui->useOld->isChecked()) proTem->createType = 1;
+    proTem->isDirty = true;
 
     //  update the model name if in edit mode
     if (editmode) {
@@ -256,6 +267,7 @@ void Model::loadModelDialog(int idx) {
     //  get the current property
     item   = itemModel->item(idx, 0);
     proOld = item->data(Qt::UserRole).value<ModelProperty*>();
+    hydrate(proOld);
     //  set the name of the model
     ui->name->setText(*proOld->name);
 
@@ -323,7 +335,8 @@ void Model::setModelName() {
     //  set the new name of the model
     QString text;
     rename->getNameNew(text);
-    *proOld->name = text;
+    *proOld->name   = text;
+    proOld->isDirty = true;
     //  update the name of the current item
     item->setText(text);
     //  rest the pointer
@@ -343,6 +356,7 @@ void Model::deleteModel(int idx) {
         item = itemModel->item(idx, 0);
         //  get the current model property in edit
         proOld = item->data(Qt::UserRole).value<ModelProperty*>();
+        removedList << proOld->uid;
         //  remove the item from the list view
         itemModel->removeRow(idx);
         //  remove the property object
@@ -352,68 +366,154 @@ void Model::deleteModel(int idx) {
 }
 
 /*  ############################################################################
- *  saveModelDatabase: save the basic information of the model database*/
-void Model::saveModelDatabase() {
+ *  snapshot: append the deleted and the changed models and their sets to the
+ *  snapshot of the project, and clear their dirty flags
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write all the models rather than the changed ones  */
+void Model::snapshot(QVector<Autosave::Record>& records, const bool isFull) {
+    //  the sets are removed with the models
+    for (const QString& uid : removedList) {
+        records.append({"DELETE FROM models WHERE uid = ?", {uid}});
+    }
+    removedList.clear();
     //  iterate through all items in the list view
     for (int i = 0; i < itemModel->rowCount(); ++i) {
         //  get the item
         item = itemModel->item(i, 0);
         //  get the current model property
         proOld = item->data(Qt::UserRole).value<ModelProperty*>();
-        //  save the database
-        proOld->saveDatabase(*workDir);
+        //  another file needs the details of all the models
+        if (isFull) hydrate(proOld);
+        //  write the changed model and sets
+        proOld->snapshot(records, isFull);
     }
+    item   = nullptr;
+    proOld = nullptr;
 }
 
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
- *  loadModel: load the model information from the local database  */
+ *  loadProjectDatabase: replace the models by those in the project file, only
+ *  the names of the models and sets are read, and the details are fetched on
+ *  their first use
+ *  @param  database: the database of the project  */
+void Model::loadProjectDatabase(Database* database) {
+    this->database = database;
+    //  remove the current models
+    while (itemModel->rowCount() > 0) {
+        item = itemModel->item(0, 0);
+        delete item->data(Qt::UserRole).value<ModelProperty*>();
+        itemModel->removeRow(0);
+    }
+    removedList.clear();
+    set = proNew->set;
+
+    //  the names of the models in the order of creation
+    QSqlQuery* query =
+        database->select("SELECT uid, name FROM models ORDER BY rowid");
+    while (query != nullptr && query->next()) {
+        ++index;
+        proTem           = new ModelProperty(index, project, workDir);
+        proTem->uid      = query->value(0).toString();
+        *proTem->name    = query->value(1).toString();
+        proTem->isDirty  = false;
+        proTem->isLoaded = false;
+        //  the names of its sets
+        proTem->set->loadProjectDatabase(database, proTem->uid);
+        //  add the model to the list view
+        item = new QStandardItem(*proTem->name);
+        item->setData(QVariant::fromValue(proTem), Qt::UserRole);
+        itemModel->appendRow(item);
+    }
+    if (query != nullptr) query->finish();
+    item   = nullptr;
+    proTem = nullptr;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  hydrate: fetch the details of the model from the project file on its first
+ *  use, only the names are read when the project is opened
+ *  @param  pro: the model property  */
+void Model::hydrate(ModelProperty* pro) {
+    if (pro->isLoaded || database == nullptr) return;
+    QSqlQuery* query = database->select(
+        "SELECT type, source, source_type, create_type FROM models "
+        "WHERE uid = ?",
+        {pro->uid});
+    if (query != nullptr && query->next()) {
+        pro->modelType  = query->value(0).toInt();
+        pro->source     = query->value(1).toString();
+        pro->sourceType = query->value(2).toInt();
+        pro->createType = query->value(3).toInt();
+        pro->isLoaded   = true;
+    }
+    if (query != nullptr) query->finish();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  loadModelDatabase: load the first model of the selected file, which is
+ *  read as it is, i.e., the project file of a known version or the model
+ *  file of the early versions  */
 void Model::loadModelDatabase() {
-    //  set the database name
-    proNew->dbname = ui->source->text();
-    //  create the database
-    proNew->db.setDatabaseName(proNew->dbname);
-    if (!proNew->db.open()) {
-        qDebug() << "Failed to open the database"
-                 << proNew->db.lastError().text();
+    openModel->getSelectContent(text);
+
+    //  the connection is closed when the object is destroyed
+    Database source("MODEL_IMPORT");
+    if (!source.openReadOnly(text)) {
+        msgbox->showMessage(2, ":/icons/model.png", "Model",
+                            "Failed to open " + text + "\n" +
+                                source.getError());
+        return;
+    }
+
+    /*  the model file of the early versions lists the name, the type, the
+     *  source and the source type in its rows  */
+    int version = source.getVersion();
+    if (version == 0 && source.hasTable("MODEL")) {
+        QSqlQuery* query = source.select("SELECT * FROM MODEL ORDER BY 1");
+        QVariantList values;
+        while (query != nullptr && query->next()) {
+            values << query->value(2);
+        }
+        if (query != nullptr) query->finish();
+        if (values.size() < 4) {
+            msgbox->showMessage(2, ":/icons/model.png", "Model",
+                                "No model is found in " + text);
+            return;
+        }
+        *proNew->name      = values[0].toString();
+        proNew->modelType  = values[1].toInt();
+        proNew->source     = values[2].toString();
+        proNew->sourceType = values[3].toInt();
+        proNew->createType = 1;
+        ui->source->setText(proNew->source);
+        return;
+    }
+
+    /*  all the versions of the project file have the same model columns  */
+    if (version < 1 || version > Database::getProjectVersion()) {
+        msgbox->showMessage(2, ":/icons/model.png", "Model",
+                            QString("The version %1 of %2 is not supported.")
+                                .arg(version)
+                                .arg(text));
+        return;
+    }
+    QSqlQuery* query = source.select(
+        "SELECT name, type, source, source_type FROM models "
+        "ORDER BY rowid LIMIT 1");
+    bool isFound = query != nullptr && query->next();
+    if (isFound) {
+        *proNew->name      = query->value(0).toString();
+        proNew->modelType  = query->value(1).toInt();
+        proNew->source     = query->value(2).toString();
+        proNew->sourceType = query->value(3).toInt();
+        proNew->createType = 1;
+        ui->source->setText(proNew->source);
+    }
+    if (query != nullptr) query->finish();
+    if (!isFound) {
+        msgbox->showMessage(2, ":/icons/model.png", "Model",
+                            "No model is found in " + text);
     }
-    //  load the information of project
-    QSqlQuery query(proNew->db);
-    query.prepare("SELECT * FROM MODEL;");
-
-    //  perform the query command
-    query.exec();
-
-    //  get the name of the model
-    query.next();
-    *proNew->name = query.value(2).toString();
-    qDebug() << proNew->name;
-
-    //  get the model type
-    query.next();
-    proNew->modelType = query.value(2).toInt();
-    qDebug() << proNew->modelType;
-
-    //  get the source
-    query.next();
-    proNew->source = query.value(2).toString();
-    qDebug() << proNew->source;
-
-    //  get the source type
-    query.next();
-    proNew->sourceType = query.value(2).toInt();
-    qDebug() << proNew->sourceType;
-
-    //  assign the creation type
-    query.next();
-    proNew->createType = 1;
-    qDebug() << proNew->createType;
-
-    //  close the query
-    query.finish();
-    query.clear();
-
-    //  close the database
-    proNew->db.close();
 }
 
 /*  ############################################################################
@@ -427,6 +527,11 @@ Model::ModelProperty::ModelProperty(int _index, QString*& projName,
     ifOverride = false;
     ifCreateDb = false;
 
+    //  the new model is written by the next snapshot
+    uid      = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    isDirty  = true;
+    isLoaded = true;
+
     //  assign the model name
     name = new QString("Model-" + QString::number(_index));
     //  assign the project name and work directory
@@ -438,12 +543,24 @@ Model::ModelProperty::ModelProperty(int _index, QString*& projName,
 }
 
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
- *  saveDatabase: save model information to the local database */
-void Model::ModelProperty::saveDatabase(QString& workDir) {
-    //  create the database
-    if (!ifCreateDb) {
-        db = QSqlDatabase::addDatabase("QSQLITE", *name);
+ *  snapshot: append the model if changed and its sets to the snapshot
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write the model and all its sets  */
+void Model::ModelProperty::snapshot(QVector<Autosave::Record>& records,
+                                    const bool isFull) {
+    //  the model is written before its sets, only the name of the unloaded
+    //  model can be changed
+    if (isFull || isDirty) {
+        if (isLoaded) {
+            records.append({MODEL_UPSERT, {uid, *name, modelType, source,
+                                           sourceType, createType}});
+        } else {
+            records.append(
+                {"UPDATE models SET name = ? WHERE uid = ?", {*name, uid}});
+        }
+        isDirty = false;
     }
+    set->snapshot(records, uid, isFull);
 }
 
 /*  ############################################################################
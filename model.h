@@ -18,6 +18,7 @@
 
 #include <QDialog>
 
+#include "autosave.h"
 #include "manager.h"
 #include "messagebox.h"
 #include "open.h"
@@ -59,7 +60,9 @@ private:
     ModelProperty* proTem;  // the temporary object for model property
     ModelProperty* proCur;  // the current operated model property
 
-    Set* set;               // the set object
+    Set* set;                 // the set object
+    QStringList removedList;  // unique ids of the deleted models
+    Database* database;       // project file of the unloaded models
 
 private:
     QStandardItem* item;            // the item in the list view
@@ -82,6 +85,11 @@ private:
     /*  setup Rename dialog  */
     void setupRenameDialog();
 
+    /*  hydrate: fetch the details of the model from the project file on its
+     *  first use, only the names are read when the project is opened
+     *  @param  pro: the model property  */
+    void hydrate(ModelProperty* pro);
+
 private slots:
     /*  saveModelDialog: save the dialog information to the variables  */
     void saveModelDialog();
@@ -92,7 +100,8 @@ private slots:
     /*  confirmDialog: check the dialog information is complete  */
     bool confimDialog();
 
-    /*  load the model information from the local database  */
+    /*  loadModelDatabase: load the first model of the selected file, which
+     *  is read as it is  */
     void loadModelDatabase();
 
     /*  getModelName: get the name of the selected model  */
@@ -111,8 +120,17 @@ public:
     /*  destructor: destroy the Model object  */
     ~Model();
 
-    /*  save the model information to the local database  */
-    void saveModelDatabase();
+    /*  snapshot: append the deleted and the changed models and their sets to
+     *  the snapshot of the project, and clear their dirty flags
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the models rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, const bool isFull);
+
+    /*  loadProjectDatabase: replace the models by those in the project file,
+     *  only the names of the models and sets are read, and the details are
+     *  fetched on their first use
+     *  @param  database: the database of the project  */
+    void loadProjectDatabase(Database* database);
 
     /*  get the model list  */
     QStandardItemModel* getModelList();
@@ -157,6 +175,9 @@ protected:
  *  Material and so on, over the model  */
 class Model::ModelProperty {
 public:
+    QString uid;       // the unique id in the project file
+    bool isDirty;      // changed since the last snapshot
+    bool isLoaded;     // the details are read from the project file
     bool ifUseNew;     // flag to determine the source to create a Model
     QString* name;     // the name of the model
     QString source;    // the source file
@@ -168,8 +189,6 @@ public:
 
     Set* set;          // the set object
 
-    QSqlDatabase db;   // the database object
-    QString dbname;    // the name of database
     bool ifCreateDb;   // whether the database has been created or not
 
     bool assigned;     // whether the model is assigned
@@ -188,8 +207,10 @@ public:
         name = nullptr;
     };
 
-    /*  save model information to the local database */
-    void saveDatabase(QString& _workDir);
+    /*  snapshot: append the model if changed and its sets to the snapshot
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write the model and all its sets  */
+    void snapshot(QVector<Autosave::Record>& records, const bool isFull);
 
     /*  update the item order  */
     void updateItemOrder();
@@ -0,0 +1,360 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : monitor.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "monitor.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+#include "prenano.h"
+#include "ui_monitor.h"
+
+/*  titles of the pages  */
+static const char* TITLES[] = {"Objective", "Constraint", "log10(Residual)",
+                               "Logs"};
+
+/*  ############################################################################
+ *  constructor: create the monitor page
+ *  @param  parent: the parent widget  */
+Monitor::Monitor(QWidget* parent) : QWidget(parent), ui(new Ui::Monitor) {
+    ui->setupUi(this);
+    isPolling = false;
+
+    //  the charts of the series
+    QVBoxLayout* layouts[3] = {ui->objectiveLayout, ui->constraintLayout,
+                               ui->residualLayout};
+    for (int i = 0; i < 3; ++i) {
+        plots[i] = new Plot(this);
+        plots[i]->setLabels("Iteration", TITLES[i]);
+        plots[i]->setZoomable(true);
+        layouts[i]->addWidget(plots[i]);
+        series.append(new Pyramid);
+        isChanged[i] = false;
+        connect(plots[i], &Plot::viewChanged, this,
+                [this, i]() { updatePlot(i); });
+    }
+
+    //  the log view keeps the last lines
+    ui->logs->setMaximumBlockCount(PRENANO::MONITOR_LOG_LINES);
+    ui->logs->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    //  the watcher of the files and their directories
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this,
+            &Monitor::onFileChanged);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this,
+            [&](const QString&) {
+                //  the file is created after it is monitored
+                for (Tail* tail : tails) onFileChanged(tail->file);
+            });
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: stop watching and release the readers  */
+Monitor::~Monitor() {
+    delete ui;
+    qDeleteAll(tails);
+    qDeleteAll(series);
+}
+
+/*  ############################################################################
+ *  setFiles: monitor the files from their beginning, the previous files and
+ *  series are discarded
+ *  @param  files: the paths of the logs and history files  */
+void Monitor::setFiles(const QStringList& files) {
+    //  stop watching the previous files
+    if (!watcher->files().isEmpty()) watcher->removePaths(watcher->files());
+    if (!watcher->directories().isEmpty()) {
+        watcher->removePaths(watcher->directories());
+    }
+    qDeleteAll(tails);
+    tails.clear();
+    for (int i = 0; i < 3; ++i) {
+        series[i]->clear();
+        plots[i]->clear();
+        isChanged[i] = true;
+    }
+    ui->logs->clear();
+
+    //  watch the files and their directories
+    QStringList dirs;
+    for (const QString& file : files) {
+        tails.append(new Tail(file));
+        if (QFile::exists(file)) watcher->addPath(file);
+        QString dir = QFileInfo(file).absolutePath();
+        if (!dirs.contains(dir)) dirs << dir;
+    }
+    if (!dirs.isEmpty()) watcher->addPaths(dirs);
+
+    //  read the existing contents
+    updatePlots();
+    poll();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  showPage: show the chart of the series or the log view
+ *  @param  page: OBJECTIVE, CONSTRAINT, RESIDUAL or LOGS  */
+void Monitor::showPage(const int page) {
+    ui->pages->setCurrentIndex(page);
+    ui->title->setText(TITLES[page]);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  exportFile: write the series to the CSV file
+ *  @param  file: the path of the CSV file
+ *  @return  the status, true for success, otherwise failed  */
+bool Monitor::exportFile(const QString& file) {
+    QFile output(file);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        ui->status->setText("Failed to write " + file);
+        return false;
+    }
+    QTextStream out(&output);
+    out << "series,iteration,value\n";
+    const char* names[3] = {"objective", "constraint", "residual"};
+    for (int i = 0; i < 3; ++i) {
+        const QVector<double>& xs = series[i]->getXs();
+        const QVector<double>& ys = series[i]->getYs();
+        for (qsizetype j = 0; j < xs.size(); ++j) {
+            //  the residual is charted in the logarithmic scale
+            double value = i == RESIDUAL ? std::pow(10.0, ys[j]) : ys[j];
+            out << names[i] << "," << xs[j] << "," << value << "\n";
+        }
+    }
+    ui->status->setText("Exported to " + file);
+    return true;
+}
+
+/*  ############################################################################
+ *  poll: read the appended chunks of the files, the remaining chunks are read
+ *  in the next turn of the event loop  */
+void Monitor::poll() {
+    isPolling        = false;
+    bool isRemaining = false;
+    qint64 numBytes  = 0;
+    QStringList logs;
+    QList<QByteArray> lines;
+
+    //  the series are read again from all the files once any of them has
+    //  been truncated or replaced, since the points are appended in order
+    if (std::any_of(tails.begin(), tails.end(),
+                    [](const Tail* tail) { return tail->isReplaced(); })) {
+        for (Tail* tail : tails) tail->rewind();
+        for (int i = 0; i < 3; ++i) {
+            series[i]->clear();
+            isChanged[i] = true;
+        }
+        ui->logs->clear();
+    }
+
+    for (Tail* tail : tails) {
+        lines.clear();
+        if (tail->read(PRENANO::MONITOR_CHUNK_SIZE, lines)) isRemaining = true;
+        for (const QByteArray& line : lines) {
+            parse(tail, line);
+            if (!tail->isHistory) logs << QString::fromUtf8(line);
+        }
+        numBytes += tail->offset;
+    }
+
+    //  only the lines kept by the log view are appended
+    if (logs.size() > PRENANO::MONITOR_LOG_LINES) {
+        logs = logs.mid(logs.size() - PRENANO::MONITOR_LOG_LINES);
+    }
+    if (!logs.isEmpty()) ui->logs->appendPlainText(logs.join('\n'));
+    updatePlots();
+    ui->status->setText(QString("Monitoring %1 files, %2 MB read")
+                            .arg(tails.size())
+                            .arg(numBytes / 1048576.0, 0, 'f', 1));
+
+    //  the rest of the large files never blocks the event loop
+    if (isRemaining) {
+        isPolling = true;
+        QTimer::singleShot(0, this, &Monitor::poll);
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onFileChanged: the file is modified, replaced or removed
+ *  @param  file: the path of the file  */
+void Monitor::onFileChanged(const QString& file) {
+    //  the replaced file is no longer watched
+    if (!watcher->files().contains(file) && QFile::exists(file)) {
+        watcher->addPath(file);
+    }
+    if (!isPolling) poll();
+}
+
+/*  ############################################################################
+ *  parse: parse the line of the file and append to the series
+ *  @param  tail: the reader of the file
+ *  @param  line: the line without the line break  */
+void Monitor::parse(Tail* tail, const QByteArray& line) {
+    if (line.isEmpty()) return;
+    //  the residual is charted in the logarithmic scale
+    auto append = [&](const int id, const double x, const double y) {
+        if (std::isnan(y) || (id == RESIDUAL && y <= 0.0)) return;
+        series[id]->append(x, id == RESIDUAL ? std::log10(y) : y);
+        isChanged[id] = true;
+    };
+
+    /*  the history table  */
+    if (tail->isHistory) {
+        QList<QByteArray> fields =
+            QByteArray(line).replace(',', ' ').simplified().split(' ');
+        //  the header names the columns
+        if (tail->columns.isEmpty()) {
+            for (qsizetype i = 0; i < fields.size(); ++i) {
+                QByteArray name = fields[i].toLower();
+                if (name.startsWith("iter")) tail->iterColumn = int(i);
+                tail->columns.append(
+                    name == "obj" || name == "objective"    ? OBJECTIVE
+                    : name == "con" || name == "constraint" ? CONSTRAINT
+                    : name == "res" || name == "residual"   ? RESIDUAL
+                                                            : -1);
+            }
+            return;
+        }
+        //  the iteration is the row number if it is not given
+        bool ok  = false;
+        double x = 0.0;
+        if (tail->iterColumn >= 0 && tail->iterColumn < fields.size()) {
+            x = fields[tail->iterColumn].toDouble(&ok);
+        }
+        if (!ok) x = double(tail->numRows);
+        ++tail->numRows;
+        qsizetype num = std::min(tail->columns.size(), fields.size());
+        for (qsizetype i = 0; i < num; ++i) {
+            if (tail->columns[i] < 0) continue;
+            double y = fields[i].toDouble(&ok);
+            if (ok) append(tail->columns[i], x, y);
+        }
+        return;
+    }
+
+    /*  the lines of the log like "objective = 1.0e-2", the other words like
+     *  "contact" or "restart" are not the series  */
+    static const QRegularExpression pattern(
+        "\\b(obj(?:ective)?|con(?:straint)?|res(?:idual)?)\\s*[:=]\\s*"
+        "([-+]?(?:[0-9]+\\.?[0-9]*|\\.[0-9]+)(?:[eE][-+]?[0-9]+)?)",
+        QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatchIterator it =
+        pattern.globalMatch(QString::fromUtf8(line));
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+        QString key                   = match.captured(1).left(3).toLower();
+        int id = key == "obj"   ? OBJECTIVE
+                 : key == "con" ? CONSTRAINT
+                                : RESIDUAL;
+        append(id, double(series[id]->size()), match.captured(2).toDouble());
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  updatePlots: update the charts of the changed series  */
+void Monitor::updatePlots() {
+    for (int i = 0; i < 3; ++i) {
+        if (!isChanged[i]) continue;
+        updatePlot(i);
+        isChanged[i] = false;
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  updatePlot: draw the visible range of the series in the chart
+ *  @param  id: OBJECTIVE, CONSTRAINT or RESIDUAL  */
+void Monitor::updatePlot(const int id) {
+    double range[2] = {0.0, 0.0};
+    if (!plots[id]->getView(range) && !series[id]->getRange(range)) {
+        plots[id]->setCurve(QVector<double>(), QVector<double>());
+        return;
+    }
+    QVector<double> xs, ys;
+    series[id]->query(range[0], range[1], plots[id]->width(), xs, ys);
+    plots[id]->setCurve(xs, ys);
+}
+
+/*  ############################################################################
+ *  constructor: read the file from its beginning
+ *  @param  path: the path of the file  */
+Monitor::Tail::Tail(const QString& path) : file(path) {
+    QString suffix = QFileInfo(path).suffix().toLower();
+    isHistory      = suffix == "his" || suffix == "csv" || suffix == "dat";
+    rewind();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  isReplaced: check whether the file has been truncated or replaced since it
+ *  was read, the removed file is kept until it appears again
+ *  @return  true if the read bytes are no longer in the file  */
+bool Monitor::Tail::isReplaced() const {
+    if (offset == 0) return false;
+    QFile input(file);
+    if (!input.open(QIODevice::ReadOnly)) return false;
+    return input.size() < offset || input.read(head.size()) != head;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  rewind: read the file again from its beginning  */
+void Monitor::Tail::rewind() {
+    offset = 0;
+    partial.clear();
+    head.clear();
+    columns.clear();
+    iterColumn = -1;
+    numRows    = 0;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  read: read the appended bytes up to the budget and split the lines
+ *  @param  budget: the maximum number of bytes to be read
+ *  @param  lines: the complete lines that are read
+ *  @return  true if there are more bytes to be read  */
+bool Monitor::Tail::read(const qint64 budget, QList<QByteArray>& lines) {
+    QFile input(file);
+    if (!input.open(QIODevice::ReadOnly)) return false;
+
+    if (!input.seek(offset)) return false;
+    QByteArray chunk = input.read(budget);
+    offset += chunk.size();
+    //  the leading bytes are those before the offset
+    if (head.size() < PRENANO::MONITOR_HEAD_SIZE) {
+        head += chunk.left(PRENANO::MONITOR_HEAD_SIZE - head.size());
+    }
+
+    //  split the complete lines, the last one is kept for the next read
+    qsizetype start = 0;
+    qsizetype end   = chunk.indexOf('\n');
+    while (end >= 0) {
+        QByteArray line = chunk.mid(start, end - start);
+        if (!partial.isEmpty()) {
+            line.prepend(partial);
+            partial.clear();
+        }
+        lines.append(line.trimmed());
+        start = end + 1;
+        end   = chunk.indexOf('\n', start);
+    }
+    partial += chunk.mid(start);
+    //  the line longer than the budget is dropped
+    if (partial.size() > budget) partial.clear();
+    return offset < input.size();
+}
@@ -0,0 +1,147 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : monitor.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <QByteArray>
+#include <QFileSystemWatcher>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include <QWidget>
+
+#include "plot.h"
+#include "pyramid.h"
+
+namespace Ui {
+class Monitor;
+}
+
+/*  ############################################################################
+ *  class Monitor: the page of the main view to monitor the running solver.
+ *      The solver logs and history files are watched by the file system
+ *      watcher, which is backed by inotify on Linux, and only the bytes
+ *      appended since the last offset are read in the bounded chunks. The
+ *      objective, constraint and residual series are parsed from the new
+ *      lines into the level-of-detail pyramids, and the charts only draw the
+ *      envelope of the visible range at about one bucket per pixel, so that
+ *      zooming and panning the long histories stays smooth. The log view
+ *      keeps a fixed number of lines. All the files are read again into the
+ *      empty series once any of them is truncated or replaced.
+ *
+ *      The history file (*.his, *.csv, *.dat) is a table whose first line
+ *      names the columns, the columns starting with "iter" and those named
+ *      "objective", "constraint" and "residual", or "obj", "con" and "res",
+ *      are used. The other files are the logs, whose lines like
+ *      "objective = 1.0e-2" or "residual: 3.2e-5" are collected.  */
+class Monitor : public QWidget {
+    Q_OBJECT
+
+public:
+    /*  the series and the pages  */
+    enum { OBJECTIVE, CONSTRAINT, RESIDUAL, LOGS };
+
+private:
+    class Tail;                   // the incremental reader of one file
+
+    Ui::Monitor* ui;              // UI interface
+    Plot* plots[3];               // charts of the series
+    QFileSystemWatcher* watcher;  // watcher of the files and directories
+    QList<Tail*> tails;           // readers of the monitored files
+    QList<Pyramid*> series;       // objective, constraint and residual
+    bool isChanged[3];            // changed since the chart is updated
+    bool isPolling;               // the remaining chunks are scheduled
+
+public:
+    /*  ########################################################################
+     *  constructor: create the monitor page
+     *  @param  parent: the parent widget  */
+    explicit Monitor(QWidget* parent = nullptr);
+
+    /*  destructor: stop watching and release the readers  */
+    ~Monitor();
+
+    /*  setFiles: monitor the files from their beginning, the previous files
+     *  and series are discarded
+     *  @param  files: the paths of the logs and history files  */
+    void setFiles(const QStringList& files);
+
+    /*  showPage: show the chart of the series or the log view
+     *  @param  page: OBJECTIVE, CONSTRAINT, RESIDUAL or LOGS  */
+    void showPage(const int page);
+
+    /*  exportFile: write the series to the CSV file
+     *  @param  file: the path of the CSV file
+     *  @return  the status, true for success, otherwise failed  */
+    bool exportFile(const QString& file);
+
+private slots:
+    /*  poll: read the appended chunks of the files, the remaining chunks are
+     *  read in the next turn of the event loop  */
+    void poll();
+
+    /*  onFileChanged: the file is modified, replaced or removed
+     *  @param  file: the path of the file  */
+    void onFileChanged(const QString& file);
+
+private:
+    /*  parse: parse the line of the file and append to the series
+     *  @param  tail: the reader of the file
+     *  @param  line: the line without the line break  */
+    void parse(Tail* tail, const QByteArray& line);
+
+    /*  updatePlots: update the charts of the changed series  */
+    void updatePlots();
+
+    /*  updatePlot: draw the visible range of the series in the chart
+     *  @param  id: OBJECTIVE, CONSTRAINT or RESIDUAL  */
+    void updatePlot(const int id);
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Monitor::Tail: the reader of the monitored file, which remembers the
+ *  offset of the read bytes and the incomplete last line  */
+class Monitor::Tail {
+public:
+    QString file;          // path of the file
+    bool isHistory;        // history table or log
+    qint64 offset;         // number of the read bytes
+    QByteArray partial;    // incomplete last line
+    QByteArray head;       // leading bytes to detect the replaced file
+    QVector<int> columns;  // series of the table columns, -1 for none
+    int iterColumn;        // column of the iteration, -1 for none
+    qint64 numRows;        // number of the rows of the table
+
+public:
+    /*  constructor: read the file from its beginning
+     *  @param  path: the path of the file  */
+    explicit Tail(const QString& path);
+
+    /*  isReplaced: check whether the file has been truncated or replaced
+     *  since it was read
+     *  @return  true if the read bytes are no longer in the file  */
+    bool isReplaced() const;
+
+    /*  rewind: read the file again from its beginning  */
+    void rewind();
+
+    /*  read: read the appended bytes up to the budget and split the lines
+     *  @param  budget: the maximum number of bytes to be read
+     *  @param  lines: the complete lines that are read
+     *  @return  true if there are more bytes to be read  */
+    bool read(const qint64 budget, QList<QByteArray>& lines);
+};
+#endif  // MONITOR_H
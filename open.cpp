@@ -15,7 +15,9 @@
  *  */
 #include "open.h"
 
+#include "prenano.h"
 #include "ui_open.h"
+using namespace PRENANO;
 
 /*  ############################################################################
  *  Constructor: create the OpenDir object  */
@@ -35,6 +37,20 @@ Open::Open(QWidget *parent, const int type)
     file->setRootPath(pathCur);
     //  assign the diag types
     flagDiag = type;
+    //  scan the meta data of the result files
+    peek = new PeekModel(file);
+    peek->setScanEnabled(flagDiag == 8);
+    if (flagDiag == 8) {
+        //  browse the results by the thumbnails
+        ui->listView->setViewMode(QListView::IconMode);
+        ui->listView->setResizeMode(QListView::Adjust);
+        ui->listView->setWordWrap(true);
+        ui->listView->setIconSize(QSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE));
+        ui->listView->setGridSize(
+            QSize(THUMBNAIL_SIZE + 32, THUMBNAIL_SIZE + 40));
+        ui->tableView->setIconSize(
+            QSize(THUMBNAIL_SIZE / 2, THUMBNAIL_SIZE / 2));
+    }
     //  define filters
     QStringList filter;
     filter << "All folders (*)"
@@ -45,7 +61,7 @@ Open::Open(QWidget *parent, const int type)
            << "Pacnano input (*.in)"
            << "Pacnano output (*.ou)"
            << "Pacnano in&out (*.in, *.ou)"
-           << "Results (*.rst)";
+           << "Results (*.rst, *.vtu, *.pvtu, *.vtkhdf)";
     //  initialize the filter flags
     filterFlag.clear();
     ui->fileFilter->clear();
@@ -165,6 +181,7 @@ Open::Open(QWidget *parent, const int type)
  *  Destructor: destroy the OpenDir object  */
 Open::~Open() {
     delete dir;   // directory system
+    delete peek;  // meta data of the result files
     delete file;  // file system
     delete ui;    // UI interface
 }
@@ -177,8 +194,8 @@ void Open::showListView() {
 
     //  set the file system model
     file->setRootPath(pathCur);
-    ui->listView->setModel(file);
-    rootIndex = file->index(pathCur);
+    ui->listView->setModel(peek);
+    rootIndex = peek->mapFromSource(file->index(pathCur));
     ui->listView->setRootIndex(rootIndex);
 
     //  show the viewer
@@ -200,10 +217,10 @@ void Open::showListView() {
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  *  SLOT: double click to open a folder in list  */
 void Open::openListView(const QModelIndex &index) {
-    if (file->isDir(index)) {
+    if (getFileInfo(index).isDir()) {
         //  open the folder
-        pathCur   = file->fileInfo(index).absoluteFilePath();
-        rootIndex = file->setRootPath(pathCur);
+        pathCur   = getFileInfo(index).absoluteFilePath();
+        rootIndex = peek->mapFromSource(file->setRootPath(pathCur));
         ui->listView->setRootIndex(rootIndex);
         ui->btnBack->setDisabled(false);
 
@@ -216,7 +233,7 @@ void Open::openListView(const QModelIndex &index) {
  *  click to select a folder in list view  */
 void Open::selectFolderInListView(const QModelIndex &index) {
     //  get the path
-    pathCur = file->fileInfo(index).absoluteFilePath();
+    pathCur = getFileInfo(index).absoluteFilePath();
     //  update the folder name
     ui->fileName->setText(pathCur);
 }
@@ -229,12 +246,12 @@ void Open::showTreeView() {
 
     //  show the directory tree
     file->setRootPath(pathCur);
-    ui->treeView->setModel(file);
+    ui->treeView->setModel(peek);
     ui->treeView->setHeaderHidden(true);
-    for (int i = 1; i < file->columnCount(); ++i) {
+    for (int i = 1; i < peek->columnCount(); ++i) {
         ui->treeView->setColumnHidden(i, true);
     }
-    rootIndex = file->index(pathCur);
+    rootIndex = peek->mapFromSource(file->index(pathCur));
     ui->treeView->setRootIndex(rootIndex);
 
     //  show the list view and hide the other two
@@ -257,10 +274,10 @@ void Open::showTreeView() {
  *  SLOT: click and open a folder in tree  */
 void Open::openTreeView(const QModelIndex &index) {
     //  if the index is directory
-    if (file->isDir(index)) {
+    if (getFileInfo(index).isDir()) {
         //  open folder
-        pathCur   = file->fileInfo(index).absoluteFilePath();
-        rootIndex = file->setRootPath(pathCur);
+        pathCur   = getFileInfo(index).absoluteFilePath();
+        rootIndex = peek->mapFromSource(file->setRootPath(pathCur));
         ui->treeView->setRootIndex(rootIndex);
         ui->btnBack->setDisabled(false);
 
@@ -273,7 +290,7 @@ void Open::openTreeView(const QModelIndex &index) {
  *  click to select a folder in tree view  */
 void Open::selectFolderInTreeView(const QModelIndex &index) {
     //  get the path
-    pathCur = file->fileInfo(index).absoluteFilePath();
+    pathCur = getFileInfo(index).absoluteFilePath();
     //  update the folder name
     ui->fileName->setText(pathCur);
 }
@@ -286,12 +303,13 @@ void Open::showTableView() {
 
     //  assign the FileSystemModel information
     file->setRootPath(pathCur);
-    ui->tableView->setModel(file);
-    rootIndex = file->index(pathCur);
+    ui->tableView->setModel(peek);
+    rootIndex = peek->mapFromSource(file->index(pathCur));
     ui->tableView->setRootIndex(rootIndex);
     ui->tableView->setShowGrid(false);
     ui->tableView->verticalHeader()->setVisible(false);
-    ui->tableView->hideColumn(1);
+    //  the file size is shown for the results
+    if (flagDiag != 8) ui->tableView->hideColumn(1);
     ui->tableView->horizontalHeader()->setSectionResizeMode(
         QHeaderView::ResizeToContents);
 
@@ -314,10 +332,10 @@ void Open::showTableView() {
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  *  SLOT: click and open a folder in tree  */
 void Open::openTableView(const QModelIndex &index) {
-    if (file->isDir(index)) {
+    if (getFileInfo(index).isDir()) {
         //  open folder
-        pathCur   = file->fileInfo(index).absoluteFilePath();
-        rootIndex = file->setRootPath(pathCur);
+        pathCur   = getFileInfo(index).absoluteFilePath();
+        rootIndex = peek->mapFromSource(file->setRootPath(pathCur));
         ui->tableView->setRootIndex(rootIndex);
         ui->btnBack->setEnabled(true);
 
@@ -330,7 +348,7 @@ void Open::openTableView(const QModelIndex &index) {
  *  click to select a folder in table view  */
 void Open::selectFolderInTableView(const QModelIndex &index) {
     //  get the path
-    pathCur = file->fileInfo(index).absoluteFilePath();
+    pathCur = getFileInfo(index).absoluteFilePath();
     //  update the folder name
     ui->fileName->setText(pathCur);
 }
@@ -342,7 +360,7 @@ void Open::selectFolderInTableView(const QModelIndex &index) {
 void Open::changeDriver(int index) {
     //  get the path of the QComboBox
     pathCur   = dir->filePath(dir->index(index, 0, dir->index("/")));
-    rootIndex = file->index(pathCur);
+    rootIndex = peek->mapFromSource(file->index(pathCur));
     //  show the path viewer
     switch (flagView) {
         case 0:
@@ -371,7 +389,7 @@ void Open::changeDriver(int index) {
 void Open::navigateUp() {
     //  check the parent path is valid or not
     if (rootIndex.parent().isValid()) {
-        pathCur = file->filePath(rootIndex.parent());
+        pathCur = file->filePath(peek->mapToSource(rootIndex.parent()));
         ui->btnBack->setEnabled(true);
         switch (flagView) {
             case 0:
@@ -478,7 +496,11 @@ void Open::switchSelctionType(int index) {
             file->setNameFilterDisables(false);
             break;
         case 8:
-            filter << "*.rst";
+            filter << "*.rst"
+                   << "*.vtu"
+                   << "*.pvtu"
+                   << "*.vtkhdf"
+                   << "*.hdf";
             file->setNameFilters(filter);
             file->setNameFilterDisables(false);
             break;
@@ -488,6 +510,13 @@ void Open::switchSelctionType(int index) {
     }
 }
 
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getFileInfo: get the file information of the index in the views, the
+ *  meta data columns are mapped to the first column  */
+QFileInfo Open::getFileInfo(const QModelIndex &index) {
+    return file->fileInfo(peek->mapToSource(index.siblingAtColumn(0)));
+}
+
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
  *  getSelectContent: get the content of the selected file or path  */
 void Open::getSelectContent(QString &text) { text = ui->fileName->text(); }
@@ -25,6 +25,8 @@
 #include <QTreeView>
 #include <vector>
 
+#include "peek.h"
+
 namespace Ui {
 class Open;
 }
@@ -35,6 +37,7 @@ class Open : public QDialog {
 private:
     QFileSystemModel* dir;        // model to read the directory
     QFileSystemModel* file;       // modle to read the files in current
+    PeekModel* peek;              // meta data of the result files
 
     int flagView;                 // flag to determine which viewer is actived
     int flagDiag;                 // flag to detemine the dialog types
@@ -89,6 +92,12 @@ protected:
         resetHome();
     }
 
+private:
+    /*  getFileInfo: get the file information of the index in the views
+     *  @param  index: the index of the views, i.e., the proxy index
+     *  @return  the file information  */
+    QFileInfo getFileInfo(const QModelIndex& index);
+
 private:
     Ui::Open* ui;
 };
@@ -1,14 +1,582 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : optimization.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
 #include "optimization.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QSet>
+#include <algorithm>
+#include <numeric>
+
+#include "prenano.h"
 #include "ui_optimization.h"
 
-Optimization::Optimization(QWidget *parent) :
-                                              QDialog(parent),
-                                              ui(new Ui::Optimization)
-{
+/*  keys and names of the parameters of the optimization  */
+static const QStringList GLOBAL_KEYS  = {"volume_fraction", "filter_radius",
+                                         "penalty"};
+static const QStringList GLOBAL_NAMES = {"Volume Fraction", "Filter Radius",
+                                         "Penalty"};
+
+/*  columns and names of the swept material properties, the key of the
+ *  material property is "material/<name>/<column>"  */
+static const QStringList MATERIAL_COLUMNS = {"density", "linear_modulus",
+                                             "linear_poisson"};
+static const QStringList MATERIAL_NAMES   = {"Density", "Elastic Modulus",
+                                             "Poisson's Ratio"};
+
+/*  seed of the Latin hypercube, the same sweep gives the same samples so
+ *  that they are not run again  */
+static const quint32 SWEEP_SEED = 20231022;
+
+/*  names of the scheduler states in the index of the runs  */
+static const QStringList STATE_NAMES = {"queued", "running", "finished",
+                                        "failed", "canceled"};
+
+/*  upsert of the run  */
+static const QString RUN_UPSERT =
+    "INSERT INTO runs (hash, job_uid, directory, parameters, created, state) "
+    "VALUES (?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(hash) DO UPDATE SET job_uid = excluded.job_uid, "
+    "directory = excluded.directory, created = excluded.created, "
+    "state = excluded.state";
+
+/*  hashConfig: get the content hash of the configuration, the keys of the
+ *  JSON object are sorted so that the same content gives the same hash  */
+static QString hashConfig(const QJsonObject& config) {
+    QByteArray data = QJsonDocument(config).toJson(QJsonDocument::Compact);
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+
+/*  ############################################################################
+ *  constructor: create the dialog of the parameter sweep
+ *  @param  parent: the parent widget
+ *  @param  project: the project of the script and directory
+ *  @param  material: materials of the project
+ *  @param  scheduler: queue of the solver jobs  */
+Optimization::Optimization(QWidget* parent, Project* project,
+                           Material* material, Scheduler* scheduler)
+    : QDialog(parent),
+      ui(new Ui::Optimization),
+      project(project),
+      material(material),
+      scheduler(scheduler) {
     ui->setupUi(this);
+    ui->table->setColumnCount(2);
+    ui->table->setHorizontalHeaderLabels({"Parameter", "Values"});
+
+    connect(ui->btnAdd, &QPushButton::clicked, this,
+            &Optimization::addParameter);
+    connect(ui->values, &QLineEdit::returnPressed, this,
+            &Optimization::addParameter);
+    connect(ui->btnRemove, &QPushButton::clicked, this,
+            &Optimization::removeParameter);
+    connect(ui->btnPreview, &QPushButton::clicked, this,
+            &Optimization::preview);
+    connect(ui->btnRun, &QPushButton::clicked, this, &Optimization::run);
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+    //  the final state is kept after the job is cleared from the queue, and
+    //  the index follows the states of the runs
+    connect(scheduler, &Scheduler::finished, this, &Optimization::onFinished);
+    connect(scheduler, &Scheduler::started, this, [&](const QString& uid) {
+        for (Run* record : runs) {
+            if (record->jobUid != uid) continue;
+            writeIndex();
+            if (isVisible()) listRuns();
+            return;
+        }
+    });
+
+    //  the results of the runs are opened or compared by the post viewer
+    ui->runTable->setColumnCount(3);
+    ui->runTable->setHorizontalHeaderLabels({"Parameters", "State", "Result"});
+    connect(ui->btnOpenRun, &QPushButton::clicked, this, [&]() {
+        QString file = getSelectedResult();
+        if (!file.isEmpty()) emit opened(file);
+    });
+    connect(ui->btnCompareRun, &QPushButton::clicked, this, [&]() {
+        QString file = getSelectedResult();
+        if (!file.isEmpty()) emit compared(file);
+    });
+    //  the samples are only used by the Latin hypercube
+    connect(ui->design, &QComboBox::currentIndexChanged, this,
+            [&](int index) { ui->samples->setEnabled(index == 1); });
+    ui->samples->setEnabled(false);
 }
 
-Optimization::~Optimization()
-{
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: release the runs  */
+Optimization::~Optimization() {
+    qDeleteAll(runs);
     delete ui;
 }
+
+/*  ============================================================================
+ *  snapshot: append the new runs to the snapshot of the project, and clear
+ *  their dirty flags
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write all the runs rather than the changed ones  */
+void Optimization::snapshot(QVector<Autosave::Record>& records,
+                            const bool isFull) {
+    for (Run* record : runs) {
+        if (!isFull && !record->isDirty) continue;
+        record->isDirty = false;
+        records.append({RUN_UPSERT,
+                        {record->hash, record->jobUid, record->directory,
+                         record->parameters, record->created, record->state}});
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  loadProjectDatabase: replace the runs by those in the project file
+ *  @param  database: the database of the project  */
+void Optimization::loadProjectDatabase(Database* database) {
+    qDeleteAll(runs);
+    runs.clear();
+    QSqlQuery* query = database->select(
+        "SELECT hash, job_uid, directory, parameters, created, state "
+        "FROM runs");
+    while (query != nullptr && query->next()) {
+        Run* record        = new Run;
+        record->hash       = query->value(0).toString();
+        record->jobUid     = query->value(1).toString();
+        record->directory  = query->value(2).toString();
+        record->parameters = query->value(3).toString();
+        record->created    = query->value(4).toLongLong();
+        record->state      = query->value(5).isNull() ? -1
+                                                      : query->value(5).toInt();
+        record->isDirty    = false;
+        runs.insert(record->hash, record);
+    }
+    if (query != nullptr) query->finish();
+    if (!runs.isEmpty()) writeIndex();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  showEvent: list the parameters of the current materials  */
+void Optimization::showEvent(QShowEvent* event) {
+    ui->parameter->clear();
+    for (qsizetype i = 0; i < GLOBAL_KEYS.size(); ++i) {
+        ui->parameter->addItem(GLOBAL_NAMES[i], GLOBAL_KEYS[i]);
+    }
+    for (const QVariantMap& properties : material->getMaterials()) {
+        QString name = properties.value("name").toString();
+        for (qsizetype i = 0; i < MATERIAL_COLUMNS.size(); ++i) {
+            ui->parameter->addItem(
+                name + ": " + MATERIAL_NAMES[i],
+                "material/" + name + "/" + MATERIAL_COLUMNS[i]);
+        }
+    }
+    listRuns();
+    QDialog::showEvent(event);
+}
+
+/*  ############################################################################
+ *  addParameter: add the values of the selected parameter to the sweep  */
+void Optimization::addParameter() {
+    QVector<double> values;
+    if (ui->parameter->currentIndex() < 0 ||
+        !parseValues(ui->values->text(), values)) {
+        ui->status->setText("Invalid values: " + ui->values->text());
+        return;
+    }
+
+    //  the values of the parameter in the sweep are replaced
+    QString key = ui->parameter->currentData().toString();
+    int row     = ui->table->rowCount();
+    for (int i = 0; i < ui->table->rowCount(); ++i) {
+        if (ui->table->item(i, 0)->data(Qt::UserRole) == key) row = i;
+    }
+    if (row == ui->table->rowCount()) ui->table->insertRow(row);
+    QTableWidgetItem* item = new QTableWidgetItem(ui->parameter->currentText());
+    item->setData(Qt::UserRole, key);
+    ui->table->setItem(row, 0, item);
+    ui->table->setItem(row, 1, new QTableWidgetItem(ui->values->text()));
+    ui->values->clear();
+    preview();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  removeParameter: remove the selected parameters from the sweep  */
+void Optimization::removeParameter() {
+    QModelIndexList rows = ui->table->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end(),
+              [](const QModelIndex& a, const QModelIndex& b) {
+                  return a.row() > b.row();
+              });
+    for (const QModelIndex& index : rows) ui->table->removeRow(index.row());
+    preview();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  preview: count the variants and those already run  */
+void Optimization::preview() {
+    QVector<QVariantMap> variants;
+    QString error;
+    if (!generate(variants, error)) {
+        ui->status->setText(error);
+        return;
+    }
+    QJsonObject base = getBase();
+    QSet<QString> hashes;
+    int numDone = 0;
+    for (const QVariantMap& variant : variants) {
+        QString hash = hashConfig(configure(variant, base));
+        if (hashes.contains(hash) || isDone(hash)) ++numDone;
+        hashes.insert(hash);
+    }
+    ui->status->setText(QString("%1 variants, %2 already run or duplicated")
+                            .arg(variants.size())
+                            .arg(numDone));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  run: submit the variants that have not been run  */
+void Optimization::run() {
+    QString script = project->getPythonScript();
+    if (!QFile::exists(script)) {
+        ui->status->setText("The python script " + script + " is not found.");
+        return;
+    }
+    QVector<QVariantMap> variants;
+    QString error;
+    if (!generate(variants, error)) {
+        ui->status->setText(error);
+        return;
+    }
+
+    /*  each variant is run in the directory named by its hash  */
+    QJsonObject base = getBase();
+    QString name     = *project->getProjectName();
+    QString runDir   = *project->getWorkDirectory() + "/runs/";
+    QSet<QString> hashes;
+    int numSkipped = 0;
+    for (const QVariantMap& variant : variants) {
+        QJsonObject config = configure(variant, base);
+        QString hash       = hashConfig(config);
+        if (hashes.contains(hash) || isDone(hash)) {
+            ++numSkipped;
+            continue;
+        }
+        hashes.insert(hash);
+
+        //  the configuration read by the script from its work directory
+        QString dir = runDir + hash;
+        QFile file(dir + "/config.json");
+        if (!QDir().mkpath(dir) || !file.open(QIODevice::WriteOnly)) {
+            ui->status->setText("Failed to write " + file.fileName());
+            break;
+        }
+        file.write(QJsonDocument(config).toJson());
+        file.close();
+
+        //  the failed or canceled run is submitted again
+        Run* record = runs.value(hash, nullptr);
+        if (record == nullptr) {
+            record       = new Run;
+            record->hash = hash;
+            runs.insert(hash, record);
+        }
+        record->jobUid =
+            scheduler->submit(name + "_" + hash.left(8), dir, {script},
+                              ui->priority->value(), ui->cores->value());
+        record->directory = dir;
+        record->parameters =
+            QJsonDocument(QJsonObject::fromVariantMap(variant))
+                .toJson(QJsonDocument::Compact);
+        record->created = QDateTime::currentMSecsSinceEpoch();
+        record->state   = -1;
+        record->isDirty = true;
+    }
+    writeIndex();
+    listRuns();
+    ui->status->setText(QString("%1 variants submitted, %2 already run or "
+                                "duplicated")
+                            .arg(hashes.size())
+                            .arg(numSkipped));
+    scheduler->show();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onFinished: keep the final state of the run
+ *  @param  uid: the unique id of the job
+ *  @param  state: FINISHED, FAILED or CANCELED  */
+void Optimization::onFinished(const QString& uid, int state) {
+    for (Run* record : runs) {
+        if (record->jobUid != uid) continue;
+        record->state   = state;
+        record->isDirty = true;
+        writeIndex();
+        if (isVisible()) listRuns();
+        return;
+    }
+}
+
+/*  ############################################################################
+ *  parseValues: parse the values separated by commas, or the evenly spaced
+ *  values given by "start:stop:count"
+ *  @param  text: the text of the values
+ *  @param  values: the parsed values
+ *  @return  the status, true for success, otherwise failed  */
+bool Optimization::parseValues(const QString& text, QVector<double>& values) {
+    values.clear();
+    bool ok = true;
+
+    /*  the evenly spaced values  */
+    QStringList range = text.split(':');
+    if (range.size() == 3) {
+        double start = range[0].trimmed().toDouble(&ok);
+        if (!ok) return false;
+        double stop = range[1].trimmed().toDouble(&ok);
+        if (!ok) return false;
+        int count = range[2].trimmed().toInt(&ok);
+        if (!ok || count < 1) return false;
+        double step = count == 1 ? 0.0 : (stop - start) / (count - 1);
+        for (int i = 0; i < count; ++i) values.append(start + step * i);
+        return true;
+    }
+
+    /*  the listed values  */
+    for (const QString& field : text.split(',', Qt::SkipEmptyParts)) {
+        values.append(field.trimmed().toDouble(&ok));
+        if (!ok) return false;
+    }
+    return !values.isEmpty();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  generate: generate the variants of the sweep by the selected design
+ *  @param  variants: the values of the parameters by their keys
+ *  @param  error: the error message if failed
+ *  @return  the status, true for success, otherwise failed  */
+bool Optimization::generate(QVector<QVariantMap>& variants, QString& error) {
+    variants.clear();
+    int num = ui->table->rowCount();
+    if (num == 0) {
+        error = "No parameter is swept.";
+        return false;
+    }
+    QStringList keys;
+    QVector<QVector<double>> values(num);
+    for (int i = 0; i < num; ++i) {
+        keys << ui->table->item(i, 0)->data(Qt::UserRole).toString();
+        parseValues(ui->table->item(i, 1)->text(), values[i]);
+    }
+
+    /*  the combinations of all the values, the last parameter is the fastest,
+     *  and the count is checked before they are generated  */
+    if (ui->design->currentIndex() == 0) {
+        qint64 total = 1;
+        for (const QVector<double>& value : values) {
+            total *= value.size();
+            if (total > PRENANO::SWEEP_MAX_VARIANTS) break;
+        }
+        if (total > PRENANO::SWEEP_MAX_VARIANTS) {
+            error = QString("More than %1 variants are generated.")
+                        .arg(PRENANO::SWEEP_MAX_VARIANTS);
+            return false;
+        }
+        QVector<int> counter(num, 0);
+        variants.reserve(total);
+        for (qint64 n = 0; n < total; ++n) {
+            QVariantMap variant;
+            for (int i = 0; i < num; ++i) {
+                variant[keys[i]] = values[i][counter[i]];
+            }
+            variants.append(variant);
+            for (int i = num - 1; i >= 0; --i) {
+                if (++counter[i] < values[i].size()) break;
+                counter[i] = 0;
+            }
+        }
+        return true;
+    }
+
+    /*  the Latin hypercube in the range of the values of each parameter, one
+     *  sample in each of the equal intervals  */
+    int samples = ui->samples->value();
+    QRandomGenerator random(SWEEP_SEED);
+    variants.resize(samples);
+    QVector<int> strata(samples);
+    for (int i = 0; i < num; ++i) {
+        auto [low, high] =
+            std::minmax_element(values[i].begin(), values[i].end());
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), random);
+        for (int s = 0; s < samples; ++s) {
+            double ratio = (strata[s] + random.generateDouble()) / samples;
+            variants[s][keys[i]] = *low + (*high - *low) * ratio;
+        }
+    }
+    return true;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getBase: get the configuration shared by the variants, which includes the
+ *  script, its content hash and the properties of all the materials
+ *  @return  the configuration without the swept parameters  */
+QJsonObject Optimization::getBase() {
+    QJsonObject base;
+    QString script = project->getPythonScript();
+    base["mode"]   = "optimization";
+    base["script"] = script;
+    //  the edited script is run again
+    QFile file(script);
+    if (file.open(QIODevice::ReadOnly)) {
+        base["script_hash"] = QString(
+            QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha256)
+                .toHex());
+    }
+    QJsonObject materials;
+    for (const QVariantMap& properties : material->getMaterials()) {
+        QJsonObject object = QJsonObject::fromVariantMap(properties);
+        object.remove("name");
+        materials[properties.value("name").toString()] = object;
+    }
+    base["materials"] = materials;
+    return base;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  configure: get the complete configuration of the variant
+ *  @param  variant: the values of the parameters by their keys
+ *  @param  base: the configuration shared by the variants
+ *  @return  the configuration to be hashed and written  */
+QJsonObject Optimization::configure(const QVariantMap& variant,
+                                    const QJsonObject& base) {
+    QJsonObject parameters;
+    QJsonObject config    = base;
+    QJsonObject materials = base["materials"].toObject();
+    for (auto it = variant.begin(); it != variant.end(); ++it) {
+        //  the material property overrides that of the project
+        if (it.key().startsWith("material/")) {
+            QString name       = it.key().section('/', 1, -2);
+            QString column     = it.key().section('/', -1);
+            QJsonObject object = materials[name].toObject();
+            object[column]     = it.value().toDouble();
+            materials[name]    = object;
+        } else {
+            parameters[it.key()] = it.value().toDouble();
+        }
+    }
+    config["parameters"] = parameters;
+    config["materials"]  = materials;
+    return config;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  isDone: check whether the variant is finished, running or queued
+ *  @param  hash: the content hash of the configuration
+ *  @return  true if it needs not be submitted again  */
+bool Optimization::isDone(const QString& hash) {
+    Run* record = runs.value(hash, nullptr);
+    if (record == nullptr || !QDir(record->directory).exists()) return false;
+    //  the job removed from the queue is done only if it was finished
+    int state = scheduler->getState(record->jobUid);
+    if (state < 0) return record->state == Scheduler::FINISHED;
+    return state != Scheduler::FAILED && state != Scheduler::CANCELED;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  writeIndex: write the index of the runs in the work directory, with their
+ *  states and the latest result files
+ *  @return  the status, true for success, otherwise failed  */
+bool Optimization::writeIndex() {
+    //  the runs in the order of submission
+    QList<Run*> records = runs.values();
+    std::sort(records.begin(), records.end(), [](Run* a, Run* b) {
+        return a->created < b->created;
+    });
+    QJsonArray index;
+    for (Run* record : records) {
+        QJsonDocument parameters =
+            QJsonDocument::fromJson(record->parameters.toUtf8());
+        QJsonObject object;
+        object["hash"]       = record->hash;
+        object["job"]        = record->jobUid;
+        object["directory"]  = record->directory;
+        object["parameters"] = parameters.object();
+        object["created"]    = record->created;
+        //  the job in the queue has the latest state
+        int state = scheduler->getState(record->jobUid);
+        if (state < 0) state = record->state;
+        object["state"]  = state < 0 ? "unknown" : STATE_NAMES[state];
+        object["result"] = findResult(record->directory);
+        index.append(object);
+    }
+
+    QString dir = *project->getWorkDirectory() + "/runs";
+    QFile file(dir + "/index.json");
+    if (!QDir().mkpath(dir) || !file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(index).toJson());
+    return true;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  listRuns: list the runs of the index in the work directory
+ *  @return  the status, false if the index is not found  */
+bool Optimization::listRuns() {
+    ui->runTable->setRowCount(0);
+    QFile file(*project->getWorkDirectory() + "/runs/index.json");
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QJsonArray index = QJsonDocument::fromJson(file.readAll()).array();
+    ui->runTable->setRowCount(int(index.size()));
+    for (int i = 0; i < int(index.size()); ++i) {
+        QJsonObject object = index[i].toObject();
+        QString parameters = QJsonDocument(object["parameters"].toObject())
+                                 .toJson(QJsonDocument::Compact);
+        QString result     = object["result"].toString();
+        ui->runTable->setItem(i, 0, new QTableWidgetItem(parameters));
+        ui->runTable->setItem(
+            i, 1, new QTableWidgetItem(object["state"].toString()));
+        QTableWidgetItem* item =
+            new QTableWidgetItem(QFileInfo(result).fileName());
+        item->setData(Qt::UserRole, result);
+        ui->runTable->setItem(i, 2, item);
+    }
+    ui->runTable->resizeColumnsToContents();
+    return true;
+}
+
+/*  getSelectedResult: get the result file of the selected run
+ *  @return  the path of the result file, empty if there is none  */
+QString Optimization::getSelectedResult() {
+    int row = ui->runTable->currentRow();
+    if (row < 0) {
+        ui->status->setText("Select the run of the result.");
+        return "";
+    }
+    QString file = ui->runTable->item(row, 2)->data(Qt::UserRole).toString();
+    if (file.isEmpty() || !QFile::exists(file)) {
+        ui->status->setText("The selected run has no result yet.");
+        return "";
+    }
+    return file;
+}
+
+/*  findResult: find the latest result file in the run directory
+ *  @param  dir: the directory of the run
+ *  @return  the path of the result file, empty if there is none  */
+QString Optimization::findResult(const QString& dir) {
+    QFileInfoList files = QDir(dir).entryInfoList(
+        {"*.vtu", "*.pvtu", "*.rst"}, QDir::Files, QDir::Time);
+    return files.isEmpty() ? "" : files.first().absoluteFilePath();
+}
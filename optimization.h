@@ -1,22 +1,178 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : optimization.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
 #ifndef OPTIMIZATION_H
 #define OPTIMIZATION_H
 
 #include <QDialog>
+#include <QHash>
+#include <QJsonObject>
+#include <QShowEvent>
+#include <QVariantMap>
+#include <QVector>
+
+#include "autosave.h"
+#include "database.h"
+#include "material.h"
+#include "project.h"
+#include "scheduler.h"
 
 namespace Ui {
 class Optimization;
 }
 
-class Optimization : public QDialog
-{
+/*  ############################################################################
+ *  class Optimization: the parameter sweep of the topology optimization. The
+ *      values of the volume fraction, filter radius, penalty and material
+ *      properties are combined by the full factorial or the Latin hypercube
+ *      design, and each variant is written as config.json in its own run
+ *      directory, where the script of the project is run by the scheduler.
+ *      The configuration is hashed by its content and run in runs/<hash> of
+ *      the work directory, so the variant that has been run or is running
+ *      is never submitted again. The runs are indexed in the project file
+ *      and in runs/index.json with their states and results, which is
+ *      listed by the dialog so that the results are opened and compared by
+ *      the viewer.  */
+class Optimization : public QDialog {
     Q_OBJECT
 
+private:
+    class Run;                  // the indexed run of one variant
+
+    Ui::Optimization* ui;       // UI interface
+    Project* project;           // the project of the script and directory
+    Material* material;         // materials of the project
+    Scheduler* scheduler;       // queue of the solver jobs
+    QHash<QString, Run*> runs;  // runs indexed by the content hash
+
 public:
-    explicit Optimization(QWidget *parent = nullptr);
+    /*  ########################################################################
+     *  constructor: create the dialog of the parameter sweep
+     *  @param  parent: the parent widget
+     *  @param  project: the project of the script and directory
+     *  @param  material: materials of the project
+     *  @param  scheduler: queue of the solver jobs  */
+    Optimization(QWidget* parent, Project* project, Material* material,
+                 Scheduler* scheduler);
+
+    /*  destructor: release the runs  */
     ~Optimization();
 
+    /*  snapshot: append the new runs to the snapshot of the project, and
+     *  clear their dirty flags
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the runs rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, const bool isFull);
+
+    /*  loadProjectDatabase: replace the runs by those in the project file
+     *  @param  database: the database of the project  */
+    void loadProjectDatabase(Database* database);
+
+signals:
+    /*  opened: the result of the run is to be shown
+     *  @param  file: the path of the result file  */
+    void opened(const QString& file);
+
+    /*  compared: the result of the run is the reference of the shown one
+     *  @param  file: the path of the result file  */
+    void compared(const QString& file);
+
+protected:
+    /*  showEvent: list the parameters of the current materials  */
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    /*  ########################################################################
+     *  addParameter: add the values of the selected parameter to the sweep  */
+    void addParameter();
+
+    /*  removeParameter: remove the selected parameters from the sweep  */
+    void removeParameter();
+
+    /*  preview: count the variants and those already run  */
+    void preview();
+
+    /*  run: submit the variants that have not been run  */
+    void run();
+
+    /*  onFinished: keep the final state of the run
+     *  @param  uid: the unique id of the job
+     *  @param  state: FINISHED, FAILED or CANCELED  */
+    void onFinished(const QString& uid, int state);
+
 private:
-    Ui::Optimization *ui;
+    /*  ########################################################################
+     *  parseValues: parse the values separated by commas, or the evenly
+     *  spaced values given by "start:stop:count"
+     *  @param  text: the text of the values
+     *  @param  values: the parsed values
+     *  @return  the status, true for success, otherwise failed  */
+    bool parseValues(const QString& text, QVector<double>& values);
+
+    /*  generate: generate the variants of the sweep by the selected design
+     *  @param  variants: the values of the parameters by their keys
+     *  @param  error: the error message if failed
+     *  @return  the status, true for success, otherwise failed  */
+    bool generate(QVector<QVariantMap>& variants, QString& error);
+
+    /*  getBase: get the configuration shared by the variants, which includes
+     *  the script, its content hash and the properties of all the materials
+     *  @return  the configuration without the swept parameters  */
+    QJsonObject getBase();
+
+    /*  configure: get the complete configuration of the variant
+     *  @param  variant: the values of the parameters by their keys
+     *  @param  base: the configuration shared by the variants
+     *  @return  the configuration to be hashed and written  */
+    QJsonObject configure(const QVariantMap& variant, const QJsonObject& base);
+
+    /*  isDone: check whether the variant is finished, running or queued
+     *  @param  hash: the content hash of the configuration
+     *  @return  true if it needs not be submitted again  */
+    bool isDone(const QString& hash);
+
+    /*  writeIndex: write the index of the runs in the work directory, with
+     *  their states and the latest result files
+     *  @return  the status, true for success, otherwise failed  */
+    bool writeIndex();
+
+    /*  listRuns: list the runs of the index in the work directory
+     *  @return  the status, false if the index is not found  */
+    bool listRuns();
+
+    /*  getSelectedResult: get the result file of the selected run
+     *  @return  the path of the result file, empty if there is none  */
+    QString getSelectedResult();
+
+    /*  findResult: find the latest result file in the run directory
+     *  @param  dir: the directory of the run
+     *  @return  the path of the result file, empty if there is none  */
+    static QString findResult(const QString& dir);
 };
 
-#endif // OPTIMIZATION_H
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Optimization::Run: the run of the variant, its job and the directory
+ *  of the results  */
+class Optimization::Run {
+public:
+    QString hash;        // content hash of the configuration
+    QString jobUid;      // unique id of the job
+    QString directory;   // directory of the configuration and results
+    QString parameters;  // values of the swept parameters in JSON
+    qint64 created;      // time of the submission in ms since epoch
+    int state;           // final state of the job, -1 if not finished
+    bool isDirty;        // changed since the last snapshot
+};
+#endif  // OPTIMIZATION_H
@@ -15,6 +15,12 @@
  *  */
 #include "pacnano.h"
 
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileDialog>
+#include <QMessageBox>
+
 #include "./ui_pacnano.h"
 #include "prenano.h"
 using namespace PRENANO;
@@ -26,6 +32,7 @@ pacnano::pacnano(QWidget* parent) : QMainWindow(parent), ui(new Ui::pacnano) {
     /*  Open forder  */
     openDir = new Open(this, 0);
     openRst = new Open(this, 8);
+    openRef = new Open(this, 8);
     connect(ui->actProjOld, &QAction::triggered, openDir, &QDialog::show);
     connect(ui->actExit, &QAction::triggered, this, &QMainWindow::close);
 
@@ -36,6 +43,8 @@ pacnano::pacnano(QWidget* parent) : QMainWindow(parent), ui(new Ui::pacnano) {
     setupProject();           // create project
     setupModel();             // setup model environment
     setupMaterialCreation();  // material creation
+    setupMonitor();           // solver monitor
+    setupScheduler();         // solver jobs
     setupViewportSwitch();    // viewport setting
     setupRenderWindow();      // set up the vtk render window
 
@@ -57,6 +66,7 @@ pacnano::~pacnano() {
     delete project;   // project object
     delete material;  // material object
     delete renWin;    // render window
+    delete fields;    // loaded fields
 }
 
 /*  ############################################################################
@@ -82,6 +92,13 @@ void pacnano::setupViewportSwitch() {
         ui->vpSwtich, &QComboBox::currentIndexChanged, this, [&](int index) {
             ui->vpToolBar->setCurrentIndex(index);
             isInPostMode = index == 4 ? true : false;
+            //  the monitor page is shown in the monitor viewport
+            if (index == 5) {
+                ui->mainView->setCurrentWidget(monitor);
+            } else if (ui->mainView->currentWidget() == monitor) {
+                ui->mainView->setCurrentIndex(ui->viewWindow->isHidden() ? 0
+                                                                         : 1);
+            }
             ui->innerTool->setCurrentIndex(index == 4 ? (isFieldLoad ? 1 : 0)
                                                       : 0);
         });
@@ -118,7 +135,7 @@ void pacnano::setupViewportSwitch() {
         ui->vpSwtich->setCurrentIndex(5);
     });
     //  Function: remote server
-    connect(ui->actVpRemote, &QAction::triggered, remote, &QDialog::exec);
+    connect(ui->actVpRemote, &QAction::triggered, remote, &QDialog::show);
 }
 
 /*  ############################################################################
@@ -126,16 +143,26 @@ void pacnano::setupViewportSwitch() {
 void pacnano::setupProject() {
     /*  Create Project  */
     project = new Project(this);
+    //  the jobs belong to the opened project, which is kept while they run
+    auto isIdle = [&]() {
+        if (!scheduler->isRunning()) return true;
+        QMessageBox::critical(this, "ERROR",
+                              "The jobs of the project are running.\n"
+                              "Cancel them or wait for them to finish.");
+        return false;
+    };
     //  new project
-    connect(ui->actProjNew, &QAction::triggered, project,
-            &Project::createProjectNew);
-    connect(ui->btnProjNew, &QPushButton::clicked, project,
-            &Project::createProjectNew);
+    auto createNew = [=]() {
+        if (isIdle()) project->createProjectNew();
+    };
+    connect(ui->actProjNew, &QAction::triggered, this, createNew);
+    connect(ui->btnProjNew, &QPushButton::clicked, this, createNew);
     //  old project
-    connect(ui->actProjOld, &QAction::triggered, project,
-            &Project::createProjectOld);
-    connect(ui->btnProjOld, &QPushButton::clicked, project,
-            &Project::createProjectOld);
+    auto createOld = [=]() {
+        if (isIdle()) project->createProjectOld();
+    };
+    connect(ui->actProjOld, &QAction::triggered, this, createOld);
+    connect(ui->btnProjOld, &QPushButton::clicked, this, createOld);
 
     //  set the the projectname in Project ComboBox
     ui->projectName->setModel(project->getItemModel());
@@ -145,6 +172,23 @@ void pacnano::setupProject() {
             &Project::saveProject);
     connect(ui->actTopProjSave, &QAction::triggered, project,
             &Project::saveProject);
+    //  the models, materials and jobs are saved in the snapshot of the project
+    connect(
+        project, &Project::snapshot, this,
+        [&](QVector<Autosave::Record>& records, bool isFull) {
+            model->snapshot(records, isFull);
+            material->snapshot(records, isFull);
+            scheduler->snapshot(records, isFull);
+            sweep->snapshot(records, isFull);
+        },
+        Qt::DirectConnection);
+    //  the models and materials are read lazily from the opened project
+    connect(project, &Project::loading, this, [&](Database* database) {
+        model->loadProjectDatabase(database);
+        material->loadProjectDatabase(database);
+        scheduler->loadProjectDatabase(database);
+        sweep->loadProjectDatabase(database);
+    });
 
     //  delete project
     connect(ui->btnProjDel, &QToolButton::clicked, project,
@@ -205,6 +249,7 @@ void pacnano::setupMaterialCreation() {
     //  create material manager
     material  = new Material;
     matAssign = new MatAssign(this);
+    library   = new Library(this);
 
     //  Function: create new material
     connect(ui->actTopMatManage, &QAction::triggered, material,
@@ -219,6 +264,86 @@ void pacnano::setupMaterialCreation() {
     //  Function: assign material
     connect(ui->btnMatAssign, &QPushButton::clicked, matAssign,
             &MatAssign::show);
+    //  Function: search the material library and add to the project
+    connect(ui->actMatLibrary, &QAction::triggered, library, &QDialog::show);
+    connect(ui->btnMatLibrary, &QToolButton::clicked, library,
+            &QDialog::show);
+    connect(library, &Library::added, material, &Material::append);
+}
+
+/*  ============================================================================
+ *  setupMonitor: setup the monitor page of the solver logs and history  */
+void pacnano::setupMonitor() {
+    monitor = new Monitor(this);
+    ui->mainView->addWidget(monitor);
+
+    //  Function: select the logs and history files of the running solver
+    connect(ui->btnMonitorAna, &QToolButton::clicked, this, [&]() {
+        QStringList files = QFileDialog::getOpenFileNames(
+            this, "Monitor the solver", *project->getWorkDirectory(),
+            "Solver output (*.log *.out *.txt *.his *.csv *.dat);;"
+            "All files (*)");
+        if (files.isEmpty()) return;
+        monitor->setFiles(files);
+        ui->mainView->setCurrentWidget(monitor);
+    });
+    //  Function: show the series and logs
+    auto showPage = [&](const int page) {
+        ui->mainView->setCurrentWidget(monitor);
+        monitor->showPage(page);
+    };
+    connect(ui->btnMonitorObj, &QToolButton::clicked, this,
+            [=]() { showPage(Monitor::OBJECTIVE); });
+    connect(ui->btnMonitorConst, &QToolButton::clicked, this,
+            [=]() { showPage(Monitor::CONSTRAINT); });
+    connect(ui->btnMonitorHis, &QToolButton::clicked, this,
+            [=]() { showPage(Monitor::RESIDUAL); });
+    connect(ui->btnMonitorLogs, &QToolButton::clicked, this,
+            [=]() { showPage(Monitor::LOGS); });
+    //  Function: export the series
+    connect(ui->btnMonitorExport, &QToolButton::clicked, this, [&]() {
+        QString name = QFileDialog::getSaveFileName(
+            this, "Export the monitor", "", "CSV files (*.csv)");
+        if (!name.isEmpty()) monitor->exportFile(name);
+    });
+}
+
+/*  ============================================================================
+ *  setupScheduler: setup the local queue of the solver jobs and the parameter
+ *  sweep submitting to it  */
+void pacnano::setupScheduler() {
+    scheduler = new Scheduler(this);
+    sweep     = new Optimization(this, project, material, scheduler);
+
+    //  Function: show the queue of the jobs
+    connect(ui->btnAnaManager, &QToolButton::clicked, scheduler,
+            &QDialog::show);
+    connect(ui->btnOptMng, &QToolButton::clicked, scheduler, &QDialog::show);
+    connect(ui->actionAnaManager, &QAction::triggered, scheduler,
+            &QDialog::show);
+    //  Function: run the solver script of the project
+    auto run = [&](const QString& mode) {
+        QString script = project->getPythonScript();
+        if (!QFile::exists(script)) {
+            QMessageBox::critical(this, "ERROR",
+                                  "The python script\n" + script +
+                                      "\nis not found.");
+            return;
+        }
+        //  the name is unique so that each job has its own log
+        QString name =
+            *project->getProjectName() + "_" + mode + "_" +
+            QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss_zzz");
+        scheduler->submit(name, *project->getWorkDirectory(), {script});
+        scheduler->show();
+    };
+    connect(ui->actAnaRun, &QAction::triggered, this,
+            [=]() { run("analysis"); });
+    connect(ui->actOptRun, &QAction::triggered, this,
+            [=]() { run("optimization"); });
+    //  Function: sweep the parameters of the optimization
+    connect(ui->actCreateOpt, &QAction::triggered, sweep, &QDialog::show);
+    connect(ui->btnOptSweep, &QToolButton::clicked, sweep, &QDialog::show);
 }
 
 /*  ============================================================================
@@ -228,8 +353,21 @@ void pacnano::setupMaterialCreation() {
 void pacnano::setupRenderWindow() {
     /*  Create the render window  */
     renWin      = new Viewer(ui->viewWindow);
+    fields      = new Cache(FIELD_CACHE_BUDGET);
+    calculator  = new Calculator(this);
     isFieldLoad = false;
 
+    /*  show the frame time of the render window beside the messages of the
+     *  status bar  */
+    frameTime = new QLabel(this);
+    ui->statusbar->addPermanentWidget(frameTime);
+    connect(renWin, &Viewer::rendered, this, [&]() {
+        const double* time = renWin->getRenderTime();
+        frameTime->setText(QString("Frame %1 ms, average %2 ms")
+                               .arg(time[0], 0, 'f', 1)
+                               .arg(time[1], 0, 'f', 1));
+    });
+
     /*  ************************************************************************
      *  Open results files  */
     connect(ui->btnPostOpen, &QPushButton::clicked, openRst, &QDialog::show);
@@ -238,23 +376,15 @@ void pacnano::setupRenderWindow() {
         //  get the opened file name
         QString rstFile = "";
         openRst->getSelectContent(rstFile);
-        fields.append(new Field(rstFile));
-        renWin->setInputData(fields.last());
-        ui->mainView->setCurrentIndex(1);
-        ui->viewWindow->show();
-        //  assign the field name list
-        ui->fieldName->addItems(fields.last()->getFieldNameList());
-        ui->compName->addItems(fields.last()->getCompNameList());
-        ui->innerTool->setCurrentIndex(1);
-        //  assign the field data to the viewport
-        renWin->initPointField(ui->fieldName->currentIndex(),
-                               ui->compName->currentIndex(), FIELD_GENERATE);
-        renWin->showFieldGeometry();
-        isFieldLoad  = true;
-        bool* status = renWin->getFieldSwtichStatus();
-        ui->fieldName->setEnabled(status[0]);
-        ui->compName->setEnabled(status[1]);
+        showResult(rstFile);
     });
+    //  the results fetched from the remote server are opened likewise
+    connect(remote, &Remote::fetched, this,
+            [&](QString file) { showResult(file); });
+    //  the results of the sweep runs are opened and compared from its index
+    connect(sweep, &Optimization::opened, this,
+            [&](QString file) { showResult(file); });
+    connect(sweep, &Optimization::compared, this, &pacnano::compareResult);
 
     /*  ************************************************************************
      *  post configuration  */
@@ -263,6 +393,69 @@ void pacnano::setupRenderWindow() {
     connect(ui->btnPostConfig, &QPushButton::clicked, renWin,
             [&]() { renWin->configPost(); });
 
+    /*  ************************************************************************
+     *  field statistics  */
+    connect(ui->actStats, &QAction::triggered, renWin,
+            [&]() { renWin->showStats(); });
+    connect(ui->btnPostStats, &QToolButton::clicked, renWin,
+            [&]() { renWin->showStats(); });
+
+    /*  ************************************************************************
+     *  iso-surface of the density  */
+    connect(ui->actSmooth, &QAction::triggered, renWin,
+            [&]() { renWin->configIso(); });
+    connect(ui->btnSmooth, &QToolButton::clicked, renWin,
+            [&]() { renWin->configIso(); });
+
+    /*  ************************************************************************
+     *  probe of the field  */
+    connect(ui->actProbe, &QAction::triggered, renWin,
+            [&]() { renWin->showProbe(); });
+    connect(ui->btnPostProbe, &QToolButton::clicked, renWin,
+            [&]() { renWin->showProbe(); });
+
+    /*  ************************************************************************
+     *  section view  */
+    connect(ui->actSection, &QAction::toggled, renWin, [&](bool checked) {
+        ui->btnPostSection->setChecked(checked);
+        //  the section needs a loaded model, otherwise it is unchecked
+        if (renWin->activeSectionMode(checked) != checked) {
+            ui->statusbar->showMessage("No model is loaded for the section.");
+            ui->actSection->setChecked(false);
+        }
+    });
+    connect(ui->btnPostSection, &QToolButton::toggled, renWin,
+            [&](bool checked) { ui->actSection->setChecked(checked); });
+
+    /*  ************************************************************************
+     *  derived field calculator  */
+    connect(ui->actCalculator, &QAction::triggered, calculator, [&]() {
+        if (!isFieldLoad) return;
+        calculator->setInputData(fields->getCurrentField());
+        calculator->show();
+    });
+    connect(ui->btnPostCalc, &QToolButton::clicked, calculator, [&]() {
+        if (!isFieldLoad) return;
+        calculator->setInputData(fields->getCurrentField());
+        calculator->show();
+    });
+    connect(calculator, &Calculator::accepted, this,
+            [&]() { updateFieldList(calculator->getResultIndex()); });
+
+    /*  ************************************************************************
+     *  difference to the reference result  */
+    connect(ui->actDiff, &QAction::triggered, openRef, [&]() {
+        if (isFieldLoad) openRef->show();
+    });
+    connect(ui->btnPostDiff, &QToolButton::clicked, openRef, [&]() {
+        if (isFieldLoad) openRef->show();
+    });
+    connect(openRef, &Open::accepted, this, [&]() {
+        QString refFile = "";
+        openRef->getSelectContent(refFile);
+        compareResult(refFile);
+    });
+
     /*  ************************************************************************
      *  reflect configuration  */
     connect(ui->actReflect, &QAction::triggered, renWin,
@@ -443,3 +636,98 @@ void pacnano::setupRenderWindow() {
     connect(ui->btnCompleteCells, &QToolButton::clicked, renWin,
             [&]() { renWin->showCompleteModel(); });
 }
+
+/*  ============================================================================
+ *  showResult: load the result file through the field cache and show it in
+ *  the render window
+ *  @param  file: the path of the result file  */
+void pacnano::showResult(QString& file) {
+    Field* field = fields->getField(file);
+    if (field == nullptr) {
+        QMessageBox::critical(this, "ERROR",
+                              "The result file\n" + file +
+                                  "\ncannot be read.");
+        return;
+    }
+    renWin->setInputData(field);
+    //  the calculator always derives from the displayed field
+    calculator->setInputData(field);
+    ui->mainView->setCurrentIndex(1);
+    ui->viewWindow->show();
+    //  assign the field name list
+    ui->fieldName->clear();
+    ui->compName->clear();
+    ui->fieldName->addItems(field->getFieldNameList());
+    ui->compName->addItems(field->getCompNameList());
+    ui->innerTool->setCurrentIndex(1);
+    //  assign the field data to the viewport
+    renWin->initPointField(ui->fieldName->currentIndex(),
+                           ui->compName->currentIndex(), FIELD_GENERATE);
+    renWin->showFieldGeometry();
+    isFieldLoad  = true;
+    bool* status = renWin->getFieldSwtichStatus();
+    ui->fieldName->setEnabled(status[0]);
+    ui->compName->setEnabled(status[1]);
+}
+
+/*  ============================================================================
+ *  compareResult: subtract the reference result from the shown field without
+ *  changing the current field
+ *  @param  refFile: the path of the reference result  */
+void pacnano::compareResult(const QString& refFile) {
+    if (!isFieldLoad) {
+        ui->statusbar->showMessage("Open the result to be compared first.");
+        return;
+    }
+    //  the current result is never its own reference, and loading it again
+    //  would release the current field if the file is modified
+    Field* field = fields->getCurrentField();
+    if (refFile == field->getPathName()) {
+        ui->statusbar->showMessage(
+            "The current result cannot be its own reference.");
+        return;
+    }
+    Field* reference = fields->getField(refFile, false);
+    if (reference == nullptr) {
+        QMessageBox::critical(this, "ERROR",
+                              "The reference result\n" + refFile +
+                                  "\ncannot be read.");
+        return;
+    }
+    //  subtract the reference from the selected field
+    Diff diff(field, reference);
+    int idx = diff.compute(ui->fieldName->currentIndex());
+    if (idx < 0) {
+        QMessageBox::critical(this, "ERROR", diff.getError());
+        return;
+    }
+    ui->statusbar->showMessage(
+        diff.isSameTopology()
+            ? "Subtracted the reference " + refFile
+            : "The meshes differ, the reference " + refFile +
+                  " is interpolated");
+    updateFieldList(idx);
+}
+
+/*  ============================================================================
+ *  updateFieldList: list the fields again after a derived field has been
+ *  added, and show the specified field
+ *  @param  idx: the index of the field to be shown  */
+void pacnano::updateFieldList(const int idx) {
+    /*  list the fields without switching the viewport, the derived arrays
+     *  are kept in the cache meta data  */
+    Field* field = fields->getCurrentField();
+    fields->updateMeta(field);
+    ui->fieldName->blockSignals(true);
+    ui->fieldName->clear();
+    ui->fieldName->addItems(field->getFieldNameList());
+    ui->fieldName->setCurrentIndex(idx);
+    ui->fieldName->blockSignals(false);
+
+    /*  show the field  */
+    renWin->initPointField(idx, ui->compName->currentIndex(), FIELD_UPDATE);
+    renWin->showColorField();
+    bool* status = renWin->getFieldSwtichStatus();
+    ui->fieldName->setEnabled(status[0]);
+    ui->compName->setEnabled(status[1]);
+}
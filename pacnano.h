@@ -16,16 +16,24 @@
 #ifndef PACNANO_H
 #define PACNANO_H
 
+#include <QLabel>
 #include <QMainWindow>
 #include <QPushButton>
 #include <QStackedWidget>
 
+#include "cache.h"
+#include "calculator.h"
+#include "diff.h"
+#include "library.h"
 #include "matassign.h"
 #include "material.h"
 #include "model.h"
+#include "monitor.h"
 #include "open.h"
+#include "optimization.h"
 #include "project.h"
 #include "remote.h"
+#include "scheduler.h"
 #include "viewer.h"
 
 QT_BEGIN_NAMESPACE
@@ -42,13 +50,20 @@ private:
     Remote *remote;          // remote server login UI
     Open *openDir;           // open the directory
     Open *openRst;           // open the resutls files
+    Open *openRef;           // open the reference of the difference
     Project *project;        // pacnano project
     Model *model;            //  model object
     Material *material;      // material dialog
     Viewer *renWin;          // render window
     MatAssign *matAssign;    // material assignment
+    Library *library;        // shared material library
     QToolBar *innerToolBar;  // inner tool bar for user interaction
-    QList<Field *> fields;   // list of fields
+    Cache *fields;           // cache of the loaded fields
+    Calculator *calculator;  // calculator of the derived fields
+    Monitor *monitor;        // monitor of the running solver
+    Scheduler *scheduler;    // local queue of the solver jobs
+    Optimization *sweep;     // parameter sweep of the optimization
+    QLabel *frameTime;       // frame time of the render window
 
     bool isInPostMode;       // whether is in post mode
     bool isFieldLoad;        // whether field is load
@@ -74,9 +89,31 @@ private:
     /*  setupMaterialDialog: setup the material create dialog  */
     void setupMaterialCreation();
 
+    /*  setupMonitor: setup the monitor page of the solver logs and history  */
+    void setupMonitor();
+
+    /*  setupScheduler: setup the local queue of the solver jobs and the
+     *  parameter sweep submitting to it  */
+    void setupScheduler();
+
     /*  setupRenderWindow: setup the render window for the model displaying,
      *  such as show the geometry, mesh, rotate the viewport, and zoom the
      *  viewport and so on   */
     void setupRenderWindow();
+
+    /*  updateFieldList: list the fields again after a derived field has been
+     *  added, and show the specified field
+     *  @param  idx: the index of the field to be shown  */
+    void updateFieldList(const int idx);
+
+    /*  showResult: load the result file through the field cache and show it in
+     *  the render window
+     *  @param  file: the path of the result file  */
+    void showResult(QString& file);
+
+    /*  compareResult: subtract the reference result from the shown field
+     *  without changing the current field
+     *  @param  refFile: the path of the reference result  */
+    void compareResult(const QString& refFile);
 };
 #endif
@@ -0,0 +1,83 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : pacnanoserver.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QHostAddress>
+
+#include "prenano.h"
+#include "server.h"
+
+/*  ############################################################################
+ *  main: the stand-in result server, which serves the results of the local
+ *  directory, e.g., "pacnanoserver --root ./results --user me", so that the
+ *  remote results and their filtered surfaces can be tested on one
+ *  workstation. It only listens on the local host and requires the user
+ *  unless told otherwise  */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pacnanoserver");
+
+    /*  the options of the server  */
+    QCommandLineParser parser;
+    parser.setApplicationDescription("The result server of pacnano.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Directory of the results.", "dir",
+                                  QDir::currentPath());
+    QCommandLineOption listenOption("listen", "Address of the server.",
+                                    "address", "127.0.0.1");
+    QCommandLineOption portOption("port", "Port of the server.", "port",
+                                  QString::number(PRENANO::REMOTE_PORT));
+    QCommandLineOption userOption("user", "User name.", "name");
+    QCommandLineOption passwordOption(
+        "password", "Password, or the PACNANO_PASSWORD variable.", "password",
+        qEnvironmentVariable("PACNANO_PASSWORD"));
+    QCommandLineOption insecureOption(
+        "insecure", "Accept any user without the password.");
+    parser.addOptions({rootOption, listenOption, portOption, userOption,
+                       passwordOption, insecureOption});
+    parser.process(app);
+
+    /*  the results are not served to anyone without being asked  */
+    QHostAddress address;
+    if (!address.setAddress(parser.value(listenOption))) {
+        qCritical() << "Invalid address" << parser.value(listenOption);
+        return 1;
+    }
+    bool isInsecure = parser.isSet(insecureOption);
+    if (!isInsecure && (parser.value(userOption).isEmpty() ||
+                        parser.value(passwordOption).isEmpty())) {
+        qCritical() << "The user and the password are required, or start "
+                       "the server with --insecure.";
+        return 1;
+    }
+
+    /*  serve until it is killed  */
+    Server server(parser.value(rootOption),
+                  isInsecure ? QString() : parser.value(userOption),
+                  parser.value(passwordOption));
+    quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.listen(address, port)) {
+        qCritical() << "Failed to serve" << parser.value(rootOption)
+                    << server.getError();
+        return 1;
+    }
+    qInfo() << "Serving" << parser.value(rootOption) << "on"
+            << address.toString() << "port" << port;
+    if (isInsecure) qWarning() << "Any user is accepted without the password.";
+    return app.exec();
+}
@@ -0,0 +1,258 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : partition.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "partition.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QXmlStreamReader>
+#include <cstring>
+
+/*  ############################################################################
+ *  constructor: parse the piece sources of the pvtu file
+ *  @param  file: the path of the pvtu file  */
+Partition::Partition(const QString& file) {
+    name = file;
+    parseSources();
+}
+
+/*  destructor: release the pieces  */
+Partition::~Partition() {
+    for (vtkUnstructuredGrid* piece : pieces) {
+        if (piece != nullptr) piece->Delete();
+    }
+    pieces.clear();
+}
+
+/*  ============================================================================
+ *  parseSources: parse the sources of the pieces in the pvtu file, the sources
+ *  are relative to the directory of the pvtu file
+ *  @return  the status, true for success, otherwise failed  */
+bool Partition::parseSources() {
+    /*  open the pvtu file  */
+    QFile input(name);
+    if (!input.open(QIODevice::ReadOnly)) {
+        qDebug() << "Failed to open the partitioned file" << name;
+        return false;
+    }
+
+    /*  collect the sources of the pieces  */
+    QDir dir = QFileInfo(name).absoluteDir();
+    QXmlStreamReader xml(&input);
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isStartElement() && xml.name() == QLatin1String("Piece")) {
+            QString source = xml.attributes().value("Source").toString();
+            if (!source.isEmpty()) sources << dir.absoluteFilePath(source);
+        }
+    }
+    input.close();
+    return !xml.hasError() && !sources.isEmpty();
+}
+
+/*  readPieces: read the pieces concurrently, each piece is read by an
+ *  independent reader
+ *  @return  the status, true for success, otherwise failed  */
+bool Partition::readPieces() {
+    /*  prepare the storage of the pieces  */
+    std::vector<std::string> files;
+    for (const QString& source : sources) files.push_back(source.toStdString());
+    pieces.assign(files.size(), nullptr);
+
+    /*  read the pieces in the thread pool  */
+    vtkSMPTools::For(0, vtkIdType(files.size()),
+                     [&](vtkIdType begin, vtkIdType end) {
+                         for (vtkIdType i = begin; i < end; ++i) {
+                             vtkXMLUnstructuredGridReader* reader =
+                                 vtkXMLUnstructuredGridReader::New();
+                             reader->SetFileName(files[i].c_str());
+                             reader->Update();
+                             pieces[i] = vtkUnstructuredGrid::New();
+                             pieces[i]->ShallowCopy(reader->GetOutput());
+                             reader->Delete();
+                         }
+                     });
+
+    /*  check the pieces  */
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (pieces[i]->GetNumberOfCells() == 0 &&
+            pieces[i]->GetNumberOfPoints() == 0) {
+            qDebug() << "Empty piece of the partitioned file" << sources[i];
+        }
+    }
+    return !pieces.empty();
+}
+
+/*  ============================================================================
+ *  assemble: read the pieces concurrently and assemble the global ugrid, the
+ *  caller takes the ownership of the returned ugrid
+ *  @return  the global ugrid, nullptr if failed  */
+vtkUnstructuredGrid* Partition::assemble() {
+    /*  read the pieces  */
+    if (sources.isEmpty() || !readPieces()) return nullptr;
+    vtkIdType numPieces = vtkIdType(pieces.size());
+
+    /*  offsets of the points, cells and connectivity of each piece  */
+    std::vector<vtkIdType> pointStart(numPieces + 1, 0);
+    std::vector<vtkIdType> cellStart(numPieces + 1, 0);
+    std::vector<vtkIdType> connStart(numPieces + 1, 0);
+    for (vtkIdType i = 0; i < numPieces; ++i) {
+        pointStart[i + 1] = pointStart[i] + pieces[i]->GetNumberOfPoints();
+        cellStart[i + 1]  = cellStart[i] + pieces[i]->GetNumberOfCells();
+        connStart[i + 1] =
+            connStart[i] +
+            pieces[i]->GetCells()->GetNumberOfConnectivityIds();
+    }
+    vtkIdType numPoints = pointStart[numPieces];
+    vtkIdType numCells  = cellStart[numPieces];
+
+    /*  preallocate the global points and topology  */
+    vtkUnstructuredGrid* first = pieces[0];
+    vtkPoints* points          = vtkPoints::New();
+    if (first->GetPoints() != nullptr) {
+        points->SetDataType(first->GetPoints()->GetDataType());
+    }
+    points->SetNumberOfPoints(numPoints);
+    vtkIdTypeArray* offsets = vtkIdTypeArray::New();
+    offsets->SetNumberOfValues(numCells + 1);
+    offsets->SetValue(numCells, connStart[numPieces]);
+    vtkIdTypeArray* conn = vtkIdTypeArray::New();
+    conn->SetNumberOfValues(connStart[numPieces]);
+    vtkUnsignedCharArray* types = vtkUnsignedCharArray::New();
+    types->SetNumberOfValues(numCells);
+    vtkIntArray* pieceIds = vtkIntArray::New();
+    pieceIds->SetName("PieceId");
+    pieceIds->SetNumberOfValues(numCells);
+
+    /*  preallocate the global arrays that exist in all pieces  */
+    std::vector<vtkDataArray*> pointArrays, cellArrays;
+    for (int a = 0; a < first->GetPointData()->GetNumberOfArrays(); ++a) {
+        vtkDataArray* src = first->GetPointData()->GetArray(a);
+        bool isShared     = src != nullptr;
+        for (vtkIdType i = 1; i < numPieces && isShared; ++i) {
+            isShared =
+                pieces[i]->GetPointData()->GetArray(src->GetName()) != nullptr;
+        }
+        if (!isShared) continue;
+        vtkDataArray* dst = src->NewInstance();
+        dst->SetName(src->GetName());
+        dst->SetNumberOfComponents(src->GetNumberOfComponents());
+        dst->SetNumberOfTuples(numPoints);
+        pointArrays.push_back(dst);
+    }
+    for (int a = 0; a < first->GetCellData()->GetNumberOfArrays(); ++a) {
+        vtkDataArray* src = first->GetCellData()->GetArray(a);
+        bool isShared     = src != nullptr;
+        for (vtkIdType i = 1; i < numPieces && isShared; ++i) {
+            isShared =
+                pieces[i]->GetCellData()->GetArray(src->GetName()) != nullptr;
+        }
+        if (!isShared) continue;
+        vtkDataArray* dst = src->NewInstance();
+        dst->SetName(src->GetName());
+        dst->SetNumberOfComponents(src->GetNumberOfComponents());
+        dst->SetNumberOfTuples(numCells);
+        cellArrays.push_back(dst);
+    }
+
+    /*  copy the pieces to the disjoint ranges of the global arrays  */
+    auto copyArray = [](vtkDataArray* dst, vtkDataArray* src, vtkIdType start) {
+        if (src == nullptr || src->GetNumberOfTuples() == 0) return;
+        if (src->GetDataType() == dst->GetDataType()) {
+            int size = src->GetDataTypeSize() * src->GetNumberOfComponents();
+            std::memcpy(static_cast<char*>(dst->GetVoidPointer(0)) +
+                            start * size,
+                        src->GetVoidPointer(0),
+                        src->GetNumberOfTuples() * size);
+        } else {
+            for (vtkIdType t = 0; t < src->GetNumberOfTuples(); ++t) {
+                dst->SetTuple(start + t, t, src);
+            }
+        }
+    };
+    vtkSMPTools::For(0, numPieces, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i) {
+            vtkUnstructuredGrid* piece = pieces[i];
+
+            /*  points and data arrays  */
+            if (piece->GetPoints() != nullptr) {
+                copyArray(points->GetData(), piece->GetPoints()->GetData(),
+                          pointStart[i]);
+            }
+            for (vtkDataArray* dst : pointArrays) {
+                copyArray(dst, piece->GetPointData()->GetArray(dst->GetName()),
+                          pointStart[i]);
+            }
+            for (vtkDataArray* dst : cellArrays) {
+                copyArray(dst, piece->GetCellData()->GetArray(dst->GetName()),
+                          cellStart[i]);
+            }
+
+            /*  topology, the point ids are shifted by the point offset  */
+            vtkCellArray* cells = piece->GetCells();
+            vtkIdType pos       = connStart[i];
+            vtkIdType npts;
+            const vtkIdType* pts;
+            for (vtkIdType c = 0; c < piece->GetNumberOfCells(); ++c) {
+                cells->GetCellAtId(c, npts, pts);
+                offsets->SetValue(cellStart[i] + c, pos);
+                for (vtkIdType k = 0; k < npts; ++k) {
+                    conn->SetValue(pos++, pts[k] + pointStart[i]);
+                }
+                types->SetValue(cellStart[i] + c, piece->GetCellType(c));
+                pieceIds->SetValue(cellStart[i] + c, int(i));
+            }
+        }
+    });
+
+    /*  create the global ugrid  */
+    vtkCellArray* cellArray = vtkCellArray::New();
+    cellArray->SetData(offsets, conn);
+    vtkUnstructuredGrid* ugrid = vtkUnstructuredGrid::New();
+    ugrid->SetPoints(points);
+    ugrid->SetCells(types, cellArray);
+    for (vtkDataArray* dst : pointArrays) {
+        ugrid->GetPointData()->AddArray(dst);
+        dst->Delete();
+    }
+    for (vtkDataArray* dst : cellArrays) {
+        ugrid->GetCellData()->AddArray(dst);
+        dst->Delete();
+    }
+    ugrid->GetCellData()->AddArray(pieceIds);
+
+    /*  release the temporary variables and the pieces  */
+    cellArray->Delete();
+    pieceIds->Delete();
+    types->Delete();
+    conn->Delete();
+    offsets->Delete();
+    points->Delete();
+    for (vtkUnstructuredGrid* piece : pieces) piece->Delete();
+    pieces.clear();
+    return ugrid;
+}
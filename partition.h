@@ -0,0 +1,63 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : partition.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <vtkUnstructuredGrid.h>
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+/*  ############################################################################
+ *  class Partition: the reader of the partitioned result file (.pvtu) written
+ *      by the distributed solver. The pieces are read concurrently, and then
+ *      assembled to the preallocated global arrays without any append or
+ *      clean operation. The piece id of each cell is kept in the cell array
+ *      "PieceId".  */
+class Partition {
+private:
+    QString name;                             // path of the pvtu file
+    QStringList sources;                      // paths of the pieces
+    std::vector<vtkUnstructuredGrid*> pieces; // ugrid of each piece
+
+public:
+    /*  constructor: parse the piece sources of the pvtu file
+     *  @param  file: the path of the pvtu file  */
+    Partition(const QString& file);
+
+    /*  destructor: release the pieces  */
+    ~Partition();
+
+    /*  getNumberOfPieces: get the number of the pieces
+     *  @return  the number of the pieces  */
+    int getNumberOfPieces() { return sources.size(); }
+
+    /*  assemble: read the pieces concurrently and assemble the global ugrid,
+     *  the caller takes the ownership of the returned ugrid
+     *  @return  the global ugrid, nullptr if failed  */
+    vtkUnstructuredGrid* assemble();
+
+private:
+    /*  parseSources: parse the sources of the pieces in the pvtu file
+     *  @return  the status, true for success, otherwise failed  */
+    bool parseSources();
+
+    /*  readPieces: read the pieces concurrently
+     *  @return  the status, true for success, otherwise failed  */
+    bool readPieces();
+};
+#endif  // PARTITION_H
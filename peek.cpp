@@ -0,0 +1,448 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : peek.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "peek.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QThread>
+#include <QXmlStreamReader>
+
+#include "prenano.h"
+
+/*  ############################################################################
+ *  constructor: create an empty meta data  */
+Peek::Peek() {
+    fileSize  = 0;
+    stamp     = 0;
+    isValid   = false;
+    numPoints = 0;
+    numCells  = 0;
+    numPieces = 0;
+}
+
+/*  constructor: scan the meta data of the result file
+ *  @param  file: the path of the result file  */
+Peek::Peek(const QString& file) : Peek() {
+    QFileInfo info(file);
+    path     = file;
+    fileSize = info.size();
+    stamp    = info.lastModified().toMSecsSinceEpoch();
+    scan();
+}
+
+/*  ============================================================================
+ *  scan: read the XML header of the result file in chunks, the reading stops
+ *  at the start tag of the appended data so that the binary payload is never
+ *  passed to the XML parser  */
+void Peek::scan() {
+    /*  open the result file  */
+    QFile input(path);
+    if (!input.open(QIODevice::ReadOnly)) return;
+
+    /*  define the temporary variables  */
+    const qint64 chunk = 64 * 1024;  // size of each reading
+    const QByteArray tag = "<AppendedData";
+    QXmlStreamReader xml;            // incremental XML reader
+    QByteArray tail;                 // unparsed bytes of the last chunk
+    bool isFeedEnd   = false;        // all needed bytes have been fed
+    bool isDataArray = false;        // in the point data or cell data
+    bool isPointData = false;        // in the point data
+    bool isDone      = false;        // the scanning is finished
+
+    while (!isDone) {
+        xml.readNext();
+
+        /*  feed the next chunk to the XML reader  */
+        if (xml.error() == QXmlStreamReader::PrematureEndOfDocument) {
+            if (isFeedEnd || input.atEnd()) break;
+            QByteArray buffer = tail + input.read(chunk);
+            tail.clear();
+            int idx = buffer.indexOf(tag);
+            if (idx >= 0) {
+                //  stop at the end of the start tag of the appended data
+                int end = buffer.indexOf('>', idx);
+                if (end >= 0) {
+                    xml.addData(buffer.left(end + 1));
+                    isFeedEnd = true;
+                } else {
+                    xml.addData(buffer.left(idx));
+                    tail = buffer.mid(idx);
+                }
+            } else if (input.atEnd()) {
+                xml.addData(buffer);
+            } else {
+                //  keep the bytes that may be a part of the tag
+                xml.addData(buffer.left(buffer.size() - tag.size()));
+                tail = buffer.right(tag.size());
+            }
+            continue;
+        }
+        if (xml.hasError()) break;
+
+        /*  handle the start elements  */
+        if (xml.isStartElement()) {
+            QXmlStreamAttributes attr = xml.attributes();
+            if (xml.name() == QLatin1String("VTKFile")) {
+                isValid = attr.value("type") ==
+                              QLatin1String("UnstructuredGrid") ||
+                          attr.value("type") ==
+                              QLatin1String("PUnstructuredGrid");
+                if (!isValid) break;
+
+            } else if (xml.name() == QLatin1String("Piece")) {
+                if (attr.hasAttribute("Source")) {
+                    //  the pieces of the partitioned file are peeked
+                    QString source = QFileInfo(path).dir().filePath(
+                        attr.value("Source").toString());
+                    Peek piece(source);
+                    numPoints += piece.numPoints;
+                    numCells += piece.numCells;
+                } else {
+                    numPoints += attr.value("NumberOfPoints").toLongLong();
+                    numCells += attr.value("NumberOfCells").toLongLong();
+                }
+                numPieces++;
+
+            } else if (xml.name() == QLatin1String("PointData") ||
+                       xml.name() == QLatin1String("CellData")) {
+                //  only the arrays in the first piece are recorded
+                isDataArray = numPieces == 1;
+                isPointData = xml.name() == QLatin1String("PointData");
+
+            } else if (xml.name() == QLatin1String("PPointData") ||
+                       xml.name() == QLatin1String("PCellData")) {
+                //  arrays declared by the partitioned file
+                isDataArray = true;
+                isPointData = xml.name() == QLatin1String("PPointData");
+
+            } else if ((xml.name() == QLatin1String("DataArray") ||
+                        xml.name() == QLatin1String("PDataArray")) &&
+                       isDataArray) {
+                Array array;
+                array.name          = attr.value("Name").toString();
+                array.isPointData   = isPointData;
+                array.numComponents = 1;
+                if (attr.hasAttribute("NumberOfComponents")) {
+                    array.numComponents =
+                        attr.value("NumberOfComponents").toInt();
+                }
+                array.type     = attr.value("type").toString();
+                array.hasRange = attr.hasAttribute("RangeMin") &&
+                                 attr.hasAttribute("RangeMax");
+                array.range[0] = attr.value("RangeMin").toDouble();
+                array.range[1] = attr.value("RangeMax").toDouble();
+                array.offset   = -1;
+                if (attr.hasAttribute("offset")) {
+                    array.offset = attr.value("offset").toLongLong();
+                }
+                arrays << array;
+
+            } else if (xml.name() == QLatin1String("AppendedData")) {
+                isDone = true;
+            }
+
+        /*  handle the end elements  */
+        } else if (xml.isEndElement()) {
+            if (xml.name() == QLatin1String("PointData") ||
+                xml.name() == QLatin1String("CellData") ||
+                xml.name() == QLatin1String("PPointData") ||
+                xml.name() == QLatin1String("PCellData")) {
+                isDataArray = false;
+            }
+        }
+    }
+    input.close();
+}
+
+/*  ============================================================================
+ *  getArrayNames: get the names of the data arrays with components
+ *  @return  the names of the data arrays, e.g., "U(3), Var-0(1)"  */
+QString Peek::getArrayNames() const {
+    QStringList names;
+    for (const Array& array : arrays) {
+        names << QString("%1(%2)").arg(array.name).arg(array.numComponents);
+    }
+    return names.join(", ");
+}
+
+/*  getArrayRanges: get the stored ranges of the data arrays
+ *  @return  the ranges of the data arrays, e.g., "Var-0[0, 1]"  */
+QString Peek::getArrayRanges() const {
+    QStringList ranges;
+    for (const Array& array : arrays) {
+        if (!array.hasRange) continue;
+        ranges << QString("%1[%2, %3]")
+                      .arg(array.name)
+                      .arg(array.range[0], 0, 'g', 4)
+                      .arg(array.range[1], 0, 'g', 4);
+    }
+    return ranges.join(", ");
+}
+
+/*  getSummary: get the full description of the meta data
+ *  @return  the multi-line summary of the result file  */
+QString Peek::getSummary() const {
+    QLocale locale;
+    QStringList lines;
+    lines << QString("Size: %1").arg(locale.formattedDataSize(fileSize));
+    lines << QString("Pieces: %1").arg(numPieces);
+    lines << QString("Points: %1").arg(numPoints);
+    lines << QString("Cells: %1").arg(numCells);
+    for (const Array& array : arrays) {
+        QString line = QString("%1 %2 (%3 x %4)")
+                           .arg(array.isPointData ? "Point" : "Cell")
+                           .arg(array.name)
+                           .arg(array.type)
+                           .arg(array.numComponents);
+        if (array.hasRange) {
+            line += QString(": [%1, %2]")
+                        .arg(array.range[0], 0, 'g', 6)
+                        .arg(array.range[1], 0, 'g', 6);
+        }
+        lines << line;
+    }
+    return lines.join("\n");
+}
+
+/*  ############################################################################
+ *  constructor: create the proxy of the file system model
+ *  @param  source: the file system model
+ *  @param  parent: the parent object  */
+PeekModel::PeekModel(QFileSystemModel* source, QObject* parent)
+    : QIdentityProxyModel(parent) {
+    file          = source;
+    isScanEnabled = false;
+    suffixes << "rst"
+             << "vtu"
+             << "pvtu";
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    thumbPool.setMaxThreadCount(QThread::idealThreadCount());
+    setSourceModel(source);
+}
+
+/*  destructor: stop the scanning workers  */
+PeekModel::~PeekModel() {
+    pool.clear();
+    thumbPool.clear();
+    pool.waitForDone();
+    thumbPool.waitForDone();
+}
+
+/*  setScanEnabled: enable or disable the meta data columns, it should be
+ *  called before the model is assigned to the views
+ *  @param  status: true to scan the result files  */
+void PeekModel::setScanEnabled(const bool status) { isScanEnabled = status; }
+
+/*  getPeek: get the scanned meta data of the result file
+ *  @param  path: the path of the result file
+ *  @return  the meta data, nullptr if it has not been scanned  */
+const Peek* PeekModel::getPeek(const QString& path) const {
+    QHash<QString, Peek>::const_iterator it = peeks.constFind(path);
+    if (it == peeks.constEnd()) return nullptr;
+    return &it.value();
+}
+
+/*  isResultFile: check whether the file is a result file
+ *  @param  path: the path of the file
+ *  @return  true if the suffix is a result file  */
+bool PeekModel::isResultFile(const QString& path) const {
+    return suffixes.contains(QFileInfo(path).suffix().toLower());
+}
+
+/*  ============================================================================
+ *  overrides of the QIdentityProxyModel, the extra columns share the internal
+ *  pointer of the first column and have no source index  */
+int PeekModel::columnCount(const QModelIndex& parent) const {
+    int count = QIdentityProxyModel::columnCount(parent);
+    return isScanEnabled && count > 0 ? count + NUM_COLUMNS : count;
+}
+
+QModelIndex PeekModel::index(int row, int column,
+                             const QModelIndex& parent) const {
+    if (!isScanEnabled || column < numSourceColumns()) {
+        return QIdentityProxyModel::index(row, column, parent);
+    }
+    if (column >= columnCount(parent)) return QModelIndex();
+    QModelIndex first = QIdentityProxyModel::index(row, 0, parent);
+    if (!first.isValid()) return QModelIndex();
+    return createIndex(row, column, first.internalPointer());
+}
+
+QModelIndex PeekModel::parent(const QModelIndex& child) const {
+    if (!child.isValid() || child.column() < numSourceColumns()) {
+        return QIdentityProxyModel::parent(child);
+    }
+    return QIdentityProxyModel::parent(
+        createIndex(child.row(), 0, child.internalPointer()));
+}
+
+QModelIndex PeekModel::sibling(int row, int column,
+                               const QModelIndex& idx) const {
+    return index(row, column, parent(idx));
+}
+
+QModelIndex PeekModel::mapToSource(const QModelIndex& proxyIndex) const {
+    if (proxyIndex.isValid() && proxyIndex.column() >= numSourceColumns()) {
+        return QModelIndex();
+    }
+    return QIdentityProxyModel::mapToSource(proxyIndex);
+}
+
+QVariant PeekModel::data(const QModelIndex& index, int role) const {
+    /*  the columns of the file system model  */
+    if (!isScanEnabled) return QIdentityProxyModel::data(index, role);
+    bool isFirstRole = role == Qt::ToolTipRole || role == Qt::DecorationRole;
+    if (index.column() < numSourceColumns() &&
+        (index.column() != 0 || !isFirstRole)) {
+        return QIdentityProxyModel::data(index, role);
+    }
+    if (role != Qt::DisplayRole && !isFirstRole) return QVariant();
+
+    /*  check the result file  */
+    QModelIndex source = mapToSource(sibling(index.row(), 0, index));
+    QString path       = file->filePath(source);
+    if (file->isDir(source) || !isResultFile(path)) {
+        return QIdentityProxyModel::data(index, role);
+    }
+
+    qint64 stamp = file->lastModified(source).toMSecsSinceEpoch();
+
+    /*  render the thumbnail if it is not rendered or modified, the file icon
+     *  is used before the thumbnail is ready  */
+    if (role == Qt::DecorationRole) {
+        if (iconStamps.value(path, -1) != stamp) {
+            requestThumbnail(path);
+        } else if (!icons.value(path).isNull()) {
+            return icons.value(path);
+        }
+        return QIdentityProxyModel::data(index, role);
+    }
+
+    /*  scan the result file if it is not scanned or modified  */
+    const Peek* peek = getPeek(path);
+    if (peek == nullptr || peek->stamp != stamp) {
+        requestScan(path);
+        return role == Qt::DisplayRole ? QVariant("...") : QVariant();
+    }
+    if (!peek->isValid) return QVariant();
+
+    /*  assign the meta data  */
+    if (role == Qt::ToolTipRole) return peek->getSummary();
+    switch (index.column() - numSourceColumns()) {
+        case POINTS:
+            return peek->numPoints;
+        case CELLS:
+            return peek->numCells;
+        case ARRAYS:
+            return peek->getArrayNames();
+        case RANGES:
+            return peek->getArrayRanges();
+    }
+    return QVariant();
+}
+
+QVariant PeekModel::headerData(int section, Qt::Orientation orientation,
+                               int role) const {
+    if (!isScanEnabled || section < numSourceColumns() ||
+        orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QIdentityProxyModel::headerData(section, orientation, role);
+    }
+    switch (section - numSourceColumns()) {
+        case POINTS:
+            return tr("Points");
+        case CELLS:
+            return tr("Cells");
+        case ARRAYS:
+            return tr("Arrays");
+        case RANGES:
+            return tr("Ranges");
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags PeekModel::flags(const QModelIndex& index) const {
+    if (index.isValid() && index.column() >= numSourceColumns()) {
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    }
+    return QIdentityProxyModel::flags(index);
+}
+
+/*  ============================================================================
+ *  requestScan: scan the result file in the thread pool
+ *  @param  path: the path of the result file  */
+void PeekModel::requestScan(const QString& path) const {
+    if (pending.contains(path)) return;
+    pending.insert(path);
+
+    /*  the meta data is passed back to the GUI thread  */
+    PeekModel* model = const_cast<PeekModel*>(this);
+    model->pool.start([model, path]() {
+        Peek peek(path);
+        QMetaObject::invokeMethod(
+            model, [model, peek]() { model->finishScan(peek); },
+            Qt::QueuedConnection);
+    });
+}
+
+/*  finishScan: store the meta data and update the views
+ *  @param  peek: the scanned meta data  */
+void PeekModel::finishScan(const Peek& peek) {
+    pending.remove(peek.path);
+    peeks.insert(peek.path, peek);
+
+    /*  update the row of the result file  */
+    QModelIndex first = mapFromSource(file->index(peek.path, 0));
+    if (first.isValid()) {
+        int last = columnCount(first.parent()) - 1;
+        emit dataChanged(first, sibling(first.row(), last, first));
+    }
+    emit scanned(peek.path);
+}
+
+/*  ============================================================================
+ *  requestThumbnail: render the thumbnail of the result file in the thread
+ *  pool, the rendered images are cached in the disk
+ *  @param  path: the path of the result file  */
+void PeekModel::requestThumbnail(const QString& path) const {
+    if (thumbPending.contains(path)) return;
+    thumbPending.insert(path);
+
+    /*  the image is passed back to the GUI thread  */
+    PeekModel* model = const_cast<PeekModel*>(this);
+    model->thumbPool.start([model, path]() {
+        Thumbnail thumb(path, PRENANO::THUMBNAIL_SIZE);
+        QMetaObject::invokeMethod(
+            model, [model, thumb]() { model->finishThumbnail(thumb); },
+            Qt::QueuedConnection);
+    });
+}
+
+/*  finishThumbnail: store the thumbnail and update the views, a failed
+ *  thumbnail is stored as a null pixmap so that it is not rendered again
+ *  @param  thumb: the rendered thumbnail  */
+void PeekModel::finishThumbnail(const Thumbnail& thumb) {
+    thumbPending.remove(thumb.path);
+    icons.insert(thumb.path, QPixmap::fromImage(thumb.image));
+    iconStamps.insert(thumb.path, thumb.stamp);
+
+    /*  update the first column of the result file  */
+    QModelIndex first = mapFromSource(file->index(thumb.path, 0));
+    if (first.isValid()) {
+        emit dataChanged(first, first, {Qt::DecorationRole});
+    }
+}
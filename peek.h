@@ -0,0 +1,176 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : peek.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef PEEK_H
+#define PEEK_H
+
+#include <QDateTime>
+#include <QFileSystemModel>
+#include <QHash>
+#include <QIdentityProxyModel>
+#include <QList>
+#include <QPixmap>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+#include "thumbnail.h"
+
+/*  ############################################################################
+ *  class Peek: the meta data scanner of the vtu result files, only the XML
+ *      header before the appended data is read, and the payload of the data
+ *      arrays are never decoded.  */
+class Peek {
+public:
+    class Array;           // meta data of the data array
+
+public:
+    QString path;          // path of the result file
+    qint64 fileSize;       // size of the result file in bytes
+    qint64 stamp;          // modification time of the result file
+    bool isValid;          // is a valid unstructured grid file
+    qint64 numPoints;      // number of the points in all pieces
+    qint64 numCells;       // number of the cells in all pieces
+    int numPieces;         // number of the pieces
+    QList<Array> arrays;   // data arrays in the first piece
+
+public:
+    /*  constructor: create an empty meta data  */
+    Peek();
+
+    /*  constructor: scan the meta data of the result file
+     *  @param  file: the path of the result file  */
+    Peek(const QString& file);
+
+    /*  getArrayNames: get the names of the data arrays with components
+     *  @return  the names of the data arrays, e.g., "U(3), Var-0(1)"  */
+    QString getArrayNames() const;
+
+    /*  getArrayRanges: get the stored ranges of the data arrays
+     *  @return  the ranges of the data arrays, e.g., "Var-0[0, 1]"  */
+    QString getArrayRanges() const;
+
+    /*  getSummary: get the full description of the meta data
+     *  @return  the multi-line summary of the result file  */
+    QString getSummary() const;
+
+private:
+    /*  scan: read the XML header of the result file in chunks  */
+    void scan();
+};
+
+/*  ############################################################################
+ *  class Peek::Array: meta data of the data array  */
+class Peek::Array {
+public:
+    QString name;        // name of the array
+    bool isPointData;    // point data or cell data
+    int numComponents;   // number of the components
+    QString type;        // data type, e.g., Float64
+    bool hasRange;       // whether the range is stored in the file
+    double range[2];     // stored range, magnitude for multi-component
+    qint64 offset;       // offset in the appended data, -1 if inline
+};
+
+/*  ############################################################################
+ *  class PeekModel: the proxy model that appends the meta data columns to the
+ *      file system model. The result files are scanned by a thread pool on
+ *      demand, and the meta data are cached by the path and modification
+ *      time. The thumbnails of the result files are shown as the decoration
+ *      of the first column.  */
+class PeekModel : public QIdentityProxyModel {
+    Q_OBJECT
+
+private:
+    QFileSystemModel* file;                     // source file system model
+    bool isScanEnabled;                         // meta data is scanned
+    QThreadPool pool;                           // pool of the scanning workers
+    mutable QHash<QString, Peek> peeks;         // scanned meta data
+    mutable QSet<QString> pending;              // files being scanned
+    QStringList suffixes;                       // suffixes of the result files
+    QThreadPool thumbPool;                      // pool of thumbnail workers
+    mutable QHash<QString, QPixmap> icons;      // rendered thumbnails
+    mutable QHash<QString, qint64> iconStamps;  // time of thumbnails
+    mutable QSet<QString> thumbPending;         // thumbnails being rendered
+
+public:
+    /*  extra columns of the meta data  */
+    enum { POINTS = 0, CELLS, ARRAYS, RANGES, NUM_COLUMNS };
+
+    /*  ########################################################################
+     *  constructor: create the proxy of the file system model
+     *  @param  source: the file system model
+     *  @param  parent: the parent object  */
+    PeekModel(QFileSystemModel* source, QObject* parent = nullptr);
+
+    /*  destructor: stop the scanning workers  */
+    ~PeekModel();
+
+    /*  setScanEnabled: enable or disable the meta data columns
+     *  @param  status: true to scan the result files  */
+    void setScanEnabled(const bool status);
+
+    /*  getPeek: get the scanned meta data of the result file
+     *  @param  path: the path of the result file
+     *  @return  the meta data, nullptr if it has not been scanned  */
+    const Peek* getPeek(const QString& path) const;
+
+    /*  isResultFile: check whether the file is a result file
+     *  @param  path: the path of the file
+     *  @return  true if the suffix is a result file  */
+    bool isResultFile(const QString& path) const;
+
+public:
+    /*  overrides of the QIdentityProxyModel to append the extra columns  */
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex index(int row, int column,
+                      const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    QModelIndex sibling(int row, int column,
+                        const QModelIndex& idx) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QVariant data(const QModelIndex& index,
+                  int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+signals:
+    /*  scanned: the meta data of the result file is scanned
+     *  @param  path: the path of the result file  */
+    void scanned(const QString& path);
+
+private:
+    /*  requestScan: scan the result file in the thread pool
+     *  @param  path: the path of the result file  */
+    void requestScan(const QString& path) const;
+
+    /*  finishScan: store the meta data and update the views
+     *  @param  peek: the scanned meta data  */
+    void finishScan(const Peek& peek);
+
+    /*  requestThumbnail: render the thumbnail of the result file in the
+     *  thread pool
+     *  @param  path: the path of the result file  */
+    void requestThumbnail(const QString& path) const;
+
+    /*  finishThumbnail: store the thumbnail and update the views
+     *  @param  thumb: the rendered thumbnail  */
+    void finishThumbnail(const Thumbnail& thumb);
+
+    /*  numSourceColumns: get the number of columns of the source model  */
+    int numSourceColumns() const { return file->columnCount(); }
+};
+#endif  // PEEK_H
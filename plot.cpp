@@ -0,0 +1,286 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : plot.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "plot.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+#include <cmath>
+
+/*  margins of the chart area in pixels  */
+static const int MARGIN_LEFT   = 52;
+static const int MARGIN_RIGHT  = 12;
+static const int MARGIN_TOP    = 10;
+static const int MARGIN_BOTTOM = 34;
+
+/*  ############################################################################
+ *  constructor: create an empty plot
+ *  @param  parent: the parent widget  */
+Plot::Plot(QWidget* parent) : QWidget(parent) {
+    setMinimumSize(240, 160);
+    isZoomable = false;
+    isViewed   = false;
+    isDragged  = false;
+    clear();
+}
+
+/*  setLabels: set the labels of the axes
+ *  @param  x: label of the horizontal axis
+ *  @param  y: label of the vertical axis  */
+void Plot::setLabels(const QString& x, const QString& y) {
+    xLabel = x;
+    yLabel = y;
+    update();
+}
+
+/*  setBars: set the histogram bars with the uniform width
+ *  @param  bars: the heights of the bars
+ *  @param  range: the range covered by the bars  */
+void Plot::setBars(const QVector<double>& bars, const double range[2]) {
+    counts    = bars;
+    xRange[0] = range[0];
+    xRange[1] = range[1] > range[0] ? range[1] : range[0] + 1.0;
+    yRange[0] = 0.0;
+    yRange[1] = 1.0;
+    for (double count : counts) yRange[1] = std::max(yRange[1], count);
+    update();
+}
+
+/*  setCurve: set the XY curve, the invalid values break the curve
+ *  @param  x: the horizontal coordinates in ascending order
+ *  @param  y: the vertical coordinates  */
+void Plot::setCurve(const QVector<double>& x, const QVector<double>& y) {
+    counts.clear();
+    xs = x;
+    ys = y;
+
+    /*  the range of the valid values, only the visible ones in the view  */
+    xRange[0] = isViewed ? view[0] : x.isEmpty() ? 0.0 : x.first();
+    xRange[1] = isViewed ? view[1] : x.isEmpty() ? 1.0 : x.last();
+    yRange[0] = HUGE_VAL;
+    yRange[1] = -HUGE_VAL;
+    for (qsizetype i = 0; i < std::min(xs.size(), ys.size()); ++i) {
+        if (std::isnan(ys[i])) continue;
+        if (isViewed && (xs[i] < view[0] || xs[i] > view[1])) continue;
+        yRange[0] = std::min(yRange[0], ys[i]);
+        yRange[1] = std::max(yRange[1], ys[i]);
+    }
+    if (yRange[0] > yRange[1]) {
+        yRange[0] = 0.0;
+        yRange[1] = 1.0;
+    }
+    if (xRange[1] <= xRange[0]) xRange[1] = xRange[0] + 1.0;
+    if (yRange[1] <= yRange[0]) yRange[1] = yRange[0] + 1.0;
+    update();
+}
+
+/*  setMarker: show the vertical marker at the position
+ *  @param  x: the position of the marker  */
+void Plot::setMarker(const double x) {
+    isMarked = true;
+    marker   = x;
+    update();
+}
+
+/*  clear: remove the bars, curve and marker  */
+void Plot::clear() {
+    counts.clear();
+    xs.clear();
+    ys.clear();
+    xRange[0] = 0.0;
+    xRange[1] = 1.0;
+    yRange[0] = 0.0;
+    yRange[1] = 1.0;
+    isMarked  = false;
+    marker    = 0.0;
+    isViewed  = false;
+    update();
+}
+
+/*  setZoomable: allow the wheel and dragging to change the view
+ *  @param  flag: true to allow the zoom and pan  */
+void Plot::setZoomable(const bool flag) {
+    isZoomable = flag;
+    isDragged  = false;
+}
+
+/*  getView: get the horizontal range of the view set by the user
+ *  @param  range: the range of the view
+ *  @return  false if the full range is shown  */
+bool Plot::getView(double range[2]) const {
+    if (!isViewed) return false;
+    range[0] = view[0];
+    range[1] = view[1];
+    return true;
+}
+
+/*  ============================================================================
+ *  paintEvent: paint the axes, bars, curve and marker  */
+void Plot::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    QRectF area  = getChartArea();
+    double xSpan = xRange[1] - xRange[0];
+    double ySpan = yRange[1] - yRange[0];
+
+    /*  histogram bars  */
+    painter.setPen(QColor(40, 90, 160));
+    painter.setBrush(QColor(90, 150, 220));
+    double width = area.width() / std::max<qsizetype>(counts.size(), 1);
+    for (qsizetype i = 0; i < counts.size(); ++i) {
+        double bar = area.height() * (counts[i] - yRange[0]) / ySpan;
+        if (bar <= 0.0) continue;
+        painter.drawRect(
+            QRectF(area.left() + i * width, area.bottom() - bar, width, bar));
+    }
+
+    /*  curve, a new segment is started after the invalid values  */
+    QPainterPath path;
+    bool isBroken = true;
+    for (qsizetype i = 0; i < std::min(xs.size(), ys.size()); ++i) {
+        if (std::isnan(ys[i])) {
+            isBroken = true;
+            continue;
+        }
+        double x = area.left() + area.width() * (xs[i] - xRange[0]) / xSpan;
+        double y = area.bottom() - area.height() * (ys[i] - yRange[0]) / ySpan;
+        QPointF point(x, y);
+        if (isBroken) {
+            path.moveTo(point);
+        } else {
+            path.lineTo(point);
+        }
+        isBroken = false;
+    }
+    painter.save();
+    painter.setClipRect(area);
+    painter.setPen(QPen(QColor(40, 90, 160), 1.5));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPath(path);
+    painter.restore();
+
+    /*  axes and ticks  */
+    painter.setPen(Qt::black);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawLine(area.bottomLeft(), area.bottomRight());
+    painter.drawLine(area.bottomLeft(), area.topLeft());
+    for (int i = 0; i <= 4; ++i) {
+        //  horizontal ticks
+        double x = area.left() + i * area.width() / 4.0;
+        painter.drawLine(QPointF(x, area.bottom()),
+                         QPointF(x, area.bottom() + 4));
+        QString text = QString::number(xRange[0] + i * xSpan / 4.0, 'g', 4);
+        painter.drawText(QRectF(x - 40, area.bottom() + 4, 80, 14),
+                         Qt::AlignCenter, text);
+        //  vertical ticks
+        double y = area.bottom() - i * area.height() / 4.0;
+        painter.drawLine(QPointF(area.left() - 4, y), QPointF(area.left(), y));
+        text = QString::number(yRange[0] + i * ySpan / 4.0, 'g', 3);
+        painter.drawText(QRectF(0, y - 7, area.left() - 6, 14),
+                         Qt::AlignRight | Qt::AlignVCenter, text);
+    }
+
+    /*  labels of the axes  */
+    painter.drawText(QRectF(area.left(), height() - 16, area.width(), 16),
+                     Qt::AlignCenter, xLabel);
+    painter.save();
+    painter.translate(10, area.center().y());
+    painter.rotate(-90);
+    painter.drawText(QRectF(-area.height() / 2, -8, area.height(), 16),
+                     Qt::AlignCenter, yLabel);
+    painter.restore();
+
+    /*  marker  */
+    if (isMarked) {
+        double x = area.left() + area.width() * (marker - xRange[0]) / xSpan;
+        x        = std::clamp(x, area.left(), area.right());
+        painter.setPen(QPen(QColor(220, 40, 40), 2));
+        painter.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+    }
+}
+
+/*  mousePressEvent: emit the clicked position  */
+void Plot::mousePressEvent(QMouseEvent* event) {
+    QRectF area = getChartArea();
+    if (event->button() != Qt::LeftButton || area.width() <= 0.0) return;
+    double ratio = (event->position().x() - area.left()) / area.width();
+    ratio        = std::clamp(ratio, 0.0, 1.0);
+    emit clicked(xRange[0] + ratio * (xRange[1] - xRange[0]));
+
+    /*  start dragging the view  */
+    if (!isZoomable || counts.size() > 0) return;
+    isDragged   = true;
+    dragStart   = event->position().x();
+    dragView[0] = xRange[0];
+    dragView[1] = xRange[1];
+}
+
+/*  mouseMoveEvent: pan the view by dragging  */
+void Plot::mouseMoveEvent(QMouseEvent* event) {
+    QRectF area = getChartArea();
+    if (!isDragged || area.width() <= 0.0) return;
+    double shift = (event->position().x() - dragStart) / area.width() *
+                   (dragView[1] - dragView[0]);
+    setView(dragView[0] - shift, dragView[1] - shift);
+}
+
+/*  mouseReleaseEvent: stop dragging the view  */
+void Plot::mouseReleaseEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) isDragged = false;
+}
+
+/*  mouseDoubleClickEvent: restore the full range  */
+void Plot::mouseDoubleClickEvent(QMouseEvent* event) {
+    if (!isZoomable || !isViewed || event->button() != Qt::LeftButton) return;
+    isViewed  = false;
+    isDragged = false;
+    emit viewChanged();
+}
+
+/*  wheelEvent: zoom the view around the cursor  */
+void Plot::wheelEvent(QWheelEvent* event) {
+    QRectF area = getChartArea();
+    if (!isZoomable || counts.size() > 0 || area.width() <= 0.0) {
+        QWidget::wheelEvent(event);
+        return;
+    }
+    double ratio = (event->position().x() - area.left()) / area.width();
+    ratio        = std::clamp(ratio, 0.0, 1.0);
+    double pivot = xRange[0] + ratio * (xRange[1] - xRange[0]);
+    double scale = std::pow(0.999, event->angleDelta().y());
+    setView(pivot - (pivot - xRange[0]) * scale,
+            pivot + (xRange[1] - pivot) * scale);
+    event->accept();
+}
+
+/*  getChartArea: get the area inside the axes
+ *  @return  the rectangle of the chart area  */
+QRectF Plot::getChartArea() {
+    return QRectF(MARGIN_LEFT, MARGIN_TOP,
+                  width() - MARGIN_LEFT - MARGIN_RIGHT,
+                  height() - MARGIN_TOP - MARGIN_BOTTOM);
+}
+
+/*  setView: set the horizontal range of the view and notify it
+ *  @param  x0: the start of the view
+ *  @param  x1: the end of the view  */
+void Plot::setView(const double x0, const double x1) {
+    if (!(x1 > x0) || !std::isfinite(x0) || !std::isfinite(x1)) return;
+    isViewed = true;
+    view[0]  = x0;
+    view[1]  = x1;
+    emit viewChanged();
+}
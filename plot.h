@@ -0,0 +1,128 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : plot.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef PLOT_H
+#define PLOT_H
+
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QVector>
+#include <QWheelEvent>
+#include <QWidget>
+
+/*  ############################################################################
+ *  class Plot: the lightweight chart widget painted by QPainter, which shows
+ *      the histogram bars or the XY curve, and a vertical marker, e.g., the
+ *      threshold. The marker can be moved by clicking in the chart. The
+ *      zoomable plot is zoomed by the wheel and panned by dragging along the
+ *      horizontal axis, and the double click restores the full range.  */
+class Plot : public QWidget {
+    Q_OBJECT
+
+private:
+    QString xLabel;          // label of the horizontal axis
+    QString yLabel;          // label of the vertical axis
+
+    QVector<double> counts;  // heights of the histogram bars
+    QVector<double> xs;      // horizontal coordinates of the curve
+    QVector<double> ys;      // vertical coordinates of the curve
+    double xRange[2];        // range of the horizontal axis
+    double yRange[2];        // range of the vertical axis
+
+    bool isMarked;           // whether the marker is shown
+    double marker;           // position of the marker
+
+    bool isZoomable;         // whether the view can be zoomed and panned
+    bool isViewed;           // whether the view is set by the user
+    double view[2];          // horizontal range of the view
+    bool isDragged;          // whether the view is being dragged
+    double dragStart;        // position of the press in pixels
+    double dragView[2];      // view when the press happens
+
+public:
+    /*  ########################################################################
+     *  constructor: create an empty plot
+     *  @param  parent: the parent widget  */
+    explicit Plot(QWidget* parent = nullptr);
+
+    /*  setLabels: set the labels of the axes
+     *  @param  x: label of the horizontal axis
+     *  @param  y: label of the vertical axis  */
+    void setLabels(const QString& x, const QString& y);
+
+    /*  setBars: set the histogram bars with the uniform width
+     *  @param  bars: the heights of the bars
+     *  @param  range: the range covered by the bars  */
+    void setBars(const QVector<double>& bars, const double range[2]);
+
+    /*  setCurve: set the XY curve, the invalid values break the curve
+     *  @param  x: the horizontal coordinates in ascending order
+     *  @param  y: the vertical coordinates  */
+    void setCurve(const QVector<double>& x, const QVector<double>& y);
+
+    /*  setMarker: show the vertical marker at the position
+     *  @param  x: the position of the marker  */
+    void setMarker(const double x);
+
+    /*  clear: remove the bars, curve and marker  */
+    void clear();
+
+    /*  setZoomable: allow the wheel and dragging to change the view
+     *  @param  flag: true to allow the zoom and pan  */
+    void setZoomable(const bool flag);
+
+    /*  getView: get the horizontal range of the view set by the user
+     *  @param  range: the range of the view
+     *  @return  false if the full range is shown  */
+    bool getView(double range[2]) const;
+
+signals:
+    /*  clicked: the chart is clicked by the left button
+     *  @param  x: the position in the horizontal axis  */
+    void clicked(double x);
+
+    /*  viewChanged: the view is zoomed, panned or restored  */
+    void viewChanged();
+
+protected:
+    /*  paintEvent: paint the axes, bars, curve and marker  */
+    void paintEvent(QPaintEvent* event) override;
+
+    /*  mousePressEvent: emit the clicked position  */
+    void mousePressEvent(QMouseEvent* event) override;
+
+    /*  mouseMoveEvent: pan the view by dragging  */
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+    /*  mouseReleaseEvent: stop dragging the view  */
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+    /*  mouseDoubleClickEvent: restore the full range  */
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+    /*  wheelEvent: zoom the view around the cursor  */
+    void wheelEvent(QWheelEvent* event) override;
+
+private:
+    /*  getChartArea: get the area inside the axes
+     *  @return  the rectangle of the chart area  */
+    QRectF getChartArea();
+
+    /*  setView: set the horizontal range of the view and notify it
+     *  @param  x0: the start of the view
+     *  @param  x1: the end of the view  */
+    void setView(const double x0, const double x1);
+};
+#endif  // PLOT_H
@@ -63,8 +63,9 @@ Post::Post(QWidget *parent) : QDialog(parent), ui(new Ui::Post) {
         }
 
         //  legend configuration
-        numIntervals = ui->numIntervals->value();
-        isAutoLegend = ui->useAutoRange->isChecked() ? true : false;
+        numIntervals  = ui->numIntervals->value();
+        isAutoLegend  = ui->useAutoRange->isChecked() ? true : false;
+        isClipOutlier = isAutoLegend && ui->useClipOutlier->isChecked();
 
         //  active the accept signal
         accept();
@@ -93,6 +94,10 @@ Post::Post(QWidget *parent) : QDialog(parent), ui(new Ui::Post) {
         ui->upperLimit->setDisabled(true);
     });
 
+    /*  the outliers are only clipped for the automatic range  */
+    connect(ui->useAutoRange, &QRadioButton::toggled, ui->useClipOutlier,
+            &QCheckBox::setEnabled);
+
     /*  active the values of lower and upper limits  */
     connect(ui->useLowerLimit, &QCheckBox::stateChanged, this, [&](int state) {
         ui->lowerLimit->setEnabled(state == Qt::Checked);
@@ -138,6 +143,9 @@ void Post::reset() {
     ui->numIntervals->setValue(12);
     ui->useFixRange->setChecked(true);
     ui->useAutoRange->setChecked(false);
+    isClipOutlier = false;
+    ui->useClipOutlier->setChecked(false);
+    ui->useClipOutlier->setDisabled(true);
 }
 
 /*  ############################################################################
@@ -169,3 +177,8 @@ int Post::getNumIntervals() { return numIntervals; }
 /*  isUseAutoLegend: is the legend range is automatic or fixed
  *  @return   get the status of the legend range  */
 bool Post::isUseAutoLegend() { return isAutoLegend; }
+
+/*  isUseClipOutlier: is the automatic legend range clipped by the 1% and 99%
+ *  percentiles to exclude the outliers
+ *  @return  get the status of the outlier clipping  */
+bool Post::isUseClipOutlier() { return isClipOutlier; }
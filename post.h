@@ -36,6 +36,7 @@ private:
 
     int numIntervals;   // number of intervals
     bool isAutoLegend;  // if using automatic legend range
+    bool isClipOutlier; // if clipping the outliers of legend
 
 public:
     /*  ########################################################################
@@ -73,6 +74,11 @@ public:
      *  @return   get the status of the legend range  */
     bool isUseAutoLegend();
 
+    /*  isUseClipOutlier: is the automatic legend range clipped by the 1% and
+     *  99% percentiles to exclude the outliers
+     *  @return  get the status of the outlier clipping  */
+    bool isUseClipOutlier();
+
 private slots:
     /*  ########################################################################
      *  reset: reset the diag to the original  */
@@ -22,6 +22,69 @@ const bool USE_NODE_MODE = false;
 const bool FIELD_UPDATE   = false;
 const bool FIELD_GENERATE = true;
 
+/*  memory budget of the loaded fields in mebibytes  */
+const int FIELD_CACHE_BUDGET = 4096;
+
+/*  idle time in seconds before a loaded field array is released  */
+const int FIELD_IDLE_TIMEOUT = 300;
+
+/*  thumbnail size in pixels and triangle budget of the decimated surface  */
+const int THUMBNAIL_SIZE      = 96;
+const int THUMBNAIL_TRIANGLES = 20000;
+
+/*  divisions of the iso-surface clustering along each axis, and the number
+ *  of the smoothing iterations  */
+const int ISO_DIVISIONS         = 256;
+const int ISO_SMOOTH_ITERATIONS = 20;
+
+/*  maximum number of the arrows in the arrow field, and the magnitude below
+ *  which the arrows are culled relative to the maximum magnitude  */
+const int GLYPH_BUDGET    = 20000;
+const double GLYPH_CUTOFF = 0.01;
+
+/*  minimum interval in milliseconds between the coalesced renders  */
+const int RENDER_FRAME_INTERVAL = 16;
+
+/*  interval in milliseconds between the autosaves of the changed entities  */
+const int AUTOSAVE_INTERVAL = 60000;
+
+/*  bytes read from a monitored file per turn of the event loop, lines kept
+ *  in the log view, and leading bytes compared to detect a replaced file  */
+const int MONITOR_CHUNK_SIZE = 1 << 20;
+const int MONITOR_LOG_LINES  = 5000;
+const int MONITOR_HEAD_SIZE  = 64;
+
+/*  interpreter of the solver scripts, the launcher of the platform unless
+ *  the environment variable names another one  */
+#ifdef _WIN32
+const char JOB_PYTHON[] = "python";
+#else
+const char JOB_PYTHON[] = "python3";
+#endif
+const char JOB_PYTHON_ENV[] = "PACNANO_PYTHON";
+
+/*  interval in milliseconds between the samples of the running jobs, and
+ *  the grace period before a canceled job is killed  */
+const int JOB_SAMPLE_INTERVAL = 1000;
+const int JOB_KILL_TIMEOUT    = 5000;
+
+/*  maximum number of the variants generated by one parameter sweep  */
+const int SWEEP_MAX_VARIANTS = 10000;
+
+/*  default port of the result server, bytes of the streamed chunk, chunks
+ *  in flight per transfer, bytes compared before the resumed offset, and the
+ *  largest frame accepted from the socket  */
+const int REMOTE_PORT       = 6930;
+const int REMOTE_CHUNK_SIZE = 1 << 20;
+const int REMOTE_PIPELINE   = 4;
+const int REMOTE_CHECK_SIZE = 1 << 16;
+const int REMOTE_MAX_FRAME  = 1 << 26;
+
+/*  levels of the quantized coordinates of the remote surface, and the most
+ *  cells picked by one request  */
+const int SURFACE_LEVELS    = 65535;
+const int SURFACE_MAX_PICKS = 1 << 20;
+
 }  // namespace PRENANO
 
 #endif  // PRENANO_H
@@ -0,0 +1,294 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : probe.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "probe.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayRange.h>
+#include <vtkGenericCell.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+
+#include <QApplication>
+#include <QFile>
+#include <QFileDialog>
+#include <QTextStream>
+#include <cmath>
+#include <limits>
+
+#include "ui_probe.h"
+
+/*  ############################################################################
+ *  value: get the scalar value of the tuple, the magnitude is used for the
+ *  multi-component arrays  */
+template <typename TupleT>
+static double value(const TupleT& tuple, const int numComps) {
+    if (numComps == 1) return static_cast<double>(tuple[0]);
+    double sum = 0.0;
+    for (int c = 0; c < numComps; ++c) {
+        double comp = static_cast<double>(tuple[c]);
+        sum += comp * comp;
+    }
+    return std::sqrt(sum);
+}
+
+/*  InterpolateWorker: locate the samples by the cell locator in parallel and
+ *  interpolate the array by the weights of the located cells, the samples
+ *  outside the cells get NaN  */
+struct InterpolateWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, vtkDataSet* data,
+                    vtkStaticCellLocator* locator, const bool isPoint,
+                    const std::vector<double>& points,
+                    QVector<double>& out) {
+        /*  the generic cell and weights of each thread  */
+        vtkSMPThreadLocalObject<vtkGenericCell> cells;
+        vtkSMPThreadLocal<std::vector<double>> weights(
+            std::vector<double>(std::max(data->GetMaxCellSize(), 1)));
+        const auto tuples  = vtk::DataArrayTupleRange(array);
+        const int numComps = array->GetNumberOfComponents();
+
+        /*  the samples are independent of each other  */
+        vtkSMPTools::For(
+            0, out.size(), [&](vtkIdType begin, vtkIdType end) {
+                vtkGenericCell* cell   = cells.Local();
+                std::vector<double>& w = weights.Local();
+                int subId;
+                double pcoords[3];
+                for (vtkIdType i = begin; i < end; ++i) {
+                    double x[3] = {points[3 * i], points[3 * i + 1],
+                                   points[3 * i + 2]};
+                    vtkIdType id =
+                        locator->FindCell(x, 0.0, cell, subId, pcoords,
+                                          w.data());
+                    if (id < 0) {
+                        out[i] = std::numeric_limits<double>::quiet_NaN();
+                        continue;
+                    }
+                    if (isPoint) {
+                        double v = 0.0;
+                        for (vtkIdType k = 0; k < cell->GetNumberOfPoints();
+                             ++k) {
+                            v += w[k] *
+                                 value(tuples[cell->GetPointId(k)], numComps);
+                        }
+                        out[i] = v;
+                    } else {
+                        out[i] = value(tuples[id], numComps);
+                    }
+                }
+            });
+    }
+};
+
+/*  ############################################################################
+ *  constructor: create the Probe object  */
+Probe::Probe(QWidget* parent)
+    : QDialog(parent), ui(new Ui::Probe), field(nullptr), index(0), comp(0) {
+    /*  setup the UI interface  */
+    ui->setupUi(this);
+    plot = new Plot(this);
+    ui->plotLayout->addWidget(plot);
+    plot->setLabels("Distance", "Value");
+
+    /*  connect to the CLOSE button  */
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+
+    /*  connect to the PROBE and EXPORT buttons  */
+    connect(ui->btnProbe, &QPushButton::clicked, this, &Probe::evaluate);
+    connect(ui->btnExport, &QPushButton::clicked, this, &Probe::exportFile);
+
+    /*  edit the points of the probe  */
+    connect(ui->btnAdd, &QPushButton::clicked, this, [&]() {
+        double x[3] = {0.0, 0.0, 0.0};
+        addPoint(x);
+    });
+    connect(ui->btnRemove, &QPushButton::clicked, this, [&]() {
+        int row = ui->points->currentRow();
+        if (row < 0) row = ui->points->rowCount() - 1;
+        if (row >= 0) ui->points->removeRow(row);
+    });
+    connect(ui->btnPick, &QPushButton::toggled, this, &Probe::pickToggled);
+    connect(ui->mode, &QComboBox::currentIndexChanged, this,
+            [&](int mode) { ui->samples->setEnabled(mode == 0); });
+}
+
+/*  destructor: destroy the Probe object  */
+Probe::~Probe() { delete ui; }
+
+/*  ============================================================================
+ *  setInputData: set the field component to be probed, the probe is evaluated
+ *  again if the points have been given
+ *  @param  field: the field variables
+ *  @param  idx: the index of the field in the name list
+ *  @param  comp: the component of the nodal field  */
+void Probe::setInputData(Field* field, const int idx, const int comp) {
+    this->field = field;
+    this->index = idx;
+    this->comp  = comp;
+
+    /*  name of the field  */
+    QString name = field->getFieldName(idx);
+    if (idx < field->getNumberOfPointData()) {
+        name += QString(":") + field->getCompName(comp);
+    }
+    ui->fieldLabel->setText(name);
+    plot->setLabels("Distance", name);
+
+    /*  update the probe  */
+    if (!samples.empty()) evaluate();
+}
+
+/*  ============================================================================
+ *  addPoint: append the point to the probe, e.g., picked in the viewer
+ *  @param  x: the coordinates of the point  */
+void Probe::addPoint(const double x[3]) {
+    int row = ui->points->rowCount();
+    ui->points->insertRow(row);
+    for (int i = 0; i < 3; ++i) {
+        QString text = QString::number(x[i], 'g', 8);
+        ui->points->setItem(row, i, new QTableWidgetItem(text));
+    }
+    ui->points->setCurrentCell(row, 0);
+}
+
+/*  ============================================================================
+ *  evaluate: locate the samples and interpolate the field  */
+void Probe::evaluate() {
+    /*  check the field and samples  */
+    if (field == nullptr) return;
+    if (!sample()) {
+        ui->status->setText("At least one point is required");
+        return;
+    }
+
+    /*  the array in the displayed cells, the field is loaded on demand  */
+    bool isPoint = index < field->getNumberOfPointData();
+    if (field->getFieldArray(index, comp) == nullptr) return;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    vtkStaticCellLocator* locator = field->getCellLocator();
+    vtkDataSet* data              = locator->GetDataSet();
+    vtkDataArray* array;
+    if (isPoint) {
+        QString name = QString(field->getFieldName(index)) + ":" +
+                       field->getCompName(comp);
+        array = data->GetPointData()->GetArray(name.toStdString().c_str());
+    } else {
+        array = data->GetCellData()->GetArray(field->getFieldName(index));
+    }
+    if (array == nullptr || data->GetNumberOfCells() == 0) {
+        QApplication::restoreOverrideCursor();
+        ui->status->setText("No displayed cells to be probed");
+        return;
+    }
+
+    /*  locate and interpolate the samples  */
+    values.fill(0.0, distances.size());
+    InterpolateWorker worker;
+    if (!vtkArrayDispatch::Dispatch::Execute(array, worker, data, locator,
+                                             isPoint, samples, values)) {
+        worker(array, data, locator, isPoint, samples, values);
+    }
+
+    /*  show the curve  */
+    qsizetype outside = 0;
+    for (double v : values) outside += std::isnan(v) ? 1 : 0;
+    plot->setCurve(distances, values);
+    ui->status->setText(QString("%1 samples, %2 outside the cells")
+                            .arg(values.size())
+                            .arg(outside));
+    QApplication::restoreOverrideCursor();
+}
+
+/*  ============================================================================
+ *  exportFile: write the samples and values to the CSV file  */
+void Probe::exportFile() {
+    /*  check the result  */
+    if (values.isEmpty()) return;
+    QString name = QFileDialog::getSaveFileName(this, "Export the probe", "",
+                                                "CSV files (*.csv)");
+    if (name.isEmpty()) return;
+
+    /*  write the table  */
+    QFile file(name);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        ui->status->setText("Failed to write " + name);
+        return;
+    }
+    QTextStream out(&file);
+    out << "distance,x,y,z," << ui->fieldLabel->text() << "\n";
+    for (qsizetype i = 0; i < values.size(); ++i) {
+        out << distances[i] << "," << samples[3 * i] << ","
+            << samples[3 * i + 1] << "," << samples[3 * i + 2] << ",";
+        if (!std::isnan(values[i])) out << values[i];
+        out << "\n";
+    }
+    ui->status->setText("Exported to " + name);
+}
+
+/*  ============================================================================
+ *  sample: generate the samples from the points in the table, the line mode
+ *  resamples the polyline uniformly by the length
+ *  @return  the status, true if there is any sample  */
+bool Probe::sample() {
+    /*  points and the accumulated length of the polyline  */
+    std::vector<double> points;
+    QVector<double> lengths;
+    for (int row = 0; row < ui->points->rowCount(); ++row) {
+        for (int i = 0; i < 3; ++i) {
+            QTableWidgetItem* item = ui->points->item(row, i);
+            points.push_back(item == nullptr ? 0.0 : item->text().toDouble());
+        }
+        double length = 0.0;
+        for (int i = 0; row > 0 && i < 3; ++i) {
+            double d = points[3 * row + i] - points[3 * row + i - 3];
+            length += d * d;
+        }
+        lengths.push_back(row > 0 ? lengths.last() + std::sqrt(length) : 0.0);
+    }
+    samples.clear();
+    distances.clear();
+    if (lengths.isEmpty()) return false;
+
+    /*  the points are probed directly  */
+    if (ui->mode->currentIndex() == 1 || lengths.size() == 1) {
+        samples   = points;
+        distances = lengths;
+        return true;
+    }
+
+    /*  the uniform samples along the polyline  */
+    int num      = std::max(ui->samples->value(), 2);
+    double total = lengths.last();
+    samples.resize(3 * num);
+    distances.resize(num);
+    qsizetype segment = 1;
+    for (int i = 0; i < num; ++i) {
+        double s = total * i / (num - 1);
+        while (segment < lengths.size() - 1 && lengths[segment] < s) {
+            ++segment;
+        }
+        double span  = lengths[segment] - lengths[segment - 1];
+        double ratio = span > 0.0 ? (s - lengths[segment - 1]) / span : 0.0;
+        for (int k = 0; k < 3; ++k) {
+            double a           = points[3 * (segment - 1) + k];
+            double b           = points[3 * segment + k];
+            samples[3 * i + k] = a + ratio * (b - a);
+        }
+        distances[i] = s;
+    }
+    return true;
+}
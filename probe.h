@@ -0,0 +1,90 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : probe.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <QDialog>
+#include <QVector>
+#include <vector>
+
+#include "field.h"
+#include "plot.h"
+
+namespace Ui {
+class Probe;
+}
+
+/*  ############################################################################
+ *  class Probe: the panel to probe the field along the polyline or at the
+ *      given points of the displayed geometry. The samples are located by
+ *      the cached cell locator of the field in parallel, and the values are
+ *      interpolated by the shape functions of the located cells. The result
+ *      is plotted against the distance along the polyline and can be
+ *      exported as the CSV file.  */
+class Probe : public QDialog {
+    Q_OBJECT
+
+private:
+    Ui::Probe* ui;                // UI interface
+    Plot* plot;                   // curve of the probed values
+
+    Field* field;                 // field to be probed
+    int index;                    // index of the field in the name list
+    int comp;                     // component of the nodal field
+
+    std::vector<double> samples;  // coordinates of the samples
+    QVector<double> distances;    // distance of the samples along the line
+    QVector<double> values;       // probed values, NaN if outside
+
+public:
+    /*  ########################################################################
+     *  constructor: create the Probe object  */
+    explicit Probe(QWidget* parent = nullptr);
+
+    /*  destructor: destroy the Probe object  */
+    ~Probe();
+
+    /*  setInputData: set the field component to be probed, the probe is
+     *  evaluated again if the points have been given
+     *  @param  field: the field variables
+     *  @param  idx: the index of the field in the name list
+     *  @param  comp: the component of the nodal field  */
+    void setInputData(Field* field, const int idx, const int comp);
+
+    /*  addPoint: append the point to the probe, e.g., picked in the viewer
+     *  @param  x: the coordinates of the point  */
+    void addPoint(const double x[3]);
+
+signals:
+    /*  pickToggled: the picking of the points is turned on or off
+     *  @param  checked: true if the points are picked in the viewer  */
+    void pickToggled(bool checked);
+
+private slots:
+    /*  ########################################################################
+     *  evaluate: locate the samples and interpolate the field  */
+    void evaluate();
+
+    /*  exportFile: write the samples and values to the CSV file  */
+    void exportFile();
+
+private:
+    /*  sample: generate the samples from the points in the table, the line
+     *  mode resamples the polyline uniformly by the length
+     *  @return  the status, true if there is any sample  */
+    bool sample();
+};
+#endif  // PROBE_H
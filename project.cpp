@@ -15,6 +15,7 @@
  *  */
 #include "project.h"
 
+#include "prenano.h"
 #include "ui_project.h"
 
 /*  ############################################################################
@@ -29,10 +30,40 @@ Project::Project(QWidget *parent) : QDialog(parent), ui(new Ui::Project) {
     connect(msgbox, &QDialog::rejected, this, [&]() { choice = false; });
 
     /*  initialize the database  */
-    db      = QSqlDatabase::addDatabase("QSQLITE", "PROJECT");
-    name    = new QString("Project-0");
-    workDir = new QString(QDir::currentPath());
-    pyScr   = "*.py";
+    database = new Database;
+    name     = new QString("Project-0");
+    workDir  = new QString(QDir::currentPath());
+    pyScr    = "*.py";
+
+    /*  the changed entities are written periodically once saved  */
+    autosave = new Autosave(this);
+    //  the rolled back snapshot is written again with the next one, and the
+    //  failure is reported once until a snapshot is committed
+    isFailed = false;
+    connect(autosave, &Autosave::saved, this, [&]() { isFailed = false; });
+    connect(autosave, &Autosave::failed, this, [&](const QString& error) {
+        if (isFailed) return;
+        isFailed = true;
+        msgbox->showMessage(2, ":/icons/project_sve.png", "Saving Project",
+                            "The project cannot be saved: " + error +
+                                "\nThe changes are saved again with the "
+                                "next autosave.");
+    });
+    //  nothing is saved until the project is saved to a file again
+    connect(autosave, &Autosave::unopened, this,
+            [&](const QString& file, const QString& error) {
+                timer->stop();
+                isFailed = true;
+                msgbox->showMessage(2, ":/icons/project_sve.png",
+                                    "Saving Project",
+                                    "The project file\n" + file +
+                                        "\ncannot be opened: " + error +
+                                        "\nSave the project again after "
+                                        "the problem is solved.");
+            });
+    timer = new QTimer(this);
+    timer->setInterval(PRENANO::AUTOSAVE_INTERVAL);
+    connect(timer, &QTimer::timeout, this, &Project::autosaveProject);
 
     /*  Open dialog  */
     openDir = new Open(this, 0);
@@ -85,6 +116,7 @@ Project::~Project() {
     delete openPy;
     delete openProj;
     delete msgbox;
+    delete database;
 }
 
 /*  ############################################################################
@@ -221,27 +253,16 @@ void Project::writeProjectOld() {
 }
 
 /*  #########################################################################
- *  saveProject: save project to local database  */
+ *  saveProject: save project to local database, the project, models, sets
+ *  and materials are written in one transaction on the writer thread  */
 void Project::saveProject() {
     //  set the database name
     dbname = *workDir + "/" + *name + ".pac";
-    //  create the database
-    db.setDatabaseName(dbname);
-    if (!db.open()) {
-        qDebug() << "Failed to open the database" << db.lastError().text();
-    }
+    //  a new file is written completely, otherwise the changed entities
+    bool isFull = dbname != autosave->getFile();
 
-    //  create the query object
-    QSqlQuery query(db);
-
-    //  check if the table "PROJECT" exists
-    query.prepare(
-        "SELECT COUNT(*) FROM sqlite_master WHERE type=\"table\""
-        "AND name=\"project\";");
-    if (query.exec() && query.next()) {
-        //  check the table is exist or not?
-        ifDbExist = query.value(0).toInt() > 0 ? true : false;
-    }
+    //  check if another project has been saved to the file
+    ifDbExist = isFull && QFile::exists(dbname);
 
     //  handle the exist
     if (ifDbExist) {
@@ -250,81 +271,46 @@ void Project::saveProject() {
                             "The project\n" + dbname +
                                 "\nalreaty exist. Do you want to override it?");
         //  check if the "Override" is accepted
+        if (!choice) return;
     }
 
-    //  if doesnot exist the table PROJECT, then write new
-    if (!ifDbExist) {
-        query.exec(
-            "CREATE TABLE IF NOT EXISTS project "
-            "(id INTEGER PRIMARY KEY, "
-            "key TEXT, "
-            "value TEXT)");
-        if (query.lastError().isValid()) {
-            qDebug() << "Table creation failed:" << query.lastError().text();
-        }
+    //  the project, models, materials, jobs and runs in one transaction
+    QVector<Autosave::Record> records;
+    takeSnapshot(records, isFull);
+    autosave->setFile(dbname);
+    autosave->submit(records);
+    timer->start();
+}
 
-        //  define the insert command
-        query.prepare("INSERT INTO project (id, key, value) VALUES (?, ?, ?)");
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  autosaveProject: write the changed entities to the saved project, the
+ *  autosave is skipped while the previous snapshot is being written, and the
+ *  entities stay dirty until the next one  */
+void Project::autosaveProject() {
+    if (autosave->getFile().isEmpty() || autosave->isBusy()) return;
+    QVector<Autosave::Record> records;
+    emit snapshot(records, false);
+    autosave->submit(records);
+}
 
-        //  insert project name
-        query.bindValue(0, 0);
-        query.bindValue(1, "PROJECT_NAME");
-        query.bindValue(2, *name);
-        query.exec();
-        //  insert the work directory
-        query.bindValue(0, 1);
-        query.bindValue(1, "WORK_DIRECTORY");
-        query.bindValue(2, *workDir);
-        query.exec();
-        //  insert the work directory
-        query.bindValue(0, 2);
-        query.bindValue(1, "PYTHON_SCRIPT");
-        query.bindValue(2, pyScr);
-        query.exec();
-        if (query.lastError().isValid()) {
-            qDebug() << "Data insertion failed:" << query.lastError().text();
-        }
-        //  close the database
-        query.finish();
-        query.clear();
-        qDebug() << "a new database has been created.";
+/*  takeSnapshot: collect the project information and the entities
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write all the entities rather than the changed ones  */
+void Project::takeSnapshot(QVector<Autosave::Record>& records,
+                           const bool isFull) {
+    //  the project information
+    QString sql = "INSERT OR REPLACE INTO project (key, value) VALUES (?, ?)";
+    records.append({sql, {"PROJECT_NAME", *name}});
+    records.append({sql, {"WORK_DIRECTORY", *workDir}});
+    records.append({sql, {"PYTHON_SCRIPT", pyScr}});
+    //  the entities of the overridden project are removed
+    if (isFull) {
+        records.append({"DELETE FROM models", {}});
+        records.append({"DELETE FROM materials", {}});
+        records.append({"DELETE FROM jobs", {}});
+        records.append({"DELETE FROM runs", {}});
     }
-    //  the TABLE PROJECT exist, and will override the original
-    else {
-        if (choice) {
-            //  SQLite update command
-            query.prepare(
-                "UPDATE PROJECT SET key = :key, "
-                "value = :value WHERE id = :id");
-            //  update the project name
-            query.bindValue(":key", "PROJECT_NAME");
-            query.bindValue(":value", *name);
-            query.bindValue(":id", 0);
-            query.exec();
-            //  update the work directory
-            query.bindValue(":key", "WORK_DIRECTORY");
-            query.bindValue(":value", *workDir);
-            query.bindValue(":id", 1);
-            query.exec();
-            //  update the python script
-            query.bindValue(":key", "PYTHON_SCRIPT");
-            query.bindValue(":value", pyScr);
-            query.bindValue(":id", 2);
-            query.exec();
-            //  check the errors
-            if (query.lastError().isValid()) {
-                qDebug() << "Data insertion failed:"
-                         << query.lastError().text();
-            }
-            //  close the database
-            query.finish();
-            query.clear();
-            qDebug() << "the database has been overrided.";
-        }
-    }
-    //  close the database
-    QSqlDatabase::database().close();
-    db.close();
+    emit snapshot(records, isFull);
 }
 
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -332,35 +318,29 @@ void Project::saveProject() {
 void Project::loadProject() {
     //  set the database name
     dbname = savePath;
-    //  create the database
-    db.setDatabaseName(dbname);
-    if (!db.open()) {
-        qDebug() << "Failed to open the database" << db.lastError().text();
-    }
-    //  load the information of project
-    QSqlQuery query(db);
-    query.prepare("SELECT * FROM project;");
-    //  perform the query command
-    query.exec();
-    //  get the name of the project
-    query.next();
-    *name = query.value(2).toString();
-    qDebug() << *name;
-    //  get the work directory
-    query.next();
-    *workDir = query.value(2).toString();
-    qDebug() << workDir;
-    //  get the python script
-    query.next();
-    pyScr = query.value(2).toString();
-    qDebug() << pyScr;
+    //  open the database
+    if (!database->open(dbname)) return;
 
-    //  close the query
-    query.finish();
-    query.clear();
+    //  load the information of project
+    QSqlQuery* query = database->select("SELECT key, value FROM project");
+    while (query != nullptr && query->next()) {
+        QString key = query->value(0).toString();
+        if (key == "PROJECT_NAME") {
+            *name = query->value(1).toString();
+        } else if (key == "WORK_DIRECTORY") {
+            *workDir = query->value(1).toString();
+        } else if (key == "PYTHON_SCRIPT") {
+            pyScr = query->value(1).toString();
+        }
+    }
+    if (query != nullptr) query->finish();
+    qDebug() << *name << *workDir << pyScr;
 
-    //  close the database
-    db.close();
+    //  only the names are read, and the file stays open for the details
+    emit loading(database);
+    //  the project is saved incrementally to the opened file
+    autosave->setFile(dbname);
+    timer->start();
 }
 
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -372,6 +352,12 @@ void Project::deleteProject() {
         "The project \"" + *name + "\"will be removed.\n Continue or not?");
     //  handle the "delete" signla
     if (choice) {
+        //  release the file and its write-ahead log
+        timer->stop();
+        autosave->close();
+        database->close();
+        QFile::remove(dbname + "-wal");
+        QFile::remove(dbname + "-shm");
         QFile file(dbname);
         if (file.remove()) {
             qDebug() << "The file has been removed from the local.";
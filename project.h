@@ -17,10 +17,10 @@
 #define PROJECT_H
 
 #include <QDialog>
-#include <QtSql/QSqlDatabase>
-#include <QtSql/QSqlError>
-#include <QtSql/QSqlQuery>
+#include <QTimer>
 
+#include "autosave.h"
+#include "database.h"
 #include "messagebox.h"
 #include "open.h"
 
@@ -46,9 +46,12 @@ private:
     QString savePath;    // the path of the *.pac file
 
     int dbType;          // the type of the database
-    QSqlDatabase db;     // database to write the project information
+    Database* database;  // database to read the project information
+    Autosave* autosave;  // writer of the project snapshots
+    QTimer* timer;       // timer of the periodic autosave
     bool choice;         // the choice in message box
     bool ifDbExist;      // if the database is exist or not
+    bool isFailed;       // the failed autosave has been reported
     QString dbname;      // the name of database
     MessageBox* msgbox;  // message box to echo information
 
@@ -65,9 +68,24 @@ public:
     /*  getWorkDirectory: get the work directory of the project  */
     QString*& getWorkDirectory() { return workDir; }
 
+    /*  getPythonScript: get the path of the python script of the solver  */
+    const QString& getPythonScript() { return pyScr; }
+
     /*  getItemModel: get the item model object in Project  */
     QStandardItemModel* getItemModel() { return itemModel; }
 
+signals:
+    /*  snapshot: the models and materials append their statements to the
+     *  snapshot of the project, which is written in one transaction
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the entities rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, bool isFull);
+
+    /*  loading: the project file is opened, the models and materials read
+     *  their names from it and fetch the details on their first use
+     *  @param  database: the database of the project  */
+    void loading(Database* database);
+
 private slots:
     /*  set information from OPEN dialog to the current */
     void setWorkDir();     // work directory
@@ -78,6 +96,14 @@ private slots:
     void writeProjectOld();  // old project
     void writeProjectNew();  // new project
 
+    /*  autosaveProject: write the changed entities to the saved project  */
+    void autosaveProject();
+
+    /*  takeSnapshot: collect the project information and the entities
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the entities rather than the changed ones  */
+    void takeSnapshot(QVector<Autosave::Record>& records, const bool isFull);
+
 public slots:
     /*  open the dialog to set the work directory  */
     void createProjectNew();  // new project
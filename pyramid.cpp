@@ -0,0 +1,149 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : pyramid.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "pyramid.h"
+
+#include <algorithm>
+
+/*  number of the buckets merged into one bucket of the next level  */
+static const qsizetype BRANCH = 8;
+
+/*  ############################################################################
+ *  append: append the point and update the buckets containing it, the point
+ *  before the last abscissa is ignored
+ *  @param  x: the abscissa, e.g., the iteration
+ *  @param  y: the value  */
+void Pyramid::append(const double x, const double y) {
+    if (!xs.isEmpty() && x < xs.last()) return;
+    qsizetype idx = xs.size();
+    xs.append(x);
+    ys.append(y);
+
+    /*  update the last bucket of each level  */
+    Bucket point = {idx, idx, y, y};
+    qsizetype span = BRANCH;
+    for (QVector<Bucket>& level : levels) {
+        if (idx / span == level.size()) {
+            level.append(point);
+        } else {
+            level.last().merge(point);
+        }
+        span *= BRANCH;
+    }
+
+    /*  the top level is full  */
+    qsizetype numTop = levels.empty() ? xs.size() : levels.back().size();
+    if (numTop > BRANCH) addLevel();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  clear: remove all the points and levels  */
+void Pyramid::clear() {
+    xs.clear();
+    ys.clear();
+    levels.clear();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getRange: get the range of the abscissae
+ *  @param  range: the first and last abscissae
+ *  @return  false if there is no point  */
+bool Pyramid::getRange(double range[2]) const {
+    if (xs.isEmpty()) return false;
+    range[0] = xs.first();
+    range[1] = xs.last();
+    return true;
+}
+
+/*  ############################################################################
+ *  query: get the points to draw the range, the raw points are returned if
+ *  they are fewer than two per pixel, otherwise the minimum and the maximum of
+ *  the buckets in the order of their positions
+ *  @param  x0: the start of the range
+ *  @param  x1: the end of the range
+ *  @param  pixels: the width of the range in pixels
+ *  @param  x: the abscissae to be drawn
+ *  @param  y: the values to be drawn  */
+void Pyramid::query(const double x0, const double x1, const int pixels,
+                    QVector<double>& x, QVector<double>& y) const {
+    x.clear();
+    y.clear();
+    if (xs.isEmpty()) return;
+
+    /*  the visible points and one more on each side to reach the border  */
+    qsizetype first = std::lower_bound(xs.begin(), xs.end(), x0) - xs.begin();
+    qsizetype last  = std::upper_bound(xs.begin(), xs.end(), x1) - xs.begin();
+    first           = std::max<qsizetype>(first - 1, 0);
+    last            = std::min<qsizetype>(last + 1, xs.size());
+    qsizetype num   = last - first;
+
+    /*  the raw points  */
+    qsizetype budget = std::max(pixels, 1);
+    if (num <= 2 * budget || levels.empty()) {
+        x = xs.mid(first, num);
+        y = ys.mid(first, num);
+        return;
+    }
+
+    /*  the finest level with at most one bucket per pixel  */
+    qsizetype span = BRANCH;
+    size_t l       = 0;
+    while (l + 1 < levels.size() && num / span > budget) {
+        span *= BRANCH;
+        ++l;
+    }
+    const QVector<Bucket>& level = levels[l];
+    qsizetype end = std::min((last - 1) / span + 1, level.size());
+    x.reserve(2 * (end - first / span));
+    y.reserve(2 * (end - first / span));
+    for (qsizetype b = first / span; b < end; ++b) {
+        const Bucket& bucket = level[b];
+        qsizetype i0         = std::min(bucket.iMin, bucket.iMax);
+        qsizetype i1         = std::max(bucket.iMin, bucket.iMax);
+        x.append(xs[i0]);
+        y.append(ys[i0]);
+        if (i1 == i0) continue;
+        x.append(xs[i1]);
+        y.append(ys[i1]);
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  addLevel: add the coarser level on the top by merging the buckets of the
+ *  top level  */
+void Pyramid::addLevel() {
+    QVector<Bucket> level;
+    if (levels.empty()) {
+        //  the first level merges the points
+        for (qsizetype i = 0; i < xs.size(); ++i) {
+            Bucket point = {i, i, ys[i], ys[i]};
+            if (i % BRANCH == 0) {
+                level.append(point);
+            } else {
+                level.last().merge(point);
+            }
+        }
+    } else {
+        const QVector<Bucket>& top = levels.back();
+        for (qsizetype b = 0; b < top.size(); ++b) {
+            if (b % BRANCH == 0) {
+                level.append(top[b]);
+            } else {
+                level.last().merge(top[b]);
+            }
+        }
+    }
+    levels.push_back(level);
+}
@@ -0,0 +1,102 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : pyramid.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef PYRAMID_H
+#define PYRAMID_H
+
+#include <QVector>
+#include <vector>
+
+/*  ############################################################################
+ *  class Pyramid: the level-of-detail store of the time series. Each level
+ *      summarizes the consecutive buckets of the level below by their minimum
+ *      and maximum, and the levels are updated incrementally as the points
+ *      are appended. A query returns the min/max envelope of the visible
+ *      range from the level whose buckets are about one per pixel, so the
+ *      cost of drawing is bounded by the width of the chart rather than the
+ *      length of the series.  */
+class Pyramid {
+private:
+    /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+     *  class Bucket: the positions of the minimum and the maximum of the
+     *  consecutive points, and their values, it is defined before the levels
+     *  since the container needs the complete type  */
+    class Bucket {
+    public:
+        qsizetype iMin;  // index of the minimum
+        qsizetype iMax;  // index of the maximum
+        double yMin;     // the minimum
+        double yMax;     // the maximum
+
+    public:
+        /*  merge: merge the point or the bucket into the bucket
+         *  @param  other: the other bucket  */
+        void merge(const Bucket& other) {
+            if (other.yMin < yMin) {
+                yMin = other.yMin;
+                iMin = other.iMin;
+            }
+            if (other.yMax > yMax) {
+                yMax = other.yMax;
+                iMax = other.iMax;
+            }
+        }
+    };
+
+    QVector<double> xs;                   // abscissae in ascending order
+    QVector<double> ys;                   // values of the points
+    std::vector<QVector<Bucket>> levels;  // buckets of BRANCH^(l+1) points
+
+public:
+    /*  ########################################################################
+     *  append: append the point and update the buckets containing it, the
+     *  point before the last abscissa is ignored
+     *  @param  x: the abscissa, e.g., the iteration
+     *  @param  y: the value  */
+    void append(const double x, const double y);
+
+    /*  clear: remove all the points and levels  */
+    void clear();
+
+    /*  size: get the number of the points
+     *  @return  the number of the points  */
+    qsizetype size() const { return xs.size(); }
+
+    /*  getRange: get the range of the abscissae
+     *  @param  range: the first and last abscissae
+     *  @return  false if there is no point  */
+    bool getRange(double range[2]) const;
+
+    /*  getXs, getYs: get all the points at the full resolution  */
+    const QVector<double>& getXs() const { return xs; }
+    const QVector<double>& getYs() const { return ys; }
+
+    /*  query: get the points to draw the range, the raw points are returned
+     *  if they are fewer than two per pixel, otherwise the minimum and the
+     *  maximum of the buckets in the order of their positions
+     *  @param  x0: the start of the range
+     *  @param  x1: the end of the range
+     *  @param  pixels: the width of the range in pixels
+     *  @param  x: the abscissae to be drawn
+     *  @param  y: the values to be drawn  */
+    void query(const double x0, const double x1, const int pixels,
+               QVector<double>& x, QVector<double>& y) const;
+
+private:
+    /*  addLevel: add the coarser level on the top by merging the buckets of
+     *  the top level  */
+    void addLevel();
+};
+#endif  // PYRAMID_H
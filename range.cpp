@@ -0,0 +1,208 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : range.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "range.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkDataArrayRange.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+/*  number of the histogram bins for the percentiles  */
+static const int NUM_BINS = 4096;
+
+/*  maximum number of the cached arrays  */
+static const int MAX_CACHED = 512;
+
+/*  ############################################################################
+ *  value: get the scalar value of the tuple, the magnitude is used for the
+ *  multi-component arrays  */
+template <typename TupleT>
+static double value(const TupleT& tuple, const int numComps) {
+    if (numComps == 1) return static_cast<double>(tuple[0]);
+    double sum = 0.0;
+    for (int c = 0; c < numComps; ++c) {
+        double comp = static_cast<double>(tuple[c]);
+        sum += comp * comp;
+    }
+    return std::sqrt(sum);
+}
+
+/*  MinMaxWorker: the parallel reduction of the minimum and maximum  */
+struct MinMaxWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, double* range) {
+        /*  the local range of each thread  */
+        std::array<double, 2> exemplar = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
+        vtkSMPThreadLocal<std::array<double, 2>> local(exemplar);
+        const int numComps = array->GetNumberOfComponents();
+
+        /*  reduce the blocks  */
+        vtkSMPTools::For(0, array->GetNumberOfTuples(),
+                         [&](vtkIdType begin, vtkIdType end) {
+                             std::array<double, 2>& r = local.Local();
+                             for (const auto tuple :
+                                  vtk::DataArrayTupleRange(array, begin, end)) {
+                                 double v = value(tuple, numComps);
+                                 if (std::isnan(v)) continue;
+                                 r[0] = std::min(r[0], v);
+                                 r[1] = std::max(r[1], v);
+                             }
+                         });
+
+        /*  combine the local ranges  */
+        range[0] = VTK_DOUBLE_MAX;
+        range[1] = VTK_DOUBLE_MIN;
+        for (const std::array<double, 2>& r : local) {
+            range[0] = std::min(range[0], r[0]);
+            range[1] = std::max(range[1], r[1]);
+        }
+    }
+};
+
+/*  HistogramWorker: the parallel reduction of the histogram in the range  */
+struct HistogramWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, const double* range,
+                    std::vector<vtkIdType>& bins) {
+        /*  the local histogram of each thread  */
+        std::vector<vtkIdType> exemplar(NUM_BINS, 0);
+        vtkSMPThreadLocal<std::vector<vtkIdType>> local(exemplar);
+        const int numComps = array->GetNumberOfComponents();
+        const double scale = NUM_BINS / (range[1] - range[0]);
+
+        /*  reduce the blocks  */
+        vtkSMPTools::For(0, array->GetNumberOfTuples(),
+                         [&](vtkIdType begin, vtkIdType end) {
+                             std::vector<vtkIdType>& h = local.Local();
+                             for (const auto tuple :
+                                  vtk::DataArrayTupleRange(array, begin, end)) {
+                                 double v = value(tuple, numComps);
+                                 if (std::isnan(v)) continue;
+                                 int bin = int((v - range[0]) * scale);
+                                 h[std::clamp(bin, 0, NUM_BINS - 1)]++;
+                             }
+                         });
+
+        /*  combine the local histograms  */
+        bins.assign(NUM_BINS, 0);
+        for (const std::vector<vtkIdType>& h : local) {
+            for (int i = 0; i < NUM_BINS; ++i) bins[i] += h[i];
+        }
+    }
+};
+
+/*  percentile: find the value of the percentile from the histogram, the value
+ *  is linearly interpolated in the bin  */
+static double percentile(const std::vector<vtkIdType>& bins,
+                         const double* range, const double ratio) {
+    vtkIdType total = 0;
+    for (vtkIdType count : bins) total += count;
+    double target = ratio * total;
+    double width  = (range[1] - range[0]) / NUM_BINS;
+
+    /*  accumulate the bins until the target is reached  */
+    vtkIdType sum = 0;
+    for (int i = 0; i < NUM_BINS; ++i) {
+        if (bins[i] > 0 && sum + bins[i] >= target) {
+            double frac = (target - sum) / double(bins[i]);
+            return range[0] + (i + std::clamp(frac, 0.0, 1.0)) * width;
+        }
+        sum += bins[i];
+    }
+    return range[1];
+}
+
+/*  ############################################################################
+ *  constructor: create an empty range service  */
+Range::Range() {}
+
+/*  destructor: release the cached ranges  */
+Range::~Range() { clear(); }
+
+/*  ============================================================================
+ *  getRange: get the minimum and maximum of the array
+ *  @param  array: the data array
+ *  @param  range: the minimum and maximum  */
+void Range::getRange(vtkDataArray* array, double range[2]) {
+    Entry* entry = getEntry(array);
+    range[0]     = entry->range[0];
+    range[1]     = entry->range[1];
+}
+
+/*  getRobustRange: get the robust range of the array, i.e., the 1% and 99%
+ *  percentiles, which clips the outliers of the legend
+ *  @param  array: the data array
+ *  @param  range: the lower and upper percentiles  */
+void Range::getRobustRange(vtkDataArray* array, double range[2]) {
+    Entry* entry = getEntry(array);
+    range[0]     = entry->robust[0];
+    range[1]     = entry->robust[1];
+}
+
+/*  clear: release the cached ranges  */
+void Range::clear() {
+    qDeleteAll(cache);
+    cache.clear();
+}
+
+/*  ============================================================================
+ *  getEntry: get the cached entry, which is computed again if the array has
+ *  been modified since it was computed
+ *  @param  array: the data array
+ *  @return  the cached entry  */
+Range::Entry* Range::getEntry(vtkDataArray* array) {
+    /*  find the cached entry  */
+    Entry* entry = cache.value(array, nullptr);
+    if (entry != nullptr && entry->stamp == array->GetMTime()) return entry;
+
+    /*  create the entry, the cache is cleared if it is too large  */
+    if (entry == nullptr) {
+        if (cache.size() >= MAX_CACHED) clear();
+        entry = new Entry;
+        cache.insert(array, entry);
+    }
+    entry->stamp = array->GetMTime();
+
+    /*  compute the minimum and maximum  */
+    MinMaxWorker minMax;
+    if (!vtkArrayDispatch::Dispatch::Execute(array, minMax, entry->range)) {
+        minMax(array, entry->range);
+    }
+    if (entry->range[0] > entry->range[1]) {
+        entry->range[0] = 0.0;
+        entry->range[1] = 0.0;
+    }
+
+    /*  compute the percentiles from the histogram  */
+    entry->robust[0] = entry->range[0];
+    entry->robust[1] = entry->range[1];
+    if (entry->range[1] > entry->range[0]) {
+        std::vector<vtkIdType> bins;
+        HistogramWorker histogram;
+        if (!vtkArrayDispatch::Dispatch::Execute(array, histogram,
+                                                 entry->range, bins)) {
+            histogram(array, entry->range, bins);
+        }
+        entry->robust[0] = percentile(bins, entry->range, 0.01);
+        entry->robust[1] = percentile(bins, entry->range, 0.99);
+    }
+    return entry;
+}
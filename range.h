@@ -0,0 +1,71 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : range.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <vtkDataArray.h>
+
+#include <QHash>
+
+/*  ############################################################################
+ *  class Range: the range service of the field arrays. The minimum, maximum
+ *      and the robust percentiles are computed by the parallel reduction, and
+ *      cached by the modification time of the arrays. The magnitude is used
+ *      for the multi-component arrays.  */
+class Range {
+private:
+    class Entry;                          // cached range of an array
+    QHash<vtkDataArray*, Entry*> cache;   // cached ranges of the arrays
+
+public:
+    /*  ########################################################################
+     *  constructor: create an empty range service  */
+    Range();
+
+    /*  destructor: release the cached ranges  */
+    ~Range();
+
+    /*  getRange: get the minimum and maximum of the array
+     *  @param  array: the data array
+     *  @param  range: the minimum and maximum  */
+    void getRange(vtkDataArray* array, double range[2]);
+
+    /*  getRobustRange: get the robust range of the array, i.e., the 1% and
+     *  99% percentiles, which clips the outliers of the legend
+     *  @param  array: the data array
+     *  @param  range: the lower and upper percentiles  */
+    void getRobustRange(vtkDataArray* array, double range[2]);
+
+    /*  clear: release the cached ranges  */
+    void clear();
+
+private:
+    /*  getEntry: get the cached entry, which is computed again if the array
+     *  has been modified since it was computed
+     *  @param  array: the data array
+     *  @return  the cached entry  */
+    Entry* getEntry(vtkDataArray* array);
+};
+
+/*  ############################################################################
+ *  class Range::Entry: the cached range of an array  */
+class Range::Entry {
+public:
+    vtkMTimeType stamp;   // modification time of the array
+    double range[2];      // minimum and maximum
+    double robust[2];     // 1% and 99% percentiles
+};
+#endif  // RANGE_H
@@ -16,14 +16,54 @@
 
 #include "remote.h"
 
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
+#include <QStandardPaths>
+#include <algorithm>
 
+#include "channel.h"
+#include "prenano.h"
+#include "surface.h"
 #include "ui_remote.h"
 
-Remote::Remote(QWidget *parent) : QDialog(parent), ui(new Ui::Remote) {
+/*  parsePicks: parse the picked cells given by the ids and the ranges, e.g.,
+ *  0-99,150, the number of the cells is limited
+ *  @param  text: the text of the picked cells
+ *  @param  ids: the ids of the picked cells
+ *  @return  false if the text is invalid or there are too many cells  */
+static bool parsePicks(const QString& text, QVector<qint64>& ids) {
+    ids.clear();
+    for (const QString& item : text.split(',', Qt::SkipEmptyParts)) {
+        QStringList bounds = item.split('-');
+        if (bounds.size() > 2) return false;
+        bool ok      = false;
+        qint64 first = bounds[0].trimmed().toLongLong(&ok);
+        if (!ok || first < 0) return false;
+        qint64 last = first;
+        if (bounds.size() == 2) {
+            last = bounds[1].trimmed().toLongLong(&ok);
+            if (!ok || last < first) return false;
+        }
+        if (last - first >= PRENANO::SURFACE_MAX_PICKS - ids.size()) {
+            return false;
+        }
+        for (qint64 id = first; id <= last; ++id) ids << id;
+    }
+    return true;
+}
+
+/*  ############################################################################
+ *  constructor: create the dialog of the remote server
+ *  @param  parent: the parent widget  */
+Remote::Remote(QWidget* parent) : QDialog(parent), ui(new Ui::Remote) {
     /*  CREATE UI  */
     ui->setupUi(this);
+    download     = nullptr;
+    isExtracting = false;
+    expected     = 0;
 
     /*  CONNECTIONS  */
     //  calcel button
@@ -35,12 +75,357 @@ Remote::Remote(QWidget *parent) : QDialog(parent), ui(new Ui::Remote) {
         "(25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\."
         "(25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)\\."
         "(25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)$");
-    QRegularExpressionValidator ipValidator(ipRegExp, ui->ipAddr);
-    ui->ipAddr->setValidator(&ipValidator);
+    ui->ipAddr->setValidator(
+        new QRegularExpressionValidator(ipRegExp, ui->ipAddr));
+    ui->port->setValue(PRENANO::REMOTE_PORT);
 
     //  set the format of password
     ui->passWd->setEchoMode(QLineEdit::Password);
     ui->userName->setEchoMode(QLineEdit::Normal);
+
+    //  the entries of the remote directory
+    ui->files->setColumnCount(3);
+    ui->files->setHorizontalHeaderLabels({"Name", "Size", "Modified"});
+    connect(ui->files, &QTableWidget::cellDoubleClicked, this,
+            [&](int row, int) { openEntry(row); });
+    connect(ui->btnUp, &QPushButton::clicked, this,
+            [&]() { list(dir.section('/', 0, -2)); });
+    connect(ui->btnFetch, &QPushButton::clicked, this,
+            &Remote::fetchSelected);
+
+    //  the connection to the server
+    socket = new QTcpSocket(this);
+    connect(ui->btnConnect, &QPushButton::clicked, this,
+            &Remote::connectServer);
+    connect(socket, &QTcpSocket::readyRead, this, &Remote::onReadyRead);
+    connect(socket, &QTcpSocket::disconnected, this, &Remote::onDisconnected);
+    connect(socket, &QTcpSocket::errorOccurred, this,
+            [&]() { ui->status->setText(socket->errorString()); });
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: close the connection, the local copies are kept  */
+Remote::~Remote() {
+    socket->disconnect(this);
+    socket->abort();
+    release();
+    delete ui;
+}
+
+/*  getLocalPath: get the path of the local copy of the remote file, which is
+ *  kept in the cache directory of the server
+ *  @param  remote: the path relative to the root of the server
+ *  @param  local: the path of the local copy
+ *  @return  false if the path is out of the directory of the server  */
+bool Remote::getLocalPath(const QString& remote, QString& local) {
+    QString cache = QDir::cleanPath(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        "/remote");
+    QString root = QDir::cleanPath(cache + "/" + ui->ipAddr->text() + "_" +
+                                   QString::number(ui->port->value()));
+    if (!root.startsWith(cache + "/")) return false;
+    local = QDir::cleanPath(root + "/" + remote);
+    if (!local.startsWith(root + "/")) return false;
+    //  the links out of the directory are refused as well
+    QString canonical     = QFileInfo(local).canonicalFilePath();
+    QString canonicalRoot = QFileInfo(root).canonicalFilePath();
+    return canonical.isEmpty() || canonicalRoot.isEmpty() ||
+           canonical.startsWith(canonicalRoot + "/");
+}
+
+/*  ############################################################################
+ *  connectServer: connect to the server of the dialog  */
+void Remote::connectServer() {
+    socket->abort();
+    pending.clear();
+    ui->files->setRowCount(0);
+    ui->status->setText("Connecting to " + ui->ipAddr->text());
+    socket->connectToHost(ui->ipAddr->text(), quint16(ui->port->value()));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onReadyRead: handle the complete frames of the server  */
+void Remote::onReadyRead() {
+    quint8 type;
+    QByteArray payload;
+    while (Channel::receive(socket, type, payload)) {
+        QDataStream in(payload);
+        if (type == Channel::CHALLENGE) {
+            //  the password is only used to answer the challenge
+            QByteArray nonce;
+            in >> nonce;
+            QByteArray reply;
+            QDataStream out(&reply, QIODevice::WriteOnly);
+            out << ui->userName->text()
+                << Channel::digest(nonce, ui->passWd->text());
+            Channel::send(socket, Channel::HELLO, reply);
+        } else if (type == Channel::WELCOME) {
+            QString name;
+            in >> name;
+            ui->status->setText("Connected to " + name);
+            list("");
+        } else if (type == Channel::FAILURE) {
+            QString message;
+            in >> message;
+            ui->status->setText(message);
+            //  the failed transfer is skipped
+            if (isBusy()) {
+                release();
+                fetchNext();
+            }
+        } else if (type == Channel::LISTING) {
+            onListing(in);
+        } else if (type == Channel::DATA) {
+            onData(in);
+        } else if (type == Channel::END) {
+            onEnd(in);
+        } else if (type == Channel::SURFACE) {
+            onSurface(in);
+        }
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onDisconnected: release the transfer, its local copy is kept  */
+void Remote::onDisconnected() {
+    if (isBusy()) {
+        ui->status->setText("Disconnected, " + path +
+                            " is resumed by the next fetch");
+    } else {
+        ui->status->setText("Disconnected");
+    }
+    release();
+    pending.clear();
 }
 
-Remote::~Remote() { delete ui; }
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  fetchSelected: fetch the selected files in the order of the list  */
+void Remote::fetchSelected() {
+    QModelIndexList rows = ui->files->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end());
+    for (const QModelIndex& index : rows) {
+        QTableWidgetItem* item = ui->files->item(index.row(), 0);
+        if (item->data(Qt::UserRole).toBool()) continue;
+        pending << (dir.isEmpty() ? "" : dir + "/") + item->text();
+    }
+    if (!isBusy()) fetchNext();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  openEntry: list the directory or fetch the file of the row
+ *  @param  row: the row of the entry  */
+void Remote::openEntry(const int row) {
+    QTableWidgetItem* item = ui->files->item(row, 0);
+    QString remote = (dir.isEmpty() ? "" : dir + "/") + item->text();
+    if (item->data(Qt::UserRole).toBool()) {
+        list(remote);
+        return;
+    }
+    pending << remote;
+    if (!isBusy()) fetchNext();
+}
+
+/*  ############################################################################
+ *  list: request the entries of the remote directory
+ *  @param  remote: the directory relative to the root of the server  */
+void Remote::list(const QString& remote) {
+    if (socket->state() != QAbstractSocket::ConnectedState) return;
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << remote;
+    Channel::send(socket, Channel::LIST, payload);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  fetchNext: request the next pending file from the end of its local copy,
+ *  the server sends it again if the local copy is changed  */
+void Remote::fetchNext() {
+    if (pending.isEmpty()) return;
+    path     = pending.takeFirst();
+    expected = sizes.value(path, 0);
+    if (ui->groupSurface->isChecked()) {
+        extract(path);
+        return;
+    }
+
+    //  the local copy is opened without being truncated
+    QString local;
+    if (!getLocalPath(path, local)) {
+        ui->status->setText("Refused the path " + path);
+        release();
+        fetchNext();
+        return;
+    }
+    QDir().mkpath(QFileInfo(local).absolutePath());
+    download = new QFile(local);
+    if (!download->open(QIODevice::ReadWrite)) {
+        ui->status->setText("Failed to write " + local);
+        release();
+        fetchNext();
+        return;
+    }
+    qint64 offset = download->size();
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << path << offset << Channel::hashTail(download, offset);
+    Channel::send(socket, Channel::READ, payload);
+    ui->status->setText("Fetching " + path);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  extract: request the external surface of the file filtered by the
+ *  parameters of the dialog
+ *  @param  remote: the file relative to the root of the server  */
+void Remote::extract(const QString& remote) {
+    Surface::Request request;
+    request.path      = remote;
+    request.name      = ui->fieldName->text().trimmed();
+    request.warpScale = ui->warpScale->value();
+    request.limitType = ui->limitType->currentIndex();
+    request.lower     = ui->lowerLimit->value();
+    request.upper     = ui->upperLimit->value();
+    request.planes[0] = ui->mirrorXY->isChecked();
+    request.planes[1] = ui->mirrorYZ->isChecked();
+    request.planes[2] = ui->mirrorXZ->isChecked();
+
+    //  the picked cells are given by the ids and the ranges, e.g. 0-99,150
+    request.isPickHidden = ui->pickHide->isChecked();
+    if (!parsePicks(ui->pickCells->text(), request.pickIds)) {
+        ui->status->setText(
+            QString("Invalid picked cells, at most %1 cells in ascending "
+                    "ranges: %2")
+                .arg(PRENANO::SURFACE_MAX_PICKS)
+                .arg(ui->pickCells->text()));
+        pending.clear();
+        return;
+    }
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    request.write(out);
+    Channel::send(socket, Channel::EXTRACT, payload);
+    isExtracting = true;
+    ui->progress->setValue(0);
+    ui->status->setText("Extracting the surface of " + path);
+}
+
+/*  ============================================================================
+ *  onListing: show the entries of the directory
+ *  @param  in: the payload of the frame  */
+void Remote::onListing(QDataStream& in) {
+    quint32 num;
+    in >> dir >> num;
+    ui->remotePath->setText("/" + dir);
+    ui->files->setRowCount(int(num));
+    for (int i = 0; i < int(num); ++i) {
+        QString name;
+        bool isDir;
+        qint64 size, modified;
+        in >> name >> isDir >> size >> modified;
+        //  the directories are marked by the user data
+        QTableWidgetItem* item = new QTableWidgetItem(name);
+        item->setData(Qt::UserRole, isDir);
+        ui->files->setItem(i, 0, item);
+        QString text = QString::number(size / 1048576.0, 'f', 1) + " MB";
+        ui->files->setItem(i, 1, new QTableWidgetItem(isDir ? "" : text));
+        if (!isDir) sizes[(dir.isEmpty() ? "" : dir + "/") + name] = size;
+        ui->files->setItem(
+            i, 2,
+            new QTableWidgetItem(QDateTime::fromMSecsSinceEpoch(modified)
+                                     .toString("yyyy-MM-dd hh:mm:ss")));
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onData: write the chunk to the local copy
+ *  @param  in: the payload of the frame  */
+void Remote::onData(QDataStream& in) {
+    qint64 offset;
+    QByteArray chunk;
+    in >> offset >> chunk;
+    if (download == nullptr) return;
+
+    //  the changed local copy is sent again from the beginning
+    if (offset != download->size()) download->resize(offset);
+    download->seek(offset);
+    download->write(qUncompress(chunk));
+
+    qint64 size = std::max(expected, download->size());
+    ui->progress->setValue(size > 0 ? int(100 * download->size() / size) : 0);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onEnd: complete the local copy and fetch the next file
+ *  @param  in: the payload of the frame  */
+void Remote::onEnd(QDataStream& in) {
+    qint64 size, modified;
+    in >> size >> modified;
+    if (download == nullptr) return;
+
+    //  the local copy of the truncated file is truncated as well
+    if (download->size() > size) download->resize(size);
+    QString local = download->fileName();
+    release();
+    ui->progress->setValue(100);
+    ui->status->setText("Fetched " + path);
+    emit fetched(local);
+    fetchNext();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  onSurface: write the surface to the local file and fetch the next file
+ *  @param  in: the payload of the frame  */
+void Remote::onSurface(QDataStream& in) {
+    QString remote;
+    qint64 size;
+    QByteArray surface;
+    in >> remote >> size >> surface;
+    if (!isExtracting) return;
+    release();
+
+    //  the surface is kept beside the local copy of the file
+    QString local;
+    if (!getLocalPath(remote, local)) {
+        ui->status->setText("Refused the path " + remote);
+        fetchNext();
+        return;
+    }
+    local += ".surface.vtu";
+    vtkUnstructuredGrid* ugrid = Surface::decode(surface);
+    if (ugrid == nullptr) {
+        ui->status->setText("The surface of " + remote + " is corrupted");
+        fetchNext();
+        return;
+    }
+    QDir().mkpath(QFileInfo(local).absolutePath());
+    vtkXMLUnstructuredGridWriter* writer = vtkXMLUnstructuredGridWriter::New();
+    writer->SetFileName(local.toStdString().c_str());
+    writer->SetInputData(ugrid);
+    writer->SetDataModeToAppended();
+    int status = writer->Write();
+    writer->Delete();
+    ugrid->Delete();
+    if (status == 0) {
+        ui->status->setText("Failed to write " + local);
+        fetchNext();
+        return;
+    }
+
+    ui->progress->setValue(100);
+    ui->status->setText(QString("Fetched the surface of %1, %2 MB instead of "
+                                "%3 MB")
+                            .arg(remote)
+                            .arg(surface.size() / 1048576.0, 0, 'f', 2)
+                            .arg(size / 1048576.0, 0, 'f', 1));
+    emit fetched(local);
+    fetchNext();
+}
+
+/*  release: close the local copy of the transfer  */
+void Remote::release() {
+    delete download;
+    download     = nullptr;
+    isExtracting = false;
+    expected     = 0;
+}
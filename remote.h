@@ -1,23 +1,130 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : remote.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
 #ifndef REMOTE_H
 #define REMOTE_H
 
+#include <QDataStream>
 #include <QDialog>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QTcpSocket>
 
 namespace Ui {
 class Remote;
 }
 
+/*  ############################################################################
+ *  class Remote: the client of the result server, which lists the remote
+ *      result files and streams them into the local copies in the cache
+ *      directory. The local copy is never discarded, so the interrupted
+ *      transfer is resumed, and only the appended iterations are sent when
+ *      the file is fetched again. In the surface mode the result is filtered
+ *      by the server and only its external surface is transferred. The
+ *      fetched file is opened through the field cache like the local
+ *      results.  */
 class Remote : public QDialog {
     Q_OBJECT
 
+private:
+    Ui::Remote* ui;       // UI interface
+    QTcpSocket* socket;   // connection to the server
+    QString dir;          // listed remote directory
+    QString path;         // remote path of the transfer
+    QFile* download;      // local copy of the transfer, nullptr if idle
+    bool isExtracting;    // the surface of the transfer is requested
+    qint64 expected;      // listed size of the transfer
+    QStringList pending;  // remote paths to be fetched
+    QHash<QString, qint64> sizes;  // listed sizes of the remote files
+
 public:
-    explicit Remote(QWidget *parent = nullptr);
+    /*  ########################################################################
+     *  constructor: create the dialog of the remote server
+     *  @param  parent: the parent widget  */
+    explicit Remote(QWidget* parent = nullptr);
+
+    /*  destructor: close the connection, the local copies are kept  */
     ~Remote();
 
-public slots:
+    /*  getLocalPath: get the path of the local copy of the remote file,
+     *  which is kept in the cache directory of the server
+     *  @param  remote: the path relative to the root of the server
+     *  @param  local: the path of the local copy
+     *  @return  false if the path is out of the directory of the server  */
+    bool getLocalPath(const QString& remote, QString& local);
+
+signals:
+    /*  fetched: the local copy is complete
+     *  @param  file: the path of the local copy  */
+    void fetched(const QString& file);
+
+private slots:
+    /*  ########################################################################
+     *  connectServer: connect to the server of the dialog  */
+    void connectServer();
+
+    /*  onReadyRead: handle the complete frames of the server  */
+    void onReadyRead();
+
+    /*  onDisconnected: release the transfer, its local copy is kept  */
+    void onDisconnected();
+
+    /*  fetchSelected: fetch the selected files in the order of the list  */
+    void fetchSelected();
+
+    /*  openEntry: list the directory or fetch the file of the row
+     *  @param  row: the row of the entry  */
+    void openEntry(const int row);
 
 private:
-    Ui::Remote *ui;
-};
+    /*  ########################################################################
+     *  list: request the entries of the remote directory
+     *  @param  remote: the directory relative to the root of the server  */
+    void list(const QString& remote);
+
+    /*  fetchNext: request the next pending file from the end of its local
+     *  copy, the server sends it again if the local copy is changed  */
+    void fetchNext();
+
+    /*  extract: request the external surface of the file filtered by the
+     *  parameters of the dialog
+     *  @param  remote: the file relative to the root of the server  */
+    void extract(const QString& remote);
+
+    /*  onListing: show the entries of the directory
+     *  @param  in: the payload of the frame  */
+    void onListing(QDataStream& in);
+
+    /*  onData: write the chunk to the local copy
+     *  @param  in: the payload of the frame  */
+    void onData(QDataStream& in);
 
+    /*  onEnd: complete the local copy and fetch the next file
+     *  @param  in: the payload of the frame  */
+    void onEnd(QDataStream& in);
+
+    /*  onSurface: write the surface to the local file and fetch the next file
+     *  @param  in: the payload of the frame  */
+    void onSurface(QDataStream& in);
+
+    /*  isBusy: check whether a transfer is in progress
+     *  @return  true if a file or a surface is being fetched  */
+    bool isBusy() { return download != nullptr || isExtracting; }
+
+    /*  release: close the local copy of the transfer  */
+    void release();
+};
 #endif  // REMOTE_H
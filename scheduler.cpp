@@ -0,0 +1,482 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : scheduler.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "scheduler.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QProcessEnvironment>
+#include <QThread>
+#include <QUuid>
+#include <algorithm>
+
+#include "prenano.h"
+#include "ui_scheduler.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+/*  names of the states and the columns of the table  */
+static const char* STATES[]      = {"Queued", "Running", "Finished", "Failed",
+                                    "Canceled"};
+static const QStringList COLUMNS = {"Name",  "State",     "Priority",
+                                    "Cores", "Wall Time", "CPU Time",
+                                    "Memory"};
+
+/*  upsert of the job, the arguments are separated by the line breaks  */
+static const QString JOB_UPSERT =
+    "INSERT INTO jobs (uid, name, work_dir, arguments, priority, cores, "
+    "state, sequence, submitted, started, ended, cpu_time, peak_memory, "
+    "exit_code) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(uid) DO UPDATE SET name = excluded.name, "
+    "priority = excluded.priority, state = excluded.state, "
+    "started = excluded.started, ended = excluded.ended, "
+    "cpu_time = excluded.cpu_time, peak_memory = excluded.peak_memory, "
+    "exit_code = excluded.exit_code";
+
+/*  formatTime: format the seconds as "h:mm:ss"  */
+static QString formatTime(const double seconds) {
+    qint64 total = qint64(seconds);
+    return QString("%1:%2:%3")
+        .arg(total / 3600)
+        .arg(total / 60 % 60, 2, 10, QChar('0'))
+        .arg(total % 60, 2, 10, QChar('0'));
+}
+
+/*  ############################################################################
+ *  constructor: create the empty queue using all the cores  */
+Scheduler::Scheduler(QWidget* parent) : QDialog(parent), ui(new Ui::Scheduler) {
+    ui->setupUi(this);
+    usedCores = 0;
+    sequence  = 0;
+
+    //  the jobs are listed in the order of submission
+    ui->table->setColumnCount(int(COLUMNS.size()));
+    ui->table->setHorizontalHeaderLabels(COLUMNS);
+
+    //  all the cores of the workstation are used by default
+    int numCores = std::max(QThread::idealThreadCount(), 1);
+    ui->cores->setRange(1, numCores);
+    ui->cores->setValue(numCores);
+    connect(ui->cores, &QSpinBox::valueChanged, this, &Scheduler::schedule);
+
+    //  the running jobs are sampled periodically
+    timer = new QTimer(this);
+    timer->setInterval(PRENANO::JOB_SAMPLE_INTERVAL);
+    connect(timer, &QTimer::timeout, this, &Scheduler::sample);
+
+    //  the operations of the selected jobs
+    connect(ui->btnCancel, &QPushButton::clicked, this,
+            &Scheduler::cancelSelected);
+    connect(ui->btnRaise, &QPushButton::clicked, this,
+            [&]() { changePriority(1); });
+    connect(ui->btnLower, &QPushButton::clicked, this,
+            [&]() { changePriority(-1); });
+    connect(ui->btnClear, &QPushButton::clicked, this,
+            &Scheduler::clearFinished);
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  destructor: kill the running jobs  */
+Scheduler::~Scheduler() {
+    for (Job* job : jobs) {
+        if (job->process == nullptr) continue;
+        //  no other job is started by the finished one
+        job->process->disconnect(this);
+        job->process->kill();
+        job->process->waitForFinished(1000);
+    }
+    qDeleteAll(jobs);
+    delete ui;
+}
+
+/*  ############################################################################
+ *  submit: append the job to the queue and start it if the cores are
+ *  available, the standard and error outputs are written to the log named
+ *  after the job in the work directory
+ *  @param  name: the name of the job
+ *  @param  workDir: the work directory of the solver
+ *  @param  arguments: the script and its arguments
+ *  @param  priority: the higher priority is started first
+ *  @param  cores: the number of the cores used by the solver
+ *  @return  the unique id of the job  */
+QString Scheduler::submit(const QString& name, const QString& workDir,
+                          const QStringList& arguments, const int priority,
+                          const int cores) {
+    Job* job        = new Job;
+    job->uid        = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    job->name       = name;
+    job->workDir    = workDir;
+    job->arguments  = arguments;
+    job->priority   = priority;
+    job->cores      = std::max(cores, 1);
+    job->state      = QUEUED;
+    job->sequence   = sequence++;
+    job->submitted  = QDateTime::currentMSecsSinceEpoch();
+    job->started    = 0;
+    job->ended      = 0;
+    job->cpuTime    = 0.0;
+    job->peakMemory = 0;
+    job->exitCode   = 0;
+    job->process    = nullptr;
+    job->isCanceled = false;
+    job->isDirty    = true;
+    jobs.append(job);
+
+    //  only the new row is listed, so the large sweep is submitted quickly
+    ui->table->setRowCount(int(jobs.size()));
+    updateRow(int(jobs.size() - 1));
+    schedule();
+    return job->uid;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  cancel: remove the queued job, or terminate the running job and kill it
+ *  after the grace period
+ *  @param  uid: the unique id of the job
+ *  @return  false if the job is not queued or running  */
+bool Scheduler::cancel(const QString& uid) {
+    auto it = std::find_if(jobs.begin(), jobs.end(),
+                           [&](Job* job) { return job->uid == uid; });
+    if (it == jobs.end()) return false;
+    Job* job = *it;
+
+    /*  the queued job is never started  */
+    if (job->state == QUEUED) {
+        job->state   = CANCELED;
+        job->ended   = QDateTime::currentMSecsSinceEpoch();
+        job->isDirty = true;
+        updateRow(int(it - jobs.begin()));
+        emit finished(job->uid, CANCELED);
+        return true;
+    }
+
+    /*  the solver is asked to stop, and killed if it does not  */
+    if (job->state != RUNNING || job->process == nullptr) return false;
+    job->isCanceled = true;
+    job->process->terminate();
+    QTimer::singleShot(PRENANO::JOB_KILL_TIMEOUT, job->process,
+                       &QProcess::kill);
+    return true;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getState: get the state of the job
+ *  @param  uid: the unique id of the job
+ *  @return  the state of the job, -1 if it is not in the queue  */
+int Scheduler::getState(const QString& uid) const {
+    for (const Job* job : jobs) {
+        if (job->uid == uid) return job->state;
+    }
+    return -1;
+}
+
+/*  ============================================================================
+ *  isRunning: check whether any job is running
+ *  @return  true if a process of the jobs is running  */
+bool Scheduler::isRunning() const {
+    return std::any_of(jobs.begin(), jobs.end(),
+                       [](const Job* job) { return job->state == RUNNING; });
+}
+
+/*  ============================================================================
+ *  snapshot: append the removed and the changed jobs to the snapshot of the
+ *  project, and clear their dirty flags
+ *  @param  records: the statements of the snapshot
+ *  @param  isFull: write all the jobs rather than the changed ones  */
+void Scheduler::snapshot(QVector<Autosave::Record>& records,
+                         const bool isFull) {
+    //  the removed jobs
+    for (const QString& uid : removedList) {
+        records.append({"DELETE FROM jobs WHERE uid = ?", {uid}});
+    }
+    removedList.clear();
+    //  the changed jobs
+    for (Job* job : jobs) {
+        if (!isFull && !job->isDirty) continue;
+        job->isDirty = false;
+        records.append(
+            {JOB_UPSERT,
+             {job->uid, job->name, job->workDir, job->arguments.join('\n'),
+              job->priority, job->cores, job->state, job->sequence,
+              job->submitted, job->started, job->ended, job->cpuTime,
+              job->peakMemory, job->exitCode}});
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  loadProjectDatabase: replace the jobs by those in the project file, which
+ *  is only opened while no job is running, the jobs running when the file
+ *  was saved are failed since their processes are gone, and the queue is
+ *  resumed
+ *  @param  database: the database of the project  */
+void Scheduler::loadProjectDatabase(Database* database) {
+    //  the jobs of the previous project
+    qDeleteAll(jobs);
+    jobs.clear();
+    removedList.clear();
+    usedCores = 0;
+
+    //  the jobs in the order of submission
+    QSqlQuery* query = database->select(
+        "SELECT uid, name, work_dir, arguments, priority, cores, state, "
+        "sequence, submitted, started, ended, cpu_time, peak_memory, "
+        "exit_code FROM jobs ORDER BY sequence");
+    while (query != nullptr && query->next()) {
+        Job* job        = new Job;
+        job->uid        = query->value(0).toString();
+        job->name       = query->value(1).toString();
+        job->workDir    = query->value(2).toString();
+        job->arguments  = query->value(3).toString().split('\n');
+        job->priority   = query->value(4).toInt();
+        job->cores      = std::max(query->value(5).toInt(), 1);
+        job->state      = query->value(6).toInt();
+        job->sequence   = query->value(7).toLongLong();
+        job->submitted  = query->value(8).toLongLong();
+        job->started    = query->value(9).toLongLong();
+        job->ended      = query->value(10).toLongLong();
+        job->cpuTime    = query->value(11).toDouble();
+        job->peakMemory = query->value(12).toLongLong();
+        job->exitCode   = query->value(13).toInt();
+        job->process    = nullptr;
+        job->isCanceled = false;
+        job->isDirty    = false;
+        //  the process of the running job is gone with the application
+        if (job->state == RUNNING) {
+            job->state   = FAILED;
+            job->isDirty = true;
+        }
+        sequence = std::max(sequence, job->sequence + 1);
+        jobs.append(job);
+    }
+    if (query != nullptr) query->finish();
+
+    updateTable();
+    schedule();
+}
+
+/*  ############################################################################
+ *  schedule: start the queued jobs while their cores are available  */
+void Scheduler::schedule() {
+    while (true) {
+        //  the highest priority, and the earliest for the same priority
+        Job* next = nullptr;
+        for (Job* job : jobs) {
+            if (job->state != QUEUED) continue;
+            if (next == nullptr || job->priority > next->priority ||
+                (job->priority == next->priority &&
+                 job->sequence < next->sequence)) {
+                next = job;
+            }
+        }
+        if (next == nullptr) break;
+        //  the job larger than the workstation runs alone, and the later
+        //  jobs wait for it rather than overtake it
+        if (usedCores > 0 && usedCores + next->cores > ui->cores->value()) {
+            break;
+        }
+        start(next);
+    }
+    ui->status->setText(QString("%1 of %2 cores used")
+                            .arg(usedCores)
+                            .arg(ui->cores->value()));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  sample: sample the resources of the running jobs  */
+void Scheduler::sample() {
+    bool isRunning = false;
+    for (qsizetype i = 0; i < jobs.size(); ++i) {
+        if (jobs[i]->state != RUNNING) continue;
+        jobs[i]->sample();
+        updateRow(int(i));
+        isRunning = true;
+    }
+    if (!isRunning) timer->stop();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  cancelSelected: cancel the selected jobs  */
+void Scheduler::cancelSelected() {
+    QStringList uids;
+    QModelIndexList rows = ui->table->selectionModel()->selectedRows();
+    for (const QModelIndex& index : rows) uids << jobs[index.row()]->uid;
+    for (const QString& uid : uids) cancel(uid);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  changePriority: raise or lower the priority of the selected jobs
+ *  @param  delta: the change of the priority  */
+void Scheduler::changePriority(const int delta) {
+    QModelIndexList rows = ui->table->selectionModel()->selectedRows();
+    for (const QModelIndex& index : rows) {
+        Job* job = jobs[index.row()];
+        if (job->state != QUEUED) continue;
+        job->priority += delta;
+        job->isDirty = true;
+        updateRow(index.row());
+    }
+    schedule();
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  clearFinished: remove the finished, failed and canceled jobs  */
+void Scheduler::clearFinished() {
+    for (qsizetype i = jobs.size() - 1; i >= 0; --i) {
+        if (jobs[i]->state == QUEUED || jobs[i]->state == RUNNING) continue;
+        removedList << jobs[i]->uid;
+        delete jobs[i];
+        jobs.removeAt(i);
+    }
+    updateTable();
+}
+
+/*  ############################################################################
+ *  start: start the process of the queued job
+ *  @param  job: the job to be started  */
+void Scheduler::start(Job* job) {
+    job->state   = RUNNING;
+    job->started = QDateTime::currentMSecsSinceEpoch();
+    job->isDirty = true;
+    usedCores += job->cores;
+
+    /*  the solver uses the cores given to the job rather than all of them  */
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    QString threads         = QString::number(job->cores);
+    env.insert("OMP_NUM_THREADS", threads);
+    env.insert("MKL_NUM_THREADS", threads);
+    env.insert("OPENBLAS_NUM_THREADS", threads);
+
+    /*  the outputs are written to the log, which can be monitored  */
+    job->process = new QProcess(this);
+    job->process->setWorkingDirectory(job->workDir);
+    job->process->setProcessEnvironment(env);
+    job->process->setProcessChannelMode(QProcess::MergedChannels);
+    job->process->setStandardOutputFile(job->getLogFile());
+    connect(job->process, &QProcess::finished, this,
+            [this, job](int exitCode, QProcess::ExitStatus status) {
+                job->exitCode = exitCode;
+                bool isDone   = status == QProcess::NormalExit && !exitCode;
+                finish(job, job->isCanceled ? CANCELED
+                            : isDone        ? FINISHED
+                                            : FAILED);
+            });
+    connect(job->process, &QProcess::errorOccurred, this,
+            [this, job](QProcess::ProcessError error) {
+                //  the finished signal is not emitted for this error
+                if (error != QProcess::FailedToStart) return;
+                job->exitCode = -1;
+                finish(job, FAILED);
+            });
+    QString python = qEnvironmentVariable(PRENANO::JOB_PYTHON_ENV,
+                                          PRENANO::JOB_PYTHON);
+    job->process->start(python, job->arguments);
+
+    if (!timer->isActive()) timer->start();
+    updateRow(int(jobs.indexOf(job)));
+    emit started(job->uid);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  finish: release the process of the job and set its state
+ *  @param  job: the job whose process is finished
+ *  @param  state: FINISHED, FAILED or CANCELED  */
+void Scheduler::finish(Job* job, const int state) {
+    if (job->process == nullptr) return;
+    job->process->deleteLater();
+    job->process = nullptr;
+    job->state   = state;
+    job->ended   = QDateTime::currentMSecsSinceEpoch();
+    job->isDirty = true;
+    usedCores -= job->cores;
+
+    updateRow(int(jobs.indexOf(job)));
+    emit finished(job->uid, state);
+    //  the released cores are given to the queued jobs
+    schedule();
+}
+
+/*  ============================================================================
+ *  updateTable: list all the jobs in the table  */
+void Scheduler::updateTable() {
+    ui->table->setRowCount(int(jobs.size()));
+    for (qsizetype i = 0; i < jobs.size(); ++i) updateRow(int(i));
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  updateRow: show the state and the accounting of the job
+ *  @param  row: the index of the job  */
+void Scheduler::updateRow(const int row) {
+    if (row < 0 || row >= jobs.size()) return;
+    Job* job = jobs[row];
+
+    //  the wall time of the running job is counted until now
+    qint64 end  = job->ended > 0 ? job->ended
+                                 : QDateTime::currentMSecsSinceEpoch();
+    double wall = job->started > 0 ? (end - job->started) / 1000.0 : 0.0;
+    QStringList texts = {job->name,
+                         STATES[job->state],
+                         QString::number(job->priority),
+                         QString::number(job->cores),
+                         formatTime(wall),
+                         formatTime(job->cpuTime),
+                         QString::number(job->peakMemory / 1024.0, 'f', 1) +
+                             " MB"};
+    for (int i = 0; i < texts.size(); ++i) {
+        QTableWidgetItem* item = ui->table->item(row, i);
+        if (item == nullptr) {
+            item = new QTableWidgetItem;
+            ui->table->setItem(row, i, item);
+        }
+        item->setText(texts[i]);
+    }
+}
+
+/*  ############################################################################
+ *  sample: read the CPU time and the peak memory of the running process, only
+ *  supported on Linux, where they are read from /proc  */
+void Scheduler::Job::sample() {
+#ifdef Q_OS_LINUX
+    if (process == nullptr || process->processId() <= 0) return;
+    QString proc = QString("/proc/%1/").arg(process->processId());
+
+    /*  the user and system time of the process and its waited children  */
+    QFile stat(proc + "stat");
+    if (stat.open(QIODevice::ReadOnly)) {
+        //  the fields after the command, which can contain the spaces
+        QByteArray line = stat.readAll();
+        QList<QByteArray> fields =
+            line.mid(line.lastIndexOf(')') + 2).split(' ');
+        if (fields.size() > 14) {
+            double ticks = fields[11].toDouble() + fields[12].toDouble() +
+                           fields[13].toDouble() + fields[14].toDouble();
+            cpuTime      = ticks / double(sysconf(_SC_CLK_TCK));
+        }
+    }
+
+    /*  the peak resident memory  */
+    QFile status(proc + "status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray& line : status.readAll().split('\n')) {
+            if (!line.startsWith("VmHWM:")) continue;
+            QList<QByteArray> fields = line.simplified().split(' ');
+            if (fields.size() > 1) peakMemory = fields[1].toLongLong();
+            break;
+        }
+    }
+#endif
+}
@@ -0,0 +1,187 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : scheduler.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <QDialog>
+#include <QList>
+#include <QProcess>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include "autosave.h"
+#include "database.h"
+
+namespace Ui {
+class Scheduler;
+}
+
+/*  ############################################################################
+ *  class Scheduler: the local engine of the analysis and optimization jobs,
+ *      which runs the solver scripts as the child processes of the work
+ *      directory. The queued job with the highest priority is started when
+ *      its cores fit in the cores of the workstation, the earlier job goes
+ *      first for the same priority, and the large job never starves since
+ *      the later jobs wait for it. The running jobs are sampled for the CPU
+ *      time and the peak memory, and the jobs are saved in the project file,
+ *      so the queue is resumed when the project is opened again.  */
+class Scheduler : public QDialog {
+    Q_OBJECT
+
+public:
+    /*  the states of the job  */
+    enum { QUEUED, RUNNING, FINISHED, FAILED, CANCELED };
+
+private:
+    class Job;                // the solver run and its accounting
+
+    Ui::Scheduler* ui;        // UI interface
+    QList<Job*> jobs;         // jobs in the order of submission
+    QStringList removedList;  // unique ids of the removed jobs
+    int usedCores;            // cores of the running jobs
+    qint64 sequence;          // order of the next submitted job
+    QTimer* timer;            // sampler of the running jobs
+
+public:
+    /*  ########################################################################
+     *  constructor: create the empty queue using all the cores  */
+    explicit Scheduler(QWidget* parent = nullptr);
+
+    /*  destructor: kill the running jobs  */
+    ~Scheduler();
+
+    /*  submit: append the job to the queue and start it if the cores are
+     *  available, the standard and error outputs are written to the log
+     *  named after the job in the work directory
+     *  @param  name: the name of the job
+     *  @param  workDir: the work directory of the solver
+     *  @param  arguments: the script and its arguments
+     *  @param  priority: the higher priority is started first
+     *  @param  cores: the number of the cores used by the solver
+     *  @return  the unique id of the job  */
+    QString submit(const QString& name, const QString& workDir,
+                   const QStringList& arguments, const int priority = 0,
+                   const int cores = 1);
+
+    /*  cancel: remove the queued job, or terminate the running job and kill
+     *  it after the grace period
+     *  @param  uid: the unique id of the job
+     *  @return  false if the job is not queued or running  */
+    bool cancel(const QString& uid);
+
+    /*  getState: get the state of the job
+     *  @param  uid: the unique id of the job
+     *  @return  the state of the job, -1 if it is not in the queue  */
+    int getState(const QString& uid) const;
+
+    /*  isRunning: check whether any job is running
+     *  @return  true if a process of the jobs is running  */
+    bool isRunning() const;
+
+    /*  snapshot: append the removed and the changed jobs to the snapshot of
+     *  the project, and clear their dirty flags
+     *  @param  records: the statements of the snapshot
+     *  @param  isFull: write all the jobs rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, const bool isFull);
+
+    /*  loadProjectDatabase: replace the jobs by those in the project file,
+     *  which is only opened while no job is running, the jobs running when
+     *  the file was saved are failed since their processes are gone, and
+     *  the queue is resumed
+     *  @param  database: the database of the project  */
+    void loadProjectDatabase(Database* database);
+
+signals:
+    /*  started: the process of the job is started
+     *  @param  uid: the unique id of the job  */
+    void started(const QString& uid);
+
+    /*  finished: the job is finished, failed or canceled
+     *  @param  uid: the unique id of the job
+     *  @param  state: FINISHED, FAILED or CANCELED  */
+    void finished(const QString& uid, int state);
+
+private slots:
+    /*  ########################################################################
+     *  schedule: start the queued jobs while their cores are available  */
+    void schedule();
+
+    /*  sample: sample the resources of the running jobs  */
+    void sample();
+
+    /*  cancelSelected: cancel the selected jobs  */
+    void cancelSelected();
+
+    /*  changePriority: raise or lower the priority of the selected jobs
+     *  @param  delta: the change of the priority  */
+    void changePriority(const int delta);
+
+    /*  clearFinished: remove the finished, failed and canceled jobs  */
+    void clearFinished();
+
+private:
+    /*  ########################################################################
+     *  start: start the process of the queued job
+     *  @param  job: the job to be started  */
+    void start(Job* job);
+
+    /*  finish: release the process of the job and set its state
+     *  @param  job: the job whose process is finished
+     *  @param  state: FINISHED, FAILED or CANCELED  */
+    void finish(Job* job, const int state);
+
+    /*  updateTable: list all the jobs in the table  */
+    void updateTable();
+
+    /*  updateRow: show the state and the accounting of the job
+     *  @param  row: the index of the job  */
+    void updateRow(const int row);
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Scheduler::Job: the solver run, its queue order and the resources
+ *  used by its process  */
+class Scheduler::Job {
+public:
+    QString uid;            // unique id in the project file
+    QString name;           // name of the job
+    QString workDir;        // work directory of the solver
+    QStringList arguments;  // script and its arguments
+    int priority;           // the higher priority is started first
+    int cores;              // number of the cores used by the solver
+    int state;              // QUEUED, RUNNING, FINISHED, FAILED or CANCELED
+    qint64 sequence;        // order of the submission
+    qint64 submitted;       // time of the submission in ms since epoch
+    qint64 started;         // time of the start, 0 if not started
+    qint64 ended;           // time of the end, 0 if not ended
+    double cpuTime;         // user and system time in seconds
+    qint64 peakMemory;      // peak resident memory in KiB
+    int exitCode;           // exit code of the process
+    QProcess* process;      // the process while running
+    bool isCanceled;        // canceled while running
+    bool isDirty;           // changed since the last snapshot
+
+public:
+    /*  getLogFile: get the path of the log of the job
+     *  @return  the path of the log  */
+    QString getLogFile() const { return workDir + "/" + name + ".log"; }
+
+    /*  sample: read the CPU time and the peak memory of the running process,
+     *  only supported on Linux, where they are read from /proc  */
+    void sample();
+};
+#endif  // SCHEDULER_H
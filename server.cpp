@@ -0,0 +1,311 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : server.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "server.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QRandomGenerator>
+
+#include "channel.h"
+#include "prenano.h"
+
+/*  ############################################################################
+ *  constructor: create the server of the root directory
+ *  @param  dir: the root directory of the results
+ *  @param  name: the user name, any user is accepted if empty
+ *  @param  passwd: the password of the user
+ *  @param  parent: the parent object  */
+Server::Server(const QString& dir, const QString& name, const QString& passwd,
+               QObject* parent)
+    : QObject(parent), user(name), password(passwd) {
+    root          = QFileInfo(dir).canonicalFilePath();
+    field         = nullptr;
+    fieldModified = 0;
+    listener      = new QTcpServer(this);
+    connect(listener, &QTcpServer::newConnection, this,
+            &Server::onConnection);
+}
+
+/*  destructor: release the field of the last extracted file  */
+Server::~Server() { delete field; }
+
+/*  listen: listen to the clients on the address
+ *  @param  address: the address of the server, e.g., the local host
+ *  @param  port: the port of the server
+ *  @return  the status, true for success, otherwise failed  */
+bool Server::listen(const QHostAddress& address, const quint16 port) {
+    if (root.isEmpty()) return false;
+    return listener->listen(address, port);
+}
+
+/*  ============================================================================
+ *  onConnection: start the sessions of the new clients  */
+void Server::onConnection() {
+    while (listener->hasPendingConnections()) {
+        Session* session      = new Session;
+        session->socket       = listener->nextPendingConnection();
+        session->isAuthorized = false;
+        session->file         = nullptr;
+        session->offset       = 0;
+
+        //  the random challenge of the session
+        session->nonce.resize(32);
+        QRandomGenerator::system()->generate(session->nonce.begin(),
+                                             session->nonce.end());
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out << session->nonce;
+        Channel::send(session->socket, Channel::CHALLENGE, payload);
+
+        connect(session->socket, &QTcpSocket::readyRead, this,
+                [this, session]() { onReadyRead(session); });
+        connect(session->socket, &QTcpSocket::bytesWritten, this,
+                [this, session]() { pump(session); });
+        connect(session->socket, &QTcpSocket::disconnected, this,
+                [session]() {
+                    session->socket->deleteLater();
+                    delete session->file;
+                    delete session;
+                });
+    }
+}
+
+/*  ############################################################################
+ *  onReadyRead: handle the complete frames of the client
+ *  @param  session: the session of the client  */
+void Server::onReadyRead(Session* session) {
+    quint8 type;
+    QByteArray payload;
+    while (Channel::receive(session->socket, type, payload)) {
+        QDataStream in(payload);
+
+        /*  the challenge is answered before any request  */
+        if (type == Channel::HELLO) {
+            QString name;
+            QByteArray digest;
+            in >> name >> digest;
+            session->isAuthorized =
+                user.isEmpty() ||
+                (name == user &&
+                 digest == Channel::digest(session->nonce, password));
+            if (!session->isAuthorized) {
+                fail(session, "Invalid user name or password.");
+                session->socket->disconnectFromHost();
+                return;
+            }
+            QByteArray reply;
+            QDataStream out(&reply, QIODevice::WriteOnly);
+            out << QFileInfo(root).fileName();
+            Channel::send(session->socket, Channel::WELCOME, reply);
+            continue;
+        }
+        if (!session->isAuthorized) {
+            fail(session, "The session is not authorized.");
+            session->socket->disconnectFromHost();
+            return;
+        }
+
+        /*  the requests  */
+        if (type == Channel::LIST) {
+            QString dir;
+            in >> dir;
+            list(session, dir);
+        } else if (type == Channel::READ) {
+            QString path;
+            qint64 offset;
+            QByteArray hash;
+            in >> path >> offset >> hash;
+            read(session, path, offset, hash);
+        } else if (type == Channel::EXTRACT) {
+            Surface::Request request;
+            request.read(in);
+            extract(session, request);
+        } else {
+            fail(session, QString("Unknown request %1.").arg(type));
+        }
+    }
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  list: send the entries of the directory
+ *  @param  session: the session of the client
+ *  @param  dir: the directory relative to the root  */
+void Server::list(Session* session, const QString& dir) {
+    QString absolute;
+    if (!resolve(dir, absolute) || !QFileInfo(absolute).isDir()) {
+        fail(session, "The directory " + dir + " is not found.");
+        return;
+    }
+    QFileInfoList entries = QDir(absolute).entryInfoList(
+        QDir::AllDirs | QDir::Files | QDir::NoDotAndDotDot,
+        QDir::DirsFirst | QDir::Name);
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << dir << quint32(entries.size());
+    for (const QFileInfo& entry : entries) {
+        out << entry.fileName() << entry.isDir() << entry.size()
+            << entry.lastModified().toMSecsSinceEpoch();
+    }
+    Channel::send(session->socket, Channel::LISTING, payload);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  read: start streaming the file, the transfer is resumed from the offset if
+ *  the tail of the local copy is unchanged, otherwise it is started from the
+ *  beginning
+ *  @param  session: the session of the client
+ *  @param  path: the file relative to the root
+ *  @param  offset: the size of the local copy
+ *  @param  hash: the hash of the tail of the local copy  */
+void Server::read(Session* session, const QString& path, const qint64 offset,
+                  const QByteArray& hash) {
+    //  the new request replaces the current transfer
+    delete session->file;
+    session->file = nullptr;
+
+    QString absolute;
+    QFile* file = nullptr;
+    if (resolve(path, absolute)) file = new QFile(absolute);
+    if (file == nullptr || !file->open(QIODevice::ReadOnly)) {
+        delete file;
+        fail(session, "The file " + path + " can not be read.");
+        return;
+    }
+
+    //  only the appended bytes are sent if the local copy is a prefix
+    session->offset = offset;
+    if (offset < 0 || offset > file->size() ||
+        Channel::hashTail(file, offset) != hash) {
+        session->offset = 0;
+    }
+    file->seek(session->offset);
+    session->file = file;
+    pump(session);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  extract: filter the file by the request and send its external surface
+ *  @param  session: the session of the client
+ *  @param  request: the file and the parameters of the filters  */
+void Server::extract(Session* session, const Surface::Request& request) {
+    QString absolute;
+    QFileInfo info;
+    if (resolve(request.path, absolute)) info.setFile(absolute);
+    if (!info.isFile()) {
+        fail(session, "The file " + request.path + " is not found.");
+        return;
+    }
+    QString suffix = info.suffix().toLower();
+    if (suffix != "vtu" && suffix != "pvtu" && suffix != "vtkhdf" &&
+        suffix != "hdf") {
+        fail(session, "The file " + request.path + " is not a result.");
+        return;
+    }
+
+    /*  the field is read again only if the file is changed  */
+    qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    if (field == nullptr || fieldPath != absolute ||
+        fieldModified != modified) {
+        delete field;
+        field = new Field(absolute);
+        if (!field->isFieldRead()) {
+            delete field;
+            field = nullptr;
+            fail(session, "The result " + request.path + " cannot be read.");
+            return;
+        }
+        fieldPath     = absolute;
+        fieldModified = modified;
+    }
+
+    QByteArray surface;
+    QString error;
+    if (!Surface::encode(field, request, surface, error)) {
+        fail(session, error);
+        return;
+    }
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << request.path << info.size() << surface;
+    if (payload.size() >= PRENANO::REMOTE_MAX_FRAME) {
+        fail(session, "The surface of " + request.path +
+                          " is too large, fetch the file instead.");
+        return;
+    }
+    Channel::send(session->socket, Channel::SURFACE, payload);
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  pump: send the chunks of the file while the pipeline is not full  */
+void Server::pump(Session* session) {
+    qint64 limit = qint64(PRENANO::REMOTE_PIPELINE) *
+                   PRENANO::REMOTE_CHUNK_SIZE;
+    while (session->file != nullptr &&
+           session->socket->bytesToWrite() < limit) {
+        QByteArray chunk = session->file->read(PRENANO::REMOTE_CHUNK_SIZE);
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+
+        /*  the end of the file, which may grow while it is streamed  */
+        if (chunk.isEmpty()) {
+            out << session->offset
+                << QFileInfo(*session->file)
+                       .lastModified()
+                       .toMSecsSinceEpoch();
+            Channel::send(session->socket, Channel::END, payload);
+            delete session->file;
+            session->file = nullptr;
+            break;
+        }
+
+        out << session->offset << qCompress(chunk);
+        Channel::send(session->socket, Channel::DATA, payload);
+        session->offset += chunk.size();
+    }
+}
+
+/*  ============================================================================
+ *  resolve: get the absolute path in the root directory
+ *  @param  path: the path relative to the root
+ *  @param  absolute: the absolute path
+ *  @return  false if the path is out of the root  */
+bool Server::resolve(const QString& path, QString& absolute) {
+    auto isInside = [&](const QString& file) {
+        return file == root || file.startsWith(root + "/");
+    };
+    absolute = QDir::cleanPath(root + "/" + path);
+    if (!isInside(absolute)) return false;
+    //  the links out of the root are refused as well
+    QString canonical = QFileInfo(absolute).canonicalFilePath();
+    return canonical.isEmpty() || isInside(canonical);
+}
+
+/*  fail: send the failure to the client
+ *  @param  session: the session of the client
+ *  @param  message: the error message  */
+void Server::fail(Session* session, const QString& message) {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out << message;
+    Channel::send(session->socket, Channel::FAILURE, payload);
+    //  the failures are reported on stderr even in the release build
+    qWarning().noquote() << session->socket->peerAddress().toString()
+                         << message;
+}
@@ -0,0 +1,130 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : server.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "surface.h"
+
+/*  ############################################################################
+ *  class Server: the result server of the remote workstation, which lists the
+ *      result files under the root directory and streams them to the GUI by
+ *      the protocol of Channel. Each client is one session, and the chunks
+ *      are only read when the socket has sent the previous ones, so the
+ *      memory of the server is bounded for any size of the files. The paths
+ *      out of the root directory are refused. The surface requests are
+ *      filtered by Field next to the data, and the field of the last file
+ *      is kept, so changing the filters does not read the file again.  */
+class Server : public QObject {
+    Q_OBJECT
+
+private:
+    class Session;            // the state of one client
+
+    QTcpServer* listener;     // listener of the clients
+    QString root;             // canonical path of the root directory
+    QString user;             // user name, any user if empty
+    QString password;         // password of the user
+
+    Field* field;             // field of the last extracted file
+    QString fieldPath;        // absolute path of the field
+    qint64 fieldModified;     // modified time of the field file
+
+public:
+    /*  ########################################################################
+     *  constructor: create the server of the root directory
+     *  @param  dir: the root directory of the results
+     *  @param  name: the user name, any user is accepted if empty
+     *  @param  passwd: the password of the user
+     *  @param  parent: the parent object  */
+    Server(const QString& dir, const QString& name, const QString& passwd,
+           QObject* parent = nullptr);
+
+    /*  destructor: release the field of the last extracted file  */
+    ~Server();
+
+    /*  listen: listen to the clients on the address
+     *  @param  address: the address of the server, e.g., the local host
+     *  @param  port: the port of the server
+     *  @return  the status, true for success, otherwise failed  */
+    bool listen(const QHostAddress& address, const quint16 port);
+
+    /*  getError: get the error of the listener
+     *  @return  the error message  */
+    QString getError() { return listener->errorString(); }
+
+private slots:
+    /*  onConnection: start the sessions of the new clients  */
+    void onConnection();
+
+private:
+    /*  ########################################################################
+     *  onReadyRead: handle the complete frames of the client
+     *  @param  session: the session of the client  */
+    void onReadyRead(Session* session);
+
+    /*  list: send the entries of the directory
+     *  @param  session: the session of the client
+     *  @param  dir: the directory relative to the root  */
+    void list(Session* session, const QString& dir);
+
+    /*  read: start streaming the file, the transfer is resumed from the
+     *  offset if the tail of the local copy is unchanged, otherwise it is
+     *  started from the beginning
+     *  @param  session: the session of the client
+     *  @param  path: the file relative to the root
+     *  @param  offset: the size of the local copy
+     *  @param  hash: the hash of the tail of the local copy  */
+    void read(Session* session, const QString& path, const qint64 offset,
+              const QByteArray& hash);
+
+    /*  extract: filter the file by the request and send its external surface
+     *  @param  session: the session of the client
+     *  @param  request: the file and the parameters of the filters  */
+    void extract(Session* session, const Surface::Request& request);
+
+    /*  pump: send the chunks of the file while the pipeline is not full  */
+    void pump(Session* session);
+
+    /*  resolve: get the absolute path in the root directory
+     *  @param  path: the path relative to the root
+     *  @param  absolute: the absolute path
+     *  @return  false if the path is out of the root  */
+    bool resolve(const QString& path, QString& absolute);
+
+    /*  fail: send the failure to the client
+     *  @param  session: the session of the client
+     *  @param  message: the error message  */
+    void fail(Session* session, const QString& message);
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Server::Session: the client, its challenge and the streamed file  */
+class Server::Session {
+public:
+    QTcpSocket* socket;  // socket of the client
+    QByteArray nonce;    // challenge of the client
+    bool isAuthorized;   // the challenge is answered
+    QFile* file;         // streamed file, nullptr if idle
+    qint64 offset;       // offset of the next chunk
+};
+#endif  // SERVER_H
@@ -15,8 +15,17 @@
  *  */
 #include "set.h"
 
+#include <QUuid>
+
 #include "ui_set.h"
 
+/*  upsert of the set, the set is kept in its model on conflict  */
+static const QString SET_UPSERT =
+    "INSERT INTO sets (uid, model_uid, name, type, source, create_type, data) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?) ON CONFLICT(uid) DO UPDATE SET "
+    "name = excluded.name, type = excluded.type, source = excluded.source, "
+    "create_type = excluded.create_type, data = excluded.data";
+
 /*  ############################################################################
  *  constructor:  create the model object   */
 Set::Set(QWidget* parent, QString*& projName, QString*& modelName,
@@ -31,8 +40,9 @@ Set::Set(QWidget* parent, QString*& projName, QString*& modelName,
     workDir = workPath;
 
     //  create a new property model
-    index  = 0;
-    proNew = new Property(index, project, model, workDir);
+    index    = 0;
+    proNew   = new Property(index, project, model, workDir);
+    database = nullptr;
 
     //  other moduled environment
     setupSourceSelect();  // the source selection
@@ -204,6 +214,7 @@ void Set::saveModelDialog() {
     //  creation type
     if (ui->useNew->isChecked()) proTem->createType = 0;
     if (ui->useLocal->isChecked()) proTem->createType = 1;
+    proTem->isDirty = true;
 
     //  update the model name if in edit mode
     if (editmode) {
@@ -255,6 +266,7 @@ void Set::loadModelDialog(int idx) {
     //  get the current property
     item   = itemModel->item(idx, 0);
     proOld = item->data(Qt::UserRole).value<Property*>();
+    hydrate(proOld);
     //  set the name of the model
     ui->name->setText(proOld->name);
     ui->project->setText(*project);
@@ -310,7 +322,8 @@ void Set::setModelName() {
     //  set the new name of the model
     QString text;
     rename->getNameNew(text);
-    proOld->name = text;
+    proOld->name    = text;
+    proOld->isDirty = true;
     //  update the name of the current item
     item->setText(text);
     //  rest the pointer
@@ -330,6 +343,7 @@ void Set::deleteModel(int idx) {
         item = itemModel->item(idx, 0);
         //  get the current model property in edit
         proOld = item->data(Qt::UserRole).value<Property*>();
+        removedList << proOld->uid;
         //  remove the item from the list view
         itemModel->removeRow(idx);
         //  remove the property object
@@ -339,63 +353,93 @@ void Set::deleteModel(int idx) {
 }
 
 /*  ############################################################################
- *  saveModelDatabase: save the basic information of the model database*/
-void Set::saveModelDatabase() {
+ *  snapshot: append the deleted and the changed sets to the snapshot of the
+ *  project, and clear their dirty flags
+ *  @param  records: the statements of the snapshot
+ *  @param  modelUid: the unique id of the model
+ *  @param  isFull: write all the sets rather than the changed ones  */
+void Set::snapshot(QVector<Autosave::Record>& records, const QString& modelUid,
+                   const bool isFull) {
+    //  the deleted sets
+    for (const QString& uid : removedList) {
+        records.append({"DELETE FROM sets WHERE uid = ?", {uid}});
+    }
+    removedList.clear();
     //  iterate through all items in the list view
     for (int i = 0; i < itemModel->rowCount(); ++i) {
         //  get the item
         item = itemModel->item(i, 0);
         //  get the current model property
         proOld = item->data(Qt::UserRole).value<Property*>();
-        //  save the database
-        proOld->saveDatabase(*workDir);
+        //  another file needs the indices of all the sets
+        if (isFull) hydrate(proOld);
+        //  write the changed set
+        if (isFull || proOld->isDirty) proOld->snapshot(records, modelUid);
     }
+    item   = nullptr;
+    proOld = nullptr;
 }
 
 /*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
- *  loadModel: load the model information from the local database  */
-void Set::loadModelDatabase() {
-    //  set the database name
-    proNew->dbname = ui->source->text();
-    //  create the database
-    proNew->db.setDatabaseName(proNew->dbname);
-    if (!proNew->db.open()) {
-        qDebug() << "Failed to open the database"
-                 << proNew->db.lastError().text();
+ *  loadProjectDatabase: read the names of the sets of the model from the
+ *  project file, the indices are fetched on their first use
+ *  @param  database: the database of the project
+ *  @param  modelUid: the unique id of the model  */
+void Set::loadProjectDatabase(Database* database, const QString& modelUid) {
+    this->database = database;
+    //  the names of the sets in the order of creation
+    QSqlQuery* query = database->select(
+        "SELECT uid, name, type FROM sets WHERE model_uid = ? ORDER BY rowid",
+        {modelUid});
+    while (query != nullptr && query->next()) {
+        ++index;
+        proTem           = new Property(index, project, model, workDir);
+        proTem->uid      = query->value(0).toString();
+        proTem->name     = query->value(1).toString();
+        proTem->type     = query->value(2).toInt();
+        proTem->isDirty  = false;
+        proTem->isLoaded = false;
+        //  add the set to the list view
+        item = new QStandardItem(proTem->name);
+        item->setData(QVariant::fromValue(proTem), Qt::UserRole);
+        itemModel->appendRow(item);
     }
-    //  load the information of project
-    QSqlQuery query(proNew->db);
-    query.prepare("SELECT * FROM MODEL;");
-
-    //  perform the query command
-    query.exec();
-
-    //  get the name of the model
-    query.next();
-    proNew->name = query.value(2).toString();
-    qDebug() << proNew->name;
-
-    //  get the model type
-    query.next();
-    proNew->type = query.value(2).toInt();
-    qDebug() << proNew->type;
-
-    //  get the source
-    query.next();
-    proNew->source = query.value(2).toString();
-    qDebug() << proNew->source;
-
-    //  assign the creation type
-    query.next();
-    proNew->createType = 1;
-    qDebug() << proNew->createType;
-
-    //  close the query
-    query.finish();
-    query.clear();
-
-    //  close the database
-    proNew->db.close();
+    if (query != nullptr) query->finish();
+    item   = nullptr;
+    proTem = nullptr;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  getSetData: get the indices of the set, which are fetched from the project
+ *  file on the first call
+ *  @param  idx: the index of the set in the list view
+ *  @return  the indices of the nodes or elements  */
+const QVector<int>& Set::getSetData(int idx) {
+    item          = itemModel->item(idx, 0);
+    Property* pro = item->data(Qt::UserRole).value<Property*>();
+    item          = nullptr;
+    hydrate(pro);
+    return pro->data;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  hydrate: fetch the details and the indices of the set from the project file
+ *  on its first use, only the names are read when the project is opened
+ *  @param  pro: the set property  */
+void Set::hydrate(Property* pro) {
+    if (pro->isLoaded || database == nullptr) return;
+    QSqlQuery* query = database->select(
+        "SELECT source, create_type, data FROM sets WHERE uid = ?", {pro->uid});
+    if (query != nullptr && query->next()) {
+        pro->source     = query->value(0).toString();
+        pro->createType = query->value(1).toInt();
+        //  the indices are stored as the raw block
+        QByteArray block = query->value(2).toByteArray();
+        const int* first = reinterpret_cast<const int*>(block.constData());
+        pro->data = QVector<int>(first, first + block.size() / sizeof(int));
+        pro->isLoaded = true;
+    }
+    if (query != nullptr) query->finish();
 }
 
 Set::Property::Property(int index, QString*& projName, QString*& modelName,
@@ -406,6 +450,11 @@ Set::Property::Property(int index, QString*& projName, QString*& modelName,
     ifOverride = false;
     ifCreateDb = false;
 
+    //  the new set is written by the next snapshot
+    uid      = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    isDirty  = true;
+    isLoaded = true;
+
     //  assign the model name
     name = "Set-" + QString::number(index);
 }
@@ -417,10 +466,22 @@ Set::Property::~Property() {
 }
 
 /*  ############################################################################
- *  saveDatabase: save model information to the local database */
-void Set::Property::saveDatabase(QString& workDir) {
-    //  create the database
-    if (!ifCreateDb) {
-        db = QSqlDatabase::addDatabase("QSQLITE", name);
+ *  snapshot: append the set to the snapshot of the project, the data is the
+ *  shared copy of the indices
+ *  @param  records: the statements of the snapshot
+ *  @param  modelUid: the unique id of the model  */
+void Set::Property::snapshot(QVector<Autosave::Record>& records,
+                             const QString& modelUid) {
+    //  only the name of the unloaded set can be changed, and its indices are
+    //  kept in the file
+    if (!isLoaded) {
+        records.append({"UPDATE sets SET name = ? WHERE uid = ?", {name, uid}});
+    }
+    //  the indices are converted to the block by the writer
+    else {
+        records.append({SET_UPSERT,
+                        {uid, modelUid, name, type, source, createType,
+                         QVariant::fromValue(data)}});
     }
+    isDirty = false;
 }
@@ -17,10 +17,9 @@
 #define SET_H
 
 #include <QDialog>
-#include <QtSql/QSqlDatabase>
-#include <QtSql/QSqlError>
 #include <QtSql/QSqlQuery>
 
+#include "autosave.h"
 #include "manager.h"
 #include "messagebox.h"
 #include "open.h"
@@ -57,10 +56,12 @@ private:
     bool editmode;       // if the model is in edit mode or creation
     QString text;        // temporary string for data operation
 
-    class Property;      // the set property
-    Property* proNew;    // the model property object for creation
-    Property* proOld;    // the model property object for edition
-    Property* proTem;    // the temporary object for model property
+    class Property;           // the set property
+    Property* proNew;         // the model property object for creation
+    Property* proOld;         // the model property object for edition
+    Property* proTem;         // the temporary object for model property
+    QStringList removedList;  // unique ids of the deleted sets
+    Database* database;       // project file of the unloaded sets
 
 private:
     QStandardItem* item;            // the item in the list view
@@ -83,6 +84,12 @@ private:
     /*  setup Rename dialog  */
     void setupRenameDialog();
 
+    /*  hydrate: fetch the details and the indices of the set from the project
+     *  file on its first use, only the names are read when the project is
+     *  opened
+     *  @param  pro: the set property  */
+    void hydrate(Property* pro);
+
 private slots:
     /*  saveModelDialog: save the dialog information to the variables  */
     void saveModelDialog();
@@ -93,9 +100,6 @@ private slots:
     /*  confirmDialog: check the dialog information is complete  */
     bool confimDialog();
 
-    /*  load the model information from the local database  */
-    void loadModelDatabase();
-
     /*  getModelName: get the name of the selected model  */
     void getModelName(int idx);
 
@@ -113,8 +117,25 @@ public:
     /*  destructor: destroy the Set object  */
     ~Set();
 
-    /*  save the model information to the local database  */
-    void saveModelDatabase();
+    /*  snapshot: append the deleted and the changed sets to the snapshot of
+     *  the project, and clear their dirty flags
+     *  @param  records: the statements of the snapshot
+     *  @param  modelUid: the unique id of the model
+     *  @param  isFull: write all the sets rather than the changed ones  */
+    void snapshot(QVector<Autosave::Record>& records, const QString& modelUid,
+                  const bool isFull);
+
+    /*  loadProjectDatabase: read the names of the sets of the model from the
+     *  project file, the indices are fetched on their first use
+     *  @param  database: the database of the project
+     *  @param  modelUid: the unique id of the model  */
+    void loadProjectDatabase(Database* database, const QString& modelUid);
+
+    /*  getSetData: get the indices of the set, which are fetched from the
+     *  project file on the first call
+     *  @param  idx: the index of the set in the list view
+     *  @return  the indices of the nodes or elements  */
+    const QVector<int>& getSetData(int idx);
 
 public slots:
     /*  createSet: create a new model  */
@@ -147,6 +168,9 @@ protected:
  *  this class is used to define the set property used in Set object.  */
 class Set::Property {
 public:
+    QString uid;        // the unique id in the project file
+    bool isDirty;       // changed since the last snapshot
+    bool isLoaded;      // the details are read from the project file
     QString name;       // the name of the set
     QString* model;     // the model that the model is belong to
     QString* project;   // the set that is belong to
@@ -156,8 +180,6 @@ public:
     int createType;     // the type in creation the set
     QVector<int> data;  // the index of the data
 
-    QSqlDatabase db;    // the database object
-    QString dbname;     // the name of database
     bool ifCreateDb;    // whether the database has been created or not
 
     bool assigned;      // whether the model is assigned
@@ -174,8 +196,11 @@ public:
     /*  destructor: destroy the set property object  */
     ~Property();
 
-    /*  saveDatabase: save the set data to the local database  */
-    void saveDatabase(QString& workDir);
+    /*  snapshot: append the set to the snapshot of the project, the data is
+     *  the shared copy of the indices
+     *  @param  records: the statements of the snapshot
+     *  @param  modelUid: the unique id of the model  */
+    void snapshot(QVector<Autosave::Record>& records, const QString& modelUid);
 };
 
 #endif  // SET_H
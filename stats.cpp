@@ -0,0 +1,302 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : stats.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "stats.h"
+
+#include <vtkArrayDispatch.h>
+#include <vtkCellArray.h>
+#include <vtkDataArrayRange.h>
+#include <vtkIdList.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPThreadLocalObject.h>
+#include <vtkSMPTools.h>
+
+#include <QApplication>
+#include <QSignalBlocker>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "ui_stats.h"
+
+/*  number of the histogram bars  */
+static const int NUM_BARS = 64;
+
+/*  number of the steps of the threshold slider  */
+static const int SLIDER_STEPS = 1000;
+
+/*  ############################################################################
+ *  value: get the scalar value of the tuple, the magnitude is used for the
+ *  multi-component arrays  */
+template <typename TupleT>
+static double value(const TupleT& tuple, const int numComps) {
+    if (numComps == 1) return static_cast<double>(tuple[0]);
+    double sum = 0.0;
+    for (int c = 0; c < numComps; ++c) {
+        double comp = static_cast<double>(tuple[c]);
+        sum += comp * comp;
+    }
+    return std::sqrt(sum);
+}
+
+/*  Moments: the count, sum and squared sum of the values shifted by the
+ *  center of the range, and the histogram  */
+struct Moments {
+    double count;             // number of the valid values
+    double sum;               // sum of the shifted values
+    double square;            // squared sum of the shifted values
+    std::vector<double> bars; // histogram of the values
+};
+
+/*  MomentWorker: the parallel reduction of the moments and histogram  */
+struct MomentWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, const double* range, Moments& moments) {
+        /*  the local moments of each thread  */
+        Moments exemplar = {0.0, 0.0, 0.0, std::vector<double>(NUM_BARS, 0.0)};
+        vtkSMPThreadLocal<Moments> local(exemplar);
+        const int numComps = array->GetNumberOfComponents();
+        const double shift = 0.5 * (range[0] + range[1]);
+        const double scale =
+            range[1] > range[0] ? NUM_BARS / (range[1] - range[0]) : 0.0;
+
+        /*  reduce the blocks  */
+        vtkSMPTools::For(0, array->GetNumberOfTuples(),
+                         [&](vtkIdType begin, vtkIdType end) {
+                             Moments& m = local.Local();
+                             for (const auto tuple :
+                                  vtk::DataArrayTupleRange(array, begin, end)) {
+                                 double v = value(tuple, numComps);
+                                 if (std::isnan(v)) continue;
+                                 double d = v - shift;
+                                 m.count += 1.0;
+                                 m.sum += d;
+                                 m.square += d * d;
+                                 int bar = int((v - range[0]) * scale);
+                                 m.bars[std::clamp(bar, 0, NUM_BARS - 1)]++;
+                             }
+                         });
+
+        /*  combine the local moments  */
+        moments = exemplar;
+        for (const Moments& m : local) {
+            moments.count += m.count;
+            moments.sum += m.sum;
+            moments.square += m.square;
+            for (int i = 0; i < NUM_BARS; ++i) moments.bars[i] += m.bars[i];
+        }
+    }
+};
+
+/*  CellValueWorker: the parallel evaluation of the cell values and their
+ *  volumes, the nodal values are averaged over the nodes of each cell. The
+ *  invalid values are assigned with zero volume  */
+struct CellValueWorker {
+    template <typename ArrayT>
+    void operator()(ArrayT* array, vtkUnstructuredGrid* ugrid,
+                    vtkDoubleArray* volume, const bool isPoint,
+                    std::vector<std::pair<double, double>>& cells) {
+        vtkSMPThreadLocalObject<vtkIdList> ids;
+        vtkCellArray* connect = ugrid->GetCells();
+        const auto tuples     = vtk::DataArrayTupleRange(array);
+        const int numComps    = array->GetNumberOfComponents();
+
+        /*  evaluate the blocks  */
+        vtkSMPTools::For(
+            0, ugrid->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+                vtkIdList* list = ids.Local();
+                for (vtkIdType i = begin; i < end; ++i) {
+                    double v = 0.0;
+                    if (isPoint) {
+                        //  average over the nodes of the cell
+                        vtkIdType npts;
+                        const vtkIdType* pts;
+                        connect->GetCellAtId(i, npts, pts, list);
+                        for (vtkIdType k = 0; k < npts; ++k) {
+                            v += value(tuples[pts[k]], numComps);
+                        }
+                        v /= std::max<vtkIdType>(npts, 1);
+                    } else {
+                        v = value(tuples[i], numComps);
+                    }
+                    //  the invalid value never exceeds the threshold
+                    if (std::isnan(v)) {
+                        cells[i] = {-HUGE_VAL, 0.0};
+                    } else {
+                        cells[i] = {v, volume->GetValue(i)};
+                    }
+                }
+            });
+    }
+};
+
+/*  ############################################################################
+ *  constructor: create the Stats object  */
+Stats::Stats(QWidget* parent) : QDialog(parent), ui(new Ui::Stats) {
+    /*  setup the UI interface  */
+    ui->setupUi(this);
+    plot = new Plot(this);
+    ui->plotLayout->addWidget(plot);
+    reset();
+
+    /*  connect to the CLOSE button  */
+    connect(ui->btnClose, &QPushButton::clicked, this, &QDialog::close);
+
+    /*  connect the threshold, slider and the chart  */
+    connect(ui->threshold, &QDoubleSpinBox::valueChanged, this,
+            &Stats::setThreshold);
+    connect(ui->thresholdSlider, &QSlider::valueChanged, this, [&](int step) {
+        double ratio = double(step) / SLIDER_STEPS;
+        ui->threshold->setValue(range[0] + ratio * (range[1] - range[0]));
+    });
+    connect(plot, &Plot::clicked, this,
+            [&](double x) { ui->threshold->setValue(x); });
+}
+
+/*  destructor: destroy the Stats object  */
+Stats::~Stats() { delete ui; }
+
+/*  ============================================================================
+ *  setInputData: compute the statistics of the field component, the nodal
+ *  values are averaged over the nodes of each cell for the volume integral
+ *  and volume fraction
+ *  @param  field: the field variables
+ *  @param  idx: the index of the field in the name list
+ *  @param  comp: the component of the nodal field  */
+void Stats::setInputData(Field* field, const int idx, const int comp) {
+    /*  get the array of the field  */
+    reset();
+    vtkDataArray* array = field->getFieldArray(idx, comp);
+    if (array == nullptr) return;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+
+    /*  name of the field  */
+    bool isPoint = idx < field->getNumberOfPointData();
+    QString name = field->getFieldName(idx);
+    if (isPoint) name += QString(":") + field->getCompName(comp);
+    ui->fieldLabel->setText(name);
+
+    /*  range of the field  */
+    double* r = field->getArrayRange(array, false);
+    range[0]  = r[0];
+    range[1]  = r[1];
+
+    /*  moments and histogram  */
+    Moments moments;
+    MomentWorker momentWorker;
+    if (!vtkArrayDispatch::Dispatch::Execute(array, momentWorker, range,
+                                             moments)) {
+        momentWorker(array, range, moments);
+    }
+    double count = std::max(moments.count, 1.0);
+    double mean  = moments.sum / count;
+    double var   = moments.square / count - mean * mean;
+    mean += 0.5 * (range[0] + range[1]);
+
+    /*  values and volumes of the cells  */
+    vtkUnstructuredGrid* ugrid = field->getInputData();
+    vtkDoubleArray* volume     = field->getCellVolumes();
+    std::vector<std::pair<double, double>> cells(ugrid->GetNumberOfCells());
+    CellValueWorker cellWorker;
+    if (!vtkArrayDispatch::Dispatch::Execute(array, cellWorker, ugrid, volume,
+                                             isPoint, cells)) {
+        cellWorker(array, ugrid, volume, isPoint, cells);
+    }
+
+    /*  sort the cells by the values and accumulate the volumes from the
+     *  largest value, the integral is also summed in this order  */
+    vtkSMPTools::Sort(cells.begin(), cells.end());
+    double integral = 0.0;
+    values.resize(cells.size());
+    volumes.resize(cells.size() + 1);
+    volumes[cells.size()] = 0.0;
+    for (size_t i = cells.size(); i > 0; --i) {
+        values[i - 1]  = cells[i - 1].first;
+        volumes[i - 1] = volumes[i] + cells[i - 1].second;
+        if (cells[i - 1].second > 0.0) {
+            integral += cells[i - 1].first * cells[i - 1].second;
+        }
+    }
+    totalVolume = volumes[0];
+
+    /*  show the statistics  */
+    ui->countValue->setText(QString::number(qint64(moments.count)));
+    ui->minValue->setText(QString::number(range[0], 'g', 6));
+    ui->maxValue->setText(QString::number(range[1], 'g', 6));
+    ui->meanValue->setText(QString::number(mean, 'g', 6));
+    ui->stdValue->setText(QString::number(std::sqrt(std::max(var, 0.0)),
+                                          'g', 6));
+    ui->integralValue->setText(QString::number(integral, 'g', 6));
+    ui->volumeValue->setText(QString::number(totalVolume, 'g', 6));
+    plot->setBars(QVector<double>(moments.bars.begin(), moments.bars.end()),
+                  range);
+
+    /*  initialize the threshold by the mean value  */
+    ui->threshold->setEnabled(true);
+    ui->thresholdSlider->setEnabled(true);
+    ui->threshold->setRange(range[0], range[1]);
+    ui->threshold->setSingleStep((range[1] - range[0]) / 100.0);
+    ui->threshold->setValue(mean);
+    setThreshold(ui->threshold->value());
+    QApplication::restoreOverrideCursor();
+}
+
+/*  ============================================================================
+ *  setThreshold: update the volume fraction above the threshold
+ *  @param  value: the threshold value  */
+void Stats::setThreshold(double value) {
+    if (values.empty()) return;
+
+    /*  find the first cell above the threshold  */
+    size_t idx = std::upper_bound(values.begin(), values.end(), value) -
+                 values.begin();
+    double fraction = totalVolume > 0.0 ? volumes[idx] / totalVolume : 0.0;
+    ui->fractionValue->setText(QString::number(100.0 * fraction, 'f', 2) +
+                               " %");
+    ui->cellsValue->setText(QString::number(qint64(values.size() - idx)));
+
+    /*  synchronize the slider and the marker  */
+    double span = range[1] - range[0];
+    int step    = span > 0.0 ? qRound((value - range[0]) / span * SLIDER_STEPS)
+                             : 0;
+    QSignalBlocker blocker(ui->thresholdSlider);
+    ui->thresholdSlider->setValue(step);
+    plot->setMarker(value);
+}
+
+/*  reset: clear the statistics  */
+void Stats::reset() {
+    /*  release the sorted cells  */
+    std::vector<double>().swap(values);
+    std::vector<double>().swap(volumes);
+    totalVolume = 0.0;
+    range[0]    = 0.0;
+    range[1]    = 1.0;
+
+    /*  clear the widgets  */
+    ui->fieldLabel->setText("No field");
+    ui->countValue->setText("-");
+    ui->minValue->setText("-");
+    ui->maxValue->setText("-");
+    ui->meanValue->setText("-");
+    ui->stdValue->setText("-");
+    ui->integralValue->setText("-");
+    ui->volumeValue->setText("-");
+    ui->fractionValue->setText("-");
+    ui->cellsValue->setText("-");
+    ui->threshold->setEnabled(false);
+    ui->thresholdSlider->setEnabled(false);
+    plot->clear();
+}
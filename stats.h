@@ -0,0 +1,74 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : stats.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef STATS_H
+#define STATS_H
+
+#include <QDialog>
+#include <vector>
+
+#include "field.h"
+#include "plot.h"
+
+namespace Ui {
+class Stats;
+}
+
+/*  ############################################################################
+ *  class Stats: the statistics panel of the selected field, which shows the
+ *      histogram, mean, standard deviation, volume integral and the volume
+ *      fraction above the threshold. The moments and histogram are reduced
+ *      by the parallel kernels, and the cell values are sorted once with the
+ *      accumulated volumes, so that the volume fraction is updated by a
+ *      binary search when the threshold changes.  */
+class Stats : public QDialog {
+    Q_OBJECT
+
+private:
+    Ui::Stats* ui;                // UI interface
+    Plot* plot;                   // histogram of the field
+
+    double range[2];              // range of the field
+    std::vector<double> values;   // sorted cell values of the field
+    std::vector<double> volumes;  // volume of the cells not below the value
+    double totalVolume;           // total volume of the cells
+
+public:
+    /*  ########################################################################
+     *  constructor: create the Stats object  */
+    explicit Stats(QWidget* parent = nullptr);
+
+    /*  destructor: destroy the Stats object  */
+    ~Stats();
+
+    /*  setInputData: compute the statistics of the field component, the
+     *  nodal values are averaged over the nodes of each cell for the volume
+     *  integral and volume fraction
+     *  @param  field: the field variables
+     *  @param  idx: the index of the field in the name list
+     *  @param  comp: the component of the nodal field  */
+    void setInputData(Field* field, const int idx, const int comp);
+
+private slots:
+    /*  ########################################################################
+     *  setThreshold: update the volume fraction above the threshold
+     *  @param  value: the threshold value  */
+    void setThreshold(double value);
+
+private:
+    /*  reset: clear the statistics  */
+    void reset();
+};
+#endif  // STATS_H
@@ -0,0 +1,343 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : surface.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "surface.h"
+
+#include <vtkCellArray.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkFloatArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTriangleFilter.h>
+
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "prenano.h"
+
+/*  suffix of the selected field sent in place of an anchor, whose name is
+ *  kept for the local anchor of the filtered surface  */
+static const QString ANCHOR_SUFFIX = " (surface)";
+
+/*  writeArray: write the values in little endian
+ *  @param  out: the stream of the payload
+ *  @param  data: the values, which are swapped in place  */
+template <typename T>
+static void writeArray(QDataStream& out, std::vector<T>& data) {
+    qToLittleEndian<T>(data.data(), qsizetype(data.size()), data.data());
+    out.writeRawData(reinterpret_cast<const char*>(data.data()),
+                     int(data.size() * sizeof(T)));
+}
+
+/*  readArray: read the values in little endian
+ *  @param  in: the stream of the payload
+ *  @param  data: the values, which are sized by the caller
+ *  @return  false if the stream is truncated  */
+template <typename T>
+static bool readArray(QDataStream& in, std::vector<T>& data) {
+    int bytes = int(data.size() * sizeof(T));
+    if (in.readRawData(reinterpret_cast<char*>(data.data()), bytes) != bytes) {
+        return false;
+    }
+    qFromLittleEndian<T>(data.data(), qsizetype(data.size()), data.data());
+    return true;
+}
+
+/*  ############################################################################
+ *  encode: run the filters of the request and pack the external surface
+ *  @param  field: the field of the requested file
+ *  @param  request: the parameters of the filters
+ *  @param  payload: the compressed surface
+ *  @param  error: the error message
+ *  @return  the status, true for success, otherwise failed  */
+bool Surface::encode(Field* field, const Request& request,
+                     QByteArray& payload, QString& error) {
+    vtkAlgorithmOutput* port = filter(field, request, error);
+    if (port == nullptr) return false;
+
+    /*  extract the external surface as triangles, the point and cell data
+     *  are passed to the surface  */
+    vtkDataSetSurfaceFilter* surfaceFilter = vtkDataSetSurfaceFilter::New();
+    surfaceFilter->SetInputConnection(port);
+    vtkTriangleFilter* triangleFilter = vtkTriangleFilter::New();
+    triangleFilter->SetInputConnection(surfaceFilter->GetOutputPort());
+    triangleFilter->PassVertsOff();
+    triangleFilter->PassLinesOff();
+    triangleFilter->Update();
+    vtkPolyData* poly = triangleFilter->GetOutput();
+
+    /*  the nodal field has been splitted into the components, which are
+     *  gathered again, so the magnitude is computed by the client  */
+    int idx      = field->getFieldNameList().indexOf(request.name);
+    bool isPoint = idx < field->getNumberOfPointData();
+    std::vector<vtkDataArray*> arrays;
+    if (isPoint) {
+        for (int i = 0; i < 3; ++i) {
+            QString array = request.name + ":" + field->getCompNameList()[i];
+            arrays.push_back(
+                poly->GetPointData()->GetArray(array.toStdString().c_str()));
+        }
+    } else {
+        arrays.push_back(poly->GetCellData()->GetArray(
+            request.name.toStdString().c_str()));
+    }
+    int numComp = 0;
+    for (vtkDataArray* array : arrays) {
+        if (array == nullptr) {
+            error = "The field " + request.name + " is not loaded.";
+            triangleFilter->Delete();
+            surfaceFilter->Delete();
+            return false;
+        }
+        numComp += array->GetNumberOfComponents();
+    }
+
+    /*  quantize the coordinates in the bounding box  */
+    double bounds[6];
+    poly->GetBounds(bounds);
+    vtkIdType numPoints = poly->GetNumberOfPoints();
+    std::vector<quint16> coords(3 * numPoints);
+    for (vtkIdType i = 0; i < numPoints; ++i) {
+        double* x = poly->GetPoint(i);
+        for (int k = 0; k < 3; ++k) {
+            double extent = bounds[2 * k + 1] - bounds[2 * k];
+            double t = extent > 0.0 ? (x[k] - bounds[2 * k]) / extent : 0.0;
+            coords[3 * i + k] =
+                quint16(std::lround(t * PRENANO::SURFACE_LEVELS));
+        }
+    }
+
+    /*  connectivity of the triangles  */
+    vtkCellArray* polys    = poly->GetPolys();
+    vtkIdType numTriangles = polys->GetNumberOfCells();
+    std::vector<quint32> connectivity(3 * numTriangles);
+    vtkIdType numIds;
+    const vtkIdType* ids;
+    for (vtkIdType i = 0; i < numTriangles; ++i) {
+        polys->GetCellAtId(i, numIds, ids);
+        for (int k = 0; k < 3; ++k) connectivity[3 * i + k] = quint32(ids[k]);
+    }
+
+    /*  values of the selected field in single precision  */
+    vtkIdType numTuples = isPoint ? numPoints : numTriangles;
+    std::vector<float> values(numComp * numTuples);
+    for (vtkIdType i = 0, j = 0; i < numTuples; ++i) {
+        for (vtkDataArray* array : arrays) {
+            for (int k = 0; k < array->GetNumberOfComponents(); ++k) {
+                values[j++] = float(array->GetComponent(i, k));
+            }
+        }
+    }
+
+    /*  pack and compress the surface, the selected anchor is renamed so that
+     *  the client does not warp or threshold it again  */
+    QString name = request.name;
+    if (name == "U" || name == "Var-0") name += ANCHOR_SUFFIX;
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    out << name << isPoint << quint8(numComp);
+    for (int i = 0; i < 6; ++i) out << bounds[i];
+    out << quint32(numPoints);
+    writeArray(out, coords);
+    out << quint32(numTriangles);
+    writeArray(out, connectivity);
+    writeArray(out, values);
+    payload = qCompress(raw);
+
+    /*  release the filters  */
+    triangleFilter->Delete();
+    surfaceFilter->Delete();
+    return true;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  decode: unpack the surface into the unstructured grid of triangles, the
+ *  anchors, i.e., zero U and unit Var-0, are filled locally since the warp
+ *  and the threshold have been applied by the server
+ *  @param  payload: the compressed surface
+ *  @return  the new grid owned by the caller, nullptr if corrupted  */
+vtkUnstructuredGrid* Surface::decode(const QByteArray& payload) {
+    QByteArray raw = qUncompress(payload);
+    QDataStream in(raw);
+
+    /*  header of the surface  */
+    QString name;
+    bool isPoint;
+    quint8 numComp;
+    double bounds[6];
+    quint32 numPoints, numTriangles;
+    in >> name >> isPoint >> numComp;
+    for (int i = 0; i < 6; ++i) in >> bounds[i];
+    in >> numPoints;
+    //  the counts are checked before the arrays are allocated
+    if (in.status() != QDataStream::Ok || numComp == 0 ||
+        qint64(numPoints) * 6 > raw.size()) {
+        return nullptr;
+    }
+    std::vector<quint16> coords(3 * size_t(numPoints));
+    if (!readArray(in, coords)) return nullptr;
+    in >> numTriangles;
+    if (in.status() != QDataStream::Ok ||
+        qint64(numTriangles) * 12 > raw.size()) {
+        return nullptr;
+    }
+    std::vector<quint32> connectivity(3 * size_t(numTriangles));
+    if (!readArray(in, connectivity)) return nullptr;
+    size_t numTuples = isPoint ? numPoints : numTriangles;
+    std::vector<float> values(numComp * numTuples);
+    if (!readArray(in, values)) return nullptr;
+    for (quint32 id : connectivity) {
+        if (id >= numPoints) return nullptr;
+    }
+
+    /*  restore the coordinates from the bounding box  */
+    vtkPoints* points = vtkPoints::New();
+    points->SetDataTypeToFloat();
+    points->SetNumberOfPoints(numPoints);
+    double scale[3];
+    for (int k = 0; k < 3; ++k) {
+        double extent = bounds[2 * k + 1] - bounds[2 * k];
+        scale[k]      = extent / PRENANO::SURFACE_LEVELS;
+    }
+    for (quint32 i = 0; i < numPoints; ++i) {
+        points->SetPoint(i, bounds[0] + coords[3 * i] * scale[0],
+                         bounds[2] + coords[3 * i + 1] * scale[1],
+                         bounds[4] + coords[3 * i + 2] * scale[2]);
+    }
+
+    /*  triangles of the surface  */
+    vtkCellArray* cells = vtkCellArray::New();
+    cells->AllocateExact(numTriangles, 3 * vtkIdType(numTriangles));
+    for (quint32 i = 0; i < numTriangles; ++i) {
+        vtkIdType ids[3] = {connectivity[3 * i], connectivity[3 * i + 1],
+                            connectivity[3 * i + 2]};
+        cells->InsertNextCell(3, ids);
+    }
+    vtkUnstructuredGrid* ugrid = vtkUnstructuredGrid::New();
+    ugrid->SetPoints(points);
+    ugrid->SetCells(VTK_TRIANGLE, cells);
+    points->Delete();
+    cells->Delete();
+
+    /*  the selected field  */
+    vtkFloatArray* data = vtkFloatArray::New();
+    data->SetName(name.toStdString().c_str());
+    data->SetNumberOfComponents(numComp);
+    data->SetNumberOfTuples(vtkIdType(numTuples));
+    std::copy(values.begin(), values.end(), data->GetPointer(0));
+    if (isPoint) {
+        ugrid->GetPointData()->AddArray(data);
+    } else {
+        ugrid->GetCellData()->AddArray(data);
+    }
+    data->Delete();
+
+    /*  the anchors, the surface has been warped and thresholded, so they
+     *  replace the arrays of the same names  */
+    vtkDoubleArray* anchor = vtkDoubleArray::New();
+    anchor->SetName("U");
+    anchor->SetNumberOfComponents(3);
+    anchor->SetNumberOfTuples(numPoints);
+    anchor->Fill(0.0);
+    ugrid->GetPointData()->AddArray(anchor);
+    anchor->Delete();
+    anchor = vtkDoubleArray::New();
+    anchor->SetName("Var-0");
+    anchor->SetNumberOfComponents(1);
+    anchor->SetNumberOfTuples(numTriangles);
+    anchor->Fill(1.0);
+    ugrid->GetCellData()->AddArray(anchor);
+    anchor->Delete();
+    return ugrid;
+}
+
+/*  ============================================================================
+ *  filter: apply the filters of the request to the field
+ *  @param  field: the field of the requested file
+ *  @param  request: the parameters of the filters
+ *  @param  error: the error message
+ *  @return  the port of the last filter, nullptr if failed  */
+vtkAlgorithmOutput* Surface::filter(Field* field, const Request& request,
+                                    QString& error) {
+    /*  load the selected field on demand  */
+    int idx = field->getFieldNameList().indexOf(request.name);
+    if (idx < 0) {
+        error = "The field " + request.name + " is not found.";
+        return nullptr;
+    }
+    field->requestField(idx);
+
+    /*  warp and threshold, the last picking is reset  */
+    field->setWarpScale(request.warpScale);
+    field->setLimits(request.limitType, request.lower, request.upper);
+    field->updateAnchor();
+    field->resetCellPick(PRENANO::USE_ORIGIN_FIELD);
+    vtkAlgorithmOutput* port = field->getThresholdOutputPort();
+
+    /*  pick the cells of the threshold output  */
+    if (!request.pickIds.isEmpty()) {
+        vtkIdType numCells = field->getThresholdOutput()->GetNumberOfCells();
+        vtkIdTypeArray* ids = vtkIdTypeArray::New();
+        for (qint64 id : request.pickIds) {
+            if (id < 0 || id >= numCells) {
+                error = QString("The picked cell %1 is out of the %2 cells.")
+                            .arg(id)
+                            .arg(numCells);
+                ids->Delete();
+                return nullptr;
+            }
+            ids->InsertNextValue(id);
+        }
+        field->performCellPick(PRENANO::USE_ORIGIN_FIELD, false,
+                               request.isPickHidden, ids);
+        ids->Delete();
+        //  the picked array is changed in place, so run the filter again
+        port = field->getPickOutputPort();
+        port->GetProducer()->Modified();
+        port->GetProducer()->Update();
+    }
+
+    /*  mirror the thresholded or picked cells  */
+    if (request.isMirrored()) {
+        field->mirror(false, request.planes, request.offset, request.rotation);
+        port = field->getMirrorOutputPort();
+    }
+    return port;
+}
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  write: write the request to the stream
+ *  @param  out: the stream of the payload  */
+void Surface::Request::write(QDataStream& out) const {
+    out << path << name << warpScale << qint32(limitType) << lower << upper
+        << pickIds << isPickHidden;
+    for (int i = 0; i < 3; ++i) {
+        out << planes[i] << offset[i] << rotation[i];
+    }
+}
+
+/*  read: read the request from the stream
+ *  @param  in: the stream of the payload  */
+void Surface::Request::read(QDataStream& in) {
+    qint32 type;
+    in >> path >> name >> warpScale >> type >> lower >> upper >> pickIds >>
+        isPickHidden;
+    limitType = type;
+    for (int i = 0; i < 3; ++i) {
+        in >> planes[i] >> offset[i] >> rotation[i];
+    }
+}
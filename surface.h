@@ -0,0 +1,101 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : surface.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef SURFACE_H
+#define SURFACE_H
+
+#include <vtkUnstructuredGrid.h>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+#include <QVector>
+
+#include "field.h"
+
+/*  ############################################################################
+ *  class Surface: the server-side filtering of the remote results. The warp,
+ *      the density threshold, the pick and the mirror of Field run next to
+ *      the data, and only the external surface is sent to the GUI, i.e., the
+ *      triangles, the coordinates quantized in the bounding box and the
+ *      selected field in single precision. The decoded surface is a plain
+ *      unstructured grid, so it is opened by Field like the local results,
+ *      and its anchors are neutral since the filters have been applied.
+ *
+ *      payload (compressed): name, isPoint, components, bounds[6],
+ *          points, {x, y, z} in 16 bits, triangles, {a, b, c} in 32 bits,
+ *          values of the field in 32 bits, all the arrays in little endian  */
+class Surface {
+public:
+    class Request;  // the file and the parameters of the filters
+
+public:
+    /*  ########################################################################
+     *  encode: run the filters of the request and pack the external surface
+     *  @param  field: the field of the requested file
+     *  @param  request: the parameters of the filters
+     *  @param  payload: the compressed surface
+     *  @param  error: the error message
+     *  @return  the status, true for success, otherwise failed  */
+    static bool encode(Field* field, const Request& request,
+                       QByteArray& payload, QString& error);
+
+    /*  decode: unpack the surface into the unstructured grid of triangles,
+     *  the anchors, i.e., zero U and unit Var-0, are filled locally since
+     *  the warp and the threshold have been applied by the server
+     *  @param  payload: the compressed surface
+     *  @return  the new grid owned by the caller, nullptr if corrupted  */
+    static vtkUnstructuredGrid* decode(const QByteArray& payload);
+
+private:
+    /*  filter: apply the filters of the request to the field
+     *  @param  field: the field of the requested file
+     *  @param  request: the parameters of the filters
+     *  @param  error: the error message
+     *  @return  the port of the last filter, nullptr if failed  */
+    static vtkAlgorithmOutput* filter(Field* field, const Request& request,
+                                      QString& error);
+};
+
+/*  ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+ *  class Surface::Request: the remote file, the selected field and the
+ *      parameters of the filters, which follow the local pipeline of Field  */
+class Surface::Request {
+public:
+    QString path;               // file relative to the server root
+    QString name;               // selected field in the name list
+    double warpScale   = 0.0;   // scale of the displacement
+    int limitType      = 0;     // type of the density limits
+    double lower       = 0.0;   // lower limit of the density
+    double upper       = 1.0;   // upper limit of the density
+    QVector<qint64> pickIds;    // cells of the threshold, none if empty
+    bool isPickHidden  = true;  // hide or extract the picked cells
+    bool planes[3]     = {};    // mirror about the XY, YZ, XZ plane
+    double offset[3]   = {};    // offset of the mirror plane
+    double rotation[3] = {};    // rotation of the mirrored part
+
+    /*  write: write the request to the stream
+     *  @param  out: the stream of the payload  */
+    void write(QDataStream& out) const;
+
+    /*  read: read the request from the stream
+     *  @param  in: the stream of the payload  */
+    void read(QDataStream& in);
+
+    /*  isMirrored: check whether any mirror plane is used
+     *  @return  true if the field is mirrored  */
+    bool isMirrored() const { return planes[0] || planes[1] || planes[2]; }
+};
+#endif  // SURFACE_H
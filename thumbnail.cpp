@@ -0,0 +1,276 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : thumbnail.cpp
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#include "thumbnail.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellDataToPointData.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDecimatePro.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkTriangleFilter.h>
+#include <vtkUnstructuredGrid.h>
+#include <vtkWarpVector.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <QColor>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QPainter>
+#include <QPolygonF>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "prenano.h"
+
+/*  ############################################################################
+ *  constructor: create an empty thumbnail  */
+Thumbnail::Thumbnail() { stamp = 0; }
+
+/*  constructor: load the thumbnail from the disk cache, or render and cache it
+ *  if it is not found
+ *  @param  file: the path of the result file
+ *  @param  size: the width and height of the image in pixels  */
+Thumbnail::Thumbnail(const QString& file, const int size) {
+    path  = file;
+    stamp = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    /*  load the cached image  */
+    QString cacheFile = getCacheFile(size);
+    if (QFileInfo::exists(cacheFile) && image.load(cacheFile)) return;
+
+    /*  render the image and write it to the disk cache  */
+    vtkPolyData* surface = extractSurface();
+    if (surface == nullptr) return;
+    rasterize(surface, size);
+    surface->Delete();
+    if (!image.isNull()) image.save(cacheFile, "PNG");
+}
+
+/*  ============================================================================
+ *  getCacheFile: get the path of the cached image
+ *  @param  size: the width and height of the image in pixels
+ *  @return  the path of the cached image  */
+QString Thumbnail::getCacheFile(const int size) {
+    QString dir =
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        "/thumbnails";
+    QDir().mkpath(dir);
+
+    /*  the image is named by the hash of the path, time and size  */
+    QByteArray key =
+        QString("%1:%2:%3").arg(path).arg(stamp).arg(size).toUtf8();
+    return dir + "/" +
+           QCryptographicHash::hash(key, QCryptographicHash::Md5).toHex() +
+           ".png";
+}
+
+/*  ============================================================================
+ *  extractSurface: read the result file and extract the decimated surface of
+ *  the deformed geometry with the default field as point scalars
+ *  @return  the surface, nullptr if failed  */
+vtkPolyData* Thumbnail::extractSurface() {
+    /*  read the result file  */
+    vtkXMLUnstructuredGridReader* reader = vtkXMLUnstructuredGridReader::New();
+    if (!reader->CanReadFile(path.toStdString().c_str())) {
+        reader->Delete();
+        return nullptr;
+    }
+    reader->SetFileName(path.toStdString().c_str());
+    reader->Update();
+    vtkUnstructuredGrid* ugrid = reader->GetOutput();
+
+    /*  the default field is the element density, or the magnitude of the
+     *  displacement if the density is not found  */
+    vtkCellDataToPointData* c2p = vtkCellDataToPointData::New();
+    c2p->SetInputConnection(reader->GetOutputPort());
+    c2p->PassCellDataOff();
+
+    /*  deform the geometry using the displacement  */
+    vtkWarpVector* warp = vtkWarpVector::New();
+    warp->SetInputConnection(c2p->GetOutputPort());
+    bool isDeformed = ugrid->GetPointData()->GetArray("U") != nullptr;
+    if (isDeformed) {
+        warp->SetInputArrayToProcess(
+            0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "U");
+        warp->SetScaleFactor(1.0);
+    }
+
+    /*  extract the triangulated surface  */
+    vtkDataSetSurfaceFilter* surfaceFilter = vtkDataSetSurfaceFilter::New();
+    if (isDeformed) {
+        surfaceFilter->SetInputConnection(warp->GetOutputPort());
+    } else {
+        surfaceFilter->SetInputConnection(c2p->GetOutputPort());
+    }
+    vtkTriangleFilter* triangle = vtkTriangleFilter::New();
+    triangle->SetInputConnection(surfaceFilter->GetOutputPort());
+    triangle->Update();
+
+    /*  decimate the surface to the triangle budget of the thumbnail  */
+    vtkPolyData* surface = vtkPolyData::New();
+    vtkIdType numTriangles = triangle->GetOutput()->GetNumberOfPolys();
+    if (numTriangles > PRENANO::THUMBNAIL_TRIANGLES) {
+        vtkDecimatePro* decimate = vtkDecimatePro::New();
+        decimate->SetInputConnection(triangle->GetOutputPort());
+        decimate->SetTargetReduction(
+            1.0 - double(PRENANO::THUMBNAIL_TRIANGLES) / numTriangles);
+        decimate->PreserveTopologyOff();
+        decimate->SplittingOn();
+        decimate->BoundaryVertexDeletionOn();
+        decimate->Update();
+        surface->ShallowCopy(decimate->GetOutput());
+        decimate->Delete();
+    } else {
+        surface->ShallowCopy(triangle->GetOutput());
+    }
+
+    /*  assign the scalars of the default field  */
+    vtkPointData* pointData = surface->GetPointData();
+    if (pointData->GetArray("Var-0") != nullptr) {
+        pointData->SetActiveScalars("Var-0");
+    } else if (pointData->GetArray("U") != nullptr) {
+        pointData->SetActiveScalars("U");
+    }
+
+    /*  release the pipeline  */
+    triangle->Delete();
+    surfaceFilter->Delete();
+    warp->Delete();
+    c2p->Delete();
+    reader->Delete();
+    return surface;
+}
+
+/*  ============================================================================
+ *  rasterize: paint the triangles of the surface to the image using the
+ *  axonometric view and the painter's algorithm
+ *  @param  surface: the decimated surface
+ *  @param  size: the width and height of the image in pixels  */
+void Thumbnail::rasterize(vtkPolyData* surface, const int size) {
+    /*  check the surface  */
+    vtkIdType numPoints = surface->GetNumberOfPoints();
+    if (numPoints == 0 || surface->GetNumberOfPolys() == 0) return;
+
+    /*  axonometric view, i.e., looking from (1, 1, 1) with z axis upward  */
+    double view[3]  = {1.0, 1.0, 1.0};
+    double up[3]    = {0.0, 0.0, 1.0};
+    double right[3] = {0.0, 0.0, 0.0};
+    vtkMath::Normalize(view);
+    vtkMath::Cross(up, view, right);
+    vtkMath::Normalize(right);
+    vtkMath::Cross(view, right, up);
+
+    /*  project the points to the view plane  */
+    double center[3];
+    surface->GetCenter(center);
+    std::vector<double> screen(numPoints * 3);
+    double xmin = VTK_DOUBLE_MAX, xmax = VTK_DOUBLE_MIN;
+    double ymin = VTK_DOUBLE_MAX, ymax = VTK_DOUBLE_MIN;
+    for (vtkIdType i = 0; i < numPoints; ++i) {
+        double p[3];
+        surface->GetPoint(i, p);
+        vtkMath::Subtract(p, center, p);
+        screen[i * 3 + 0] = vtkMath::Dot(p, right);
+        screen[i * 3 + 1] = vtkMath::Dot(p, up);
+        screen[i * 3 + 2] = vtkMath::Dot(p, view);
+        xmin = std::min(xmin, screen[i * 3 + 0]);
+        xmax = std::max(xmax, screen[i * 3 + 0]);
+        ymin = std::min(ymin, screen[i * 3 + 1]);
+        ymax = std::max(ymax, screen[i * 3 + 1]);
+    }
+    //  fit the projection to the image with margins
+    double extent = std::max(xmax - xmin, ymax - ymin);
+    double scale  = extent > 0.0 ? (size - 4.0) / extent : 1.0;
+    double xmid = (xmin + xmax) * 0.5, ymid = (ymin + ymax) * 0.5;
+
+    /*  the scalars are mapped to the blue-red hue as the viewer  */
+    vtkDataArray* scalars = surface->GetPointData()->GetScalars();
+    double range[2]       = {0.0, 1.0};
+    if (scalars != nullptr) scalars->GetRange(range, -1);
+    double span = range[1] > range[0] ? range[1] - range[0] : 1.0;
+
+    /*  sort the triangles from far to near  */
+    vtkCellArray* polys = surface->GetPolys();
+    std::vector<vtkIdType> tris;
+    std::vector<std::pair<double, vtkIdType>> order;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    polys->InitTraversal();
+    while (polys->GetNextCell(npts, pts)) {
+        if (npts != 3) continue;
+        double depth = screen[pts[0] * 3 + 2] + screen[pts[1] * 3 + 2] +
+                       screen[pts[2] * 3 + 2];
+        order.emplace_back(depth, vtkIdType(tris.size()));
+        tris.insert(tris.end(), pts, pts + 3);
+    }
+    std::sort(order.begin(), order.end());
+
+    /*  paint the triangles with the flat shading  */
+    image = QImage(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    for (const std::pair<double, vtkIdType>& item : order) {
+        const vtkIdType* tri = &tris[item.second];
+        double p0[3], p1[3], p2[3], e1[3], e2[3], normal[3];
+        surface->GetPoint(tri[0], p0);
+        surface->GetPoint(tri[1], p1);
+        surface->GetPoint(tri[2], p2);
+        vtkMath::Subtract(p1, p0, e1);
+        vtkMath::Subtract(p2, p0, e2);
+        vtkMath::Cross(e1, e2, normal);
+        vtkMath::Normalize(normal);
+        double shade = 0.35 + 0.65 * std::fabs(vtkMath::Dot(normal, view));
+
+        //  determine the color of the triangle
+        QColor color(180, 180, 180);
+        if (scalars != nullptr) {
+            //  the magnitude is used for the vector scalars
+            double value = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                double norm = 0.0;
+                for (int j = 0; j < scalars->GetNumberOfComponents(); ++j) {
+                    double comp = scalars->GetComponent(tri[k], j);
+                    norm += comp * comp;
+                }
+                value += scalars->GetNumberOfComponents() == 1
+                             ? scalars->GetComponent(tri[k], 0) / 3.0
+                             : std::sqrt(norm) / 3.0;
+            }
+            double ratio = std::clamp((value - range[0]) / span, 0.0, 1.0);
+            color        = QColor::fromHsvF(0.667 * (1.0 - ratio), 1.0, 1.0);
+        }
+        painter.setBrush(QColor::fromRgbF(color.redF() * shade,
+                                          color.greenF() * shade,
+                                          color.blueF() * shade));
+
+        //  project the triangle to the image
+        QPolygonF polygon;
+        for (int k = 0; k < 3; ++k) {
+            polygon << QPointF(
+                size * 0.5 + (screen[tri[k] * 3 + 0] - xmid) * scale,
+                size * 0.5 - (screen[tri[k] * 3 + 1] - ymid) * scale);
+        }
+        painter.drawPolygon(polygon);
+    }
+    painter.end();
+}
@@ -0,0 +1,63 @@
+/*  ============================================================================
+ *
+ *       _ __   __ _  ___ _ __   __ _ _ __   ___
+ *      | '_ \ / _` |/ __| '_ \ / _` | '_ \ / _ \
+ *      | |_) | (_| | (__| | | | (_| | | | | (_) |
+ *      | .__/ \__,_|\___|_| |_|\__,_|_| |_|\___/
+ *      |_|
+ *
+ *      File name  : thumbnail.h
+ *      Version    : 3.0
+ *      Author     : Jerry Fan
+ *      Date       : October 18th, 2026
+ *      All copyright © is reserved by zhirui.fan
+ *  ============================================================================
+ *  */
+#ifndef THUMBNAIL_H
+#define THUMBNAIL_H
+
+#include <vtkPolyData.h>
+
+#include <QImage>
+#include <QString>
+
+/*  ############################################################################
+ *  class Thumbnail: the preview image of the vtu result file, i.e., the
+ *      deformed geometry colored by the default field. The decimated surface
+ *      is rasterized by QPainter without any render window, so that the
+ *      thumbnails can be generated by the worker threads. The images are
+ *      cached in the disk by the path and modification time.  */
+class Thumbnail {
+public:
+    QString path;    // path of the result file
+    qint64 stamp;    // modification time of the result file
+    QImage image;    // preview image, null if failed
+
+public:
+    /*  constructor: create an empty thumbnail  */
+    Thumbnail();
+
+    /*  constructor: load the thumbnail from the disk cache, or render and
+     *  cache it if it is not found
+     *  @param  file: the path of the result file
+     *  @param  size: the width and height of the image in pixels  */
+    Thumbnail(const QString& file, const int size);
+
+private:
+    /*  getCacheFile: get the path of the cached image
+     *  @param  size: the width and height of the image in pixels
+     *  @return  the path of the cached image  */
+    QString getCacheFile(const int size);
+
+    /*  extractSurface: read the result file and extract the decimated surface
+     *  of the deformed geometry with the default field as point scalars
+     *  @return  the surface, nullptr if failed  */
+    vtkPolyData* extractSurface();
+
+    /*  rasterize: paint the triangles of the surface to the image using the
+     *  axonometric view and the painter's algorithm
+     *  @param  surface: the decimated surface
+     *  @param  size: the width and height of the image in pixels  */
+    void rasterize(vtkPolyData* surface, const int size);
+};
+#endif  // THUMBNAIL_H
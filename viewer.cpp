@@ -16,6 +16,9 @@
 
 #include "viewer.h"
 
+#include <QDebug>
+#include <algorithm>
+
 #include "prenano.h"
 using namespace PRENANO;
 
@@ -79,8 +82,23 @@ Viewer::Viewer(QVTKOpenGLNativeWidget* window) {
     status->GetPositionCoordinate()->SetValue(0.2, 0.1);
     render->AddActor(status);
 
+    /*  render scheduler  */
+    renderTimer = new QTimer(this);
+    renderTimer->setSingleShot(true);
+    renderTime[0] = 0.0;
+    renderTime[1] = 0.0;
+    renderClock.start();
+    connect(renderTimer, &QTimer::timeout, this, &Viewer::renderNow);
+    //  the renders of the interactor are measured as well
+    renderCallback = vtkCallbackCommand::New();
+    renderCallback->SetCallback(Viewer::onRenderEvent);
+    renderCallback->SetClientData(this);
+    renWin->AddObserver(vtkCommand::StartEvent, renderCallback);
+    renWin->AddObserver(vtkCommand::EndEvent, renderCallback);
+
     /*  arrow viewer  */
     gly        = vtkGlyph3D::New();
+    glyph      = new Glyph;
     arrow      = vtkArrowSource::New();
     polyMapper = vtkPolyDataMapper::New();
 
@@ -97,7 +115,8 @@ Viewer::Viewer(QVTKOpenGLNativeWidget* window) {
     /*  postprocess configuration  */
     post         = new Post(nullptr);
     numIntervals = 12;
-    isAutoLegend = false;
+    isAutoLegend  = false;
+    isClipOutlier = false;
     connect(post, &Post::accepted, this, [&]() {
         //  reset the operation flags
         operateType = USE_ORIGIN_FIELD;
@@ -106,11 +125,65 @@ Viewer::Viewer(QVTKOpenGLNativeWidget* window) {
         field->setLimits(post->getLimitType(), post->getLowerLimit(),
                          post->getUpperLimit());
         numIntervals = post->getNumIntervals();
-        isAutoLegend = post->isUseAutoLegend();
+        isAutoLegend  = post->isUseAutoLegend();
+        isClipOutlier = post->isUseClipOutlier();
         //  update viewerport
         initPointField(recorder[1], recorder[2], FIELD_GENERATE);
     });
 
+    /*  statistics of the field  */
+    stats = new Stats(nullptr);
+
+    /*  section view, the sphere tree of the cells is built once by the
+     *  cutter and reused while the plane is dragged  */
+    sectionPlane    = vtkPlane::New();
+    sectionCutter   = vtkPlaneCutter::New();
+    sectionWidget   = vtkImplicitPlaneWidget2::New();
+    sectionRep      = vtkImplicitPlaneRepresentation::New();
+    sectionCallback = vtkCallbackCommand::New();
+    sectionMapper   = vtkDataSetMapper::New();
+    sectionActor    = vtkActor::New();
+    isSectionActive = false;
+    sectionCutter->SetPlane(sectionPlane);
+    sectionCutter->BuildTreeOn();
+    sectionCutter->BuildHierarchyOn();
+    sectionCutter->InterpolateAttributesOn();
+    sectionMapper->SetInputConnection(sectionCutter->GetOutputPort());
+    sectionActor->SetMapper(sectionMapper);
+    sectionRep->SetPlaceFactor(1.05);
+    sectionRep->OutlineTranslationOff();
+    sectionRep->ScaleEnabledOff();
+    sectionRep->DrawPlaneOff();
+    sectionWidget->SetInteractor(interact);
+    sectionWidget->SetRepresentation(sectionRep);
+    sectionCallback->SetCallback(Viewer::onSectionEvent);
+    sectionCallback->SetClientData(this);
+    sectionWidget->AddObserver(vtkCommand::InteractionEvent, sectionCallback);
+
+    /*  probe of the field, the points can be picked by the left click  */
+    probe          = new Probe(nullptr);
+    probePicker    = vtkCellPicker::New();
+    probeCallback  = vtkCallbackCommand::New();
+    isProbePicking = false;
+    probePicker->SetTolerance(0.0005);
+    probeCallback->SetCallback(Viewer::onProbeEvent);
+    probeCallback->SetClientData(this);
+    interact->AddObserver(vtkCommand::LeftButtonPressEvent, probeCallback);
+    connect(probe, &Probe::pickToggled, this,
+            [&](bool checked) { isProbePicking = checked; });
+
+    /*  iso-surface of the density  */
+    msgbox = new MessageBox(this);
+    iso    = new Iso(nullptr);
+    connect(iso, &Iso::changed, this, [&]() { showIsoSurface(); });
+    connect(iso, &Iso::exported, this, [&](const QString& file) {
+        if (!isFieldLoaded || !field->exportIsoSurface(file)) {
+            msgbox->showMessage(2, ":/icons/export.png", "Iso-surface",
+                                "Failed to export the iso-surface to\n" +
+                                    file);
+        }
+    });
+
     /*  reflect operation  */
     reflect    = new Reflect(this);
     transform  = vtkTransform::New();
@@ -128,6 +201,42 @@ Viewer::Viewer(QVTKOpenGLNativeWidget* window) {
 /*  ============================================================================
  *  destructor: destroy the render object  */
 Viewer::~Viewer() {
+    //  frame time
+    renWin->RemoveObserver(renderCallback);
+    renderCallback->Delete();
+
+    //  statistics dialog
+    delete stats;
+    stats = nullptr;
+
+    //  iso-surface dialog
+    delete iso;
+    iso = nullptr;
+    delete msgbox;
+    msgbox = nullptr;
+
+    //  seeds of the arrows
+    delete glyph;
+    glyph = nullptr;
+
+    //  probe dialog
+    interact->RemoveObserver(probeCallback);
+    probeCallback->Delete();
+    probePicker->Delete();
+    delete probe;
+    probe = nullptr;
+
+    //  section view
+    sectionWidget->RemoveObserver(sectionCallback);
+    sectionWidget->Off();
+    sectionWidget->Delete();
+    sectionRep->Delete();
+    sectionCallback->Delete();
+    sectionActor->Delete();
+    sectionMapper->Delete();
+    sectionCutter->Delete();
+    sectionPlane->Delete();
+
     //  color and actor
     colors->Delete();
     colors = nullptr;
@@ -195,6 +304,11 @@ void Viewer::update() {
             showFieldGeometry();
             break;
         }
+        /*  show iso-surface  */
+        case 4: {
+            showIsoSurface();
+            break;
+        }
     }
 }
 
@@ -270,7 +384,7 @@ void Viewer::showModel() {
             isInitViewerPort = false;
             render->ResetCamera();
         }
-        renWin->Render();
+        requestRender();
 
         /*  update the model loaded flag  */
         isModelLoaded = true;
@@ -296,10 +410,43 @@ void Viewer::showMesh() {
         actor->GetProperty()->SetLineWidth(0.0);
 
         /*  show mesh and config camera  */
-        renWin->Render();
+        requestRender();
     }
 }
 
+/*  ############################################################################
+ *  showStats: show the statistics of the current field component  */
+void Viewer::showStats() {
+    if (isFieldLoaded) stats->setInputData(field, recorder[1], recorder[2]);
+    stats->show();
+    stats->raise();
+}
+
+/*  ============================================================================
+ *  showProbe: show the probe of the current field component  */
+void Viewer::showProbe() {
+    if (isFieldLoaded) probe->setInputData(field, recorder[1], recorder[2]);
+    probe->show();
+    probe->raise();
+}
+
+/*  ============================================================================
+ *  configIso: show the dialog to configure the iso-surface of density  */
+void Viewer::configIso() {
+    /*  the level is limited by the range of the density  */
+    if (isFieldLoaded) {
+        vtkDataArray* density =
+            field->getInputData()->GetCellData()->GetArray("Var-0");
+        if (density != nullptr) {
+            double* range = field->getArrayRange(density, false);
+            iso->setRange(range[0], range[1]);
+        }
+    }
+    iso->show();
+    iso->raise();
+    showIsoSurface();
+}
+
 /*  ############################################################################
  *  initPointField: initialize the specified point field from the original
  *  vtu files
@@ -313,6 +460,13 @@ void Viewer::initPointField(const int& idx, const int& comp, const bool& mode) {
     recorder[1] = idx;
     recorder[2] = comp;
 
+    /*  load the selected field on demand, it is kept while displayed  */
+    field->setShownField(idx);
+
+    /*  update the statistics of the selected field  */
+    if (stats->isVisible()) stats->setInputData(field, idx, comp);
+    if (probe->isVisible()) probe->setInputData(field, idx, comp);
+
     /*  regenerate the field variable if needed  */
     if (mode == FIELD_GENERATE) {
         //  update the field variables
@@ -378,15 +532,15 @@ void Viewer::showColorField() {
         if (isAutoLegend) {
             /*  cell field  */
             if (index >= field->getNumberOfPointData()) {
-                lut->SetTableRange(ugridFieldCur->GetCellData()
-                                       ->GetArray(name.str().c_str())
-                                       ->GetRange());
+                lut->SetTableRange(field->getArrayRange(
+                    ugridFieldCur->GetCellData()->GetArray(name.str().c_str()),
+                    isClipOutlier));
             }
             /*  point field  */
             else {
-                lut->SetTableRange(ugridFieldCur->GetPointData()
-                                       ->GetArray(name.str().c_str())
-                                       ->GetRange());
+                lut->SetTableRange(field->getArrayRange(
+                    ugridFieldCur->GetPointData()->GetArray(name.str().c_str()),
+                    isClipOutlier));
             }
         } else {
             /*  Create the LOOKUP table  */
@@ -419,7 +573,7 @@ void Viewer::showColorField() {
         render->AddActor2D(scalarBar);
 
         /*  Render the window  */
-        renWin->Render();
+        requestRender();
     }
 }
 
@@ -475,15 +629,15 @@ void Viewer::showArrowField() {
         if (isAutoLegend) {
             /*  cell field data  */
             if (index >= field->getNumberOfPointData()) {
-                lut->SetTableRange(ugridFieldCur->GetCellData()
-                                       ->GetArray(name.str().c_str())
-                                       ->GetRange());
+                lut->SetTableRange(field->getArrayRange(
+                    ugridFieldCur->GetCellData()->GetArray(name.str().c_str()),
+                    isClipOutlier));
             }
             /*  point field data  */
             else {
-                lut->SetTableRange(ugridFieldCur->GetPointData()
-                                       ->GetArray(name.str().c_str())
-                                       ->GetRange());
+                lut->SetTableRange(field->getArrayRange(
+                    ugridFieldCur->GetPointData()->GetArray(name.str().c_str()),
+                    isClipOutlier));
             }
         } else {
             /*  Create the LOOKUP table  */
@@ -494,10 +648,14 @@ void Viewer::showArrowField() {
         lut->SetHueRange(0.667, 0.0);
         lut->Build();
 
-        /*  setup the poly data  */
-        gly->SetInputConnection(portFieldCur);
+        /*  setup the poly data, the arrows are seeded on the decimated
+         *  nodes of the surface and scaled by the vectors automatically  */
+        gly->SetInputData(glyph->getSeeds(portFieldCur,
+                                          field->getFieldName(index),
+                                          GLYPH_BUDGET, GLYPH_CUTOFF));
         gly->SetSourceConnection(arrow->GetOutputPort());
-        gly->SetScaleFactor(100.0);
+        gly->SetScaleModeToScaleByVector();
+        gly->SetScaleFactor(glyph->getScaleFactor());
         gly->SetVectorModeToUseVector();
 
         /*  setup the mapper  */
@@ -517,7 +675,7 @@ void Viewer::showArrowField() {
         isScalarBarPlayed = true;
 
         /*  Render the window  */
-        renWin->Render();
+        requestRender();
     }
 }
 
@@ -563,7 +721,58 @@ void Viewer::showFieldGeometry() {
         fieldSwitchStatus[1] = false;
 
         /*  show mesh and config camera  */
-        renWin->Render();
+        requestRender();
+    }
+}
+
+/*  ============================================================================
+ *  showIsoSurface: display the iso-surface of the density in the topology
+ *  optimization on the deformed geometry  */
+void Viewer::showIsoSurface() {
+    /*  check if  the field is loaded  */
+    if (isFieldLoaded) {
+        /*  extract the iso-surface  */
+        vtkAlgorithmOutput* port = field->getIsoSurfacePort(
+            iso->getLevel(), iso->isUseSmooth(), iso->isUseDecimate());
+        if (port == nullptr) {
+            msgbox->showMessage(0, ":/icons/smooth.png", "Iso-surface",
+                                "No density is found in the field for the "
+                                "iso-surface.");
+            return;
+        }
+
+        /*  assign the recorder */
+        recorder[0] = 4;
+
+        /*  assign the flags  */
+        viewMode = USE_FIELD_MODE;
+
+        /*  set the head information  */
+        QString info = QString("Display the iso-surface of density %1")
+                           .arg(iso->getLevel());
+        configStatusBar(field->getPathName(), info);
+
+        /*  remove the scalar bar  */
+        if (isScalarBarPlayed) {
+            render->RemoveActor(scalarBar);
+            isScalarBarPlayed = false;
+        }
+
+        /*  set the data to the viewer  */
+        polyMapper->RemoveAllInputConnections(0);
+        polyMapper->SetInputConnection(port);
+        polyMapper->ScalarVisibilityOff();
+
+        /*  configure the actor  */
+        actor->GetProperty()->SetColor(colors->GetColor3d("cyan").GetData());
+        actor->SetMapper(polyMapper);
+
+        /*  update the field switch status  */
+        fieldSwitchStatus[0] = false;
+        fieldSwitchStatus[1] = false;
+
+        /*  show the iso-surface  */
+        requestRender();
     }
 }
 
@@ -670,7 +879,7 @@ void Viewer::showCameraAxonometric() {
     render->GetActiveCamera()->Azimuth(45.0);
     render->GetActiveCamera()->Dolly(1.0);
     render->ResetCamera();
-    renWin->Render();
+    requestRender();
 }
 
 /*  ============================================================================
@@ -684,7 +893,7 @@ void Viewer::showCameraXY() {
     render->GetActiveCamera()->Dolly(1.0);
     render->GetActiveCamera()->ParallelProjectionOn();
     render->ResetCamera();
-    renWin->Render();
+    requestRender();
 }
 
 /*  ============================================================================
@@ -698,7 +907,7 @@ void Viewer::showCameraXZ() {
     render->GetActiveCamera()->SetViewUp(0, 0, 1);
     render->GetActiveCamera()->ParallelProjectionOn();
     render->ResetCamera();
-    renWin->Render();
+    requestRender();
 }
 
 /*  ============================================================================
@@ -712,7 +921,7 @@ void Viewer::showCameraYZ() {
     render->GetActiveCamera()->Azimuth(-90.0);
     render->GetActiveCamera()->ParallelProjectionOn();
     render->ResetCamera();
-    renWin->Render();
+    requestRender();
 }
 
 /*  ############################################################################
@@ -775,3 +984,150 @@ void Viewer::configScalarBar() {
     scalarBar->GetTitleTextProperty()->SetBold(0);
     scalarBar->GetTitleTextProperty()->SetItalic(0);
 }
+
+/*  ############################################################################
+ *  activeSectionMode: show or hide the section plane, which cuts through the
+ *  currently displayed model or field. The part in front of the plane is
+ *  clipped away, and the plane can be dragged interactively.
+ *  @param  mode: true to show the section, otherwise hide it
+ *  @return  true if the section is shown, which needs a loaded model  */
+bool Viewer::activeSectionMode(const bool& mode) {
+    /*  check the status  */
+    if (!isModelLoaded || mode == isSectionActive) return isSectionActive;
+    isSectionActive = mode;
+
+    if (mode) {
+        /*  place the plane at the center of the displayed object  */
+        double bounds[6];
+        actor->GetBounds(bounds);
+        sectionRep->PlaceWidget(bounds);
+        sectionRep->SetOrigin(0.5 * (bounds[0] + bounds[1]),
+                              0.5 * (bounds[2] + bounds[3]),
+                              0.5 * (bounds[4] + bounds[5]));
+        sectionRep->SetNormal(1.0, 0.0, 0.0);
+        sectionRep->GetPlane(sectionPlane);
+
+        /*  show the section and clip the object  */
+        dtMap->AddClippingPlane(sectionPlane);
+        polyMapper->AddClippingPlane(sectionPlane);
+        render->AddActor(sectionActor);
+        sectionWidget->On();
+        syncSection();
+    } else {
+        /*  hide the section and restore the object  */
+        sectionWidget->Off();
+        render->RemoveActor(sectionActor);
+        dtMap->RemoveClippingPlane(sectionPlane);
+        polyMapper->RemoveClippingPlane(sectionPlane);
+    }
+
+    /*  update the display  */
+    requestRender();
+    return isSectionActive;
+}
+
+/*  ============================================================================
+ *  syncSection: make the section follow the current port and colors  */
+void Viewer::syncSection() {
+    /*  cut the object that is displayed, the sphere tree is only rebuilt by
+     *  the cutter when the port has been changed  */
+    vtkAlgorithmOutput* port =
+        viewMode == USE_FIELD_MODE ? portFieldCur : portModelCur;
+    if (sectionCutter->GetInputConnection(0, 0) != port) {
+        sectionCutter->SetInputConnection(port);
+    }
+
+    /*  color the section as the displayed object  */
+    vtkMapper* mapper = actor->GetMapper();
+    if (mapper == nullptr) return;
+    sectionMapper->SetLookupTable(mapper->GetLookupTable());
+    sectionMapper->SetScalarVisibility(mapper->GetScalarVisibility());
+    sectionMapper->SetScalarMode(mapper->GetScalarMode());
+    sectionMapper->SetScalarRange(mapper->GetScalarRange());
+    sectionMapper->SelectColorArray(mapper->GetArrayName());
+    sectionMapper->SetArrayComponent(mapper->GetArrayComponent());
+    sectionMapper->SetUseLookupTableScalarRange(
+        mapper->GetUseLookupTableScalarRange());
+    sectionActor->GetProperty()->SetColor(actor->GetProperty()->GetColor());
+}
+
+/*  ============================================================================
+ *  onSectionEvent: callback of the plane widget
+ *  @param  caller: the object that invokes the event
+ *  @param  event: the id of the event
+ *  @param  client: the viewer object
+ *  @param  data: the data of the event  */
+void Viewer::onSectionEvent(vtkObject* caller, unsigned long event,
+                            void* client, void* data) {
+    Viewer* viewer = static_cast<Viewer*>(client);
+    if (!viewer->isSectionActive) return;
+
+    switch (event) {
+        /*  the plane is dragged, only the cutter is executed again  */
+        case vtkCommand::InteractionEvent: {
+            viewer->sectionRep->GetPlane(viewer->sectionPlane);
+            viewer->syncSection();
+            break;
+        }
+    }
+}
+
+/*  ============================================================================
+ *  onRenderEvent: callback of the render window to measure the time of every
+ *  frame, including those rendered by the interactor
+ *  @param  caller: the object that invokes the event
+ *  @param  event: the id of the event
+ *  @param  client: the viewer object
+ *  @param  data: the data of the event  */
+void Viewer::onRenderEvent(vtkObject* caller, unsigned long event,
+                           void* client, void* data) {
+    Viewer* viewer = static_cast<Viewer*>(client);
+    if (event == vtkCommand::StartEvent) {
+        viewer->renderClock.restart();
+        return;
+    }
+    double* time = viewer->renderTime;
+    time[0]      = viewer->renderClock.nsecsElapsed() * 1.0e-6;
+    time[1]      = time[1] == 0.0 ? time[0] : 0.9 * time[1] + 0.1 * time[0];
+    emit viewer->rendered();
+}
+
+/*  ============================================================================
+ *  onProbeEvent: callback of the click to pick the probe points
+ *  @param  caller: the object that invokes the event
+ *  @param  event: the id of the event
+ *  @param  client: the viewer object
+ *  @param  data: the data of the event  */
+void Viewer::onProbeEvent(vtkObject* caller, unsigned long event,
+                          void* client, void* data) {
+    Viewer* viewer = static_cast<Viewer*>(client);
+    if (!viewer->isProbePicking || !viewer->isFieldLoaded) return;
+
+    /*  pick the point on the displayed cells  */
+    int* position = viewer->interact->GetEventPosition();
+    viewer->probePicker->Pick(position[0], position[1], 0.0, viewer->render);
+    if (viewer->probePicker->GetCellId() >= 0) {
+        viewer->probe->addPoint(viewer->probePicker->GetPickPosition());
+    }
+}
+
+/*  ############################################################################
+ *  requestRender: mark the view as dirty, the requests are coalesced into one
+ *  render in the event loop, and at most one render per frame  */
+void Viewer::requestRender() {
+    /*  the pending render will show the latest state  */
+    if (renderTimer->isActive()) return;
+
+    /*  wait for the rest of the frame since the last render  */
+    qint64 elapsed = renderClock.elapsed();
+    renderTimer->start(int(std::max<qint64>(RENDER_FRAME_INTERVAL - elapsed,
+                                            0)));
+}
+
+/*  ============================================================================
+ *  renderNow: render the dirty view, the frame time is measured by the events
+ *  of the render window, and the section follows the displayed object  */
+void Viewer::renderNow() {
+    if (isSectionActive) syncSection();
+    renWin->Render();
+}
@@ -20,15 +20,21 @@
 #include <vtkActor.h>
 #include <vtkArrowSource.h>
 #include <vtkAxesActor.h>
+#include <vtkCallbackCommand.h>
 #include <vtkCamera.h>
+#include <vtkCellPicker.h>
 #include <vtkDataSetMapper.h>
 #include <vtkDoubleArray.h>
 #include <vtkGenericOpenGLRenderWindow.h>
 #include <vtkGlyph3D.h>
+#include <vtkImplicitPlaneRepresentation.h>
+#include <vtkImplicitPlaneWidget2.h>
 #include <vtkInteractorStyleTrackballCamera.h>
 #include <vtkLookupTable.h>
 #include <vtkNamedColors.h>
 #include <vtkOrientationMarkerWidget.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCutter.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProp.h>
 #include <vtkProperty.h>
@@ -42,15 +48,22 @@
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
 
+#include <QElapsedTimer>
 #include <QObject>
+#include <QTimer>
 #include <QWidget>
 #include <sstream>
 
 #include "camera.h"
 #include "field.h"
+#include "glyph.h"
+#include "iso.h"
+#include "messagebox.h"
 #include "pick.h"
 #include "post.h"
+#include "probe.h"
 #include "reflect.h"
+#include "stats.h"
 
 /*  ############################################################################
  *  class Viewer: the class to define the visualization interface, which
@@ -71,6 +84,10 @@ private:
 
     Camera* camera;                        // camera configuration
     Post* post;                            // postprocessing config
+    Stats* stats;                          // statistics of the field
+    Iso* iso;                              // iso-surface of the density
+    Probe* probe;                          // probe of the field
+    MessageBox* msgbox;                    // message box to show the errors
 
     QVTKOpenGLNativeWidget* win;           // main window
     vtkGenericOpenGLRenderWindow* renWin;  // render window
@@ -86,6 +103,10 @@ private:
     vtkScalarBarActor* scalarBar;          // scalar bar
     bool isScalarBarPlayed;                // the scalarbar is acted
     vtkTextActor* status;                  // status bar
+    QTimer* renderTimer;                   // coalesces the render requests
+    QElapsedTimer renderClock;             // time since the last render
+    double renderTime[2];                  // last and averaged frame in ms
+    vtkCallbackCommand* renderCallback;    // start and end of the frames
     std::stringstream time;                // current time
 
     vtkAlgorithmOutput* pickSource;        // source for picking
@@ -101,14 +122,29 @@ private:
 
     vtkArrowSource* arrow;                         // arrow source object
     vtkGlyph3D* gly;                               // show the glyph
+    Glyph* glyph;                                  // seeds of the glyph
     vtkPolyDataMapper* polyMapper;                 // polydata mapper
 
     Reflect* reflect;                              // reflect object
     vtkTransform* transform;                       // transformer
     vtkTransformFilter* refOperate;                // mirror the structure
 
+    vtkPlane* sectionPlane;                        // plane of the section
+    vtkPlaneCutter* sectionCutter;                 // cutter with sphere tree
+    vtkImplicitPlaneWidget2* sectionWidget;        // widget to drag the plane
+    vtkImplicitPlaneRepresentation* sectionRep;    // shape of the widget
+    vtkCallbackCommand* sectionCallback;           // events of the plane
+    vtkDataSetMapper* sectionMapper;               // mapper of the section
+    vtkActor* sectionActor;                        // actor of the section
+    bool isSectionActive;                          // section is shown or not
+
+    vtkCellPicker* probePicker;                    // picker of probe points
+    vtkCallbackCommand* probeCallback;             // click in the viewer
+    bool isProbePicking;                           // probe points are picked
+
     int numIntervals;                              // number of legend intervals
     bool isAutoLegend;                             // auto legend range or not
+    bool isClipOutlier;                            // clip legend outliers
     bool fieldSwitchStatus[2];                     // the status of field switch
 
     char compName[3] = {'X', 'Y', 'Z'};            // component name
@@ -131,6 +167,29 @@ public:
     /*  configReflect: show the dialog to configure the reflection  */
     void configReflect() { reflect->show(); }
 
+    /*  showStats: show the statistics of the current field component  */
+    void showStats();
+
+    /*  showProbe: show the probe of the current field component  */
+    void showProbe();
+
+    /*  configIso: show the dialog to configure the iso-surface of density  */
+    void configIso();
+
+    /*  requestRender: mark the view as dirty, the requests are coalesced into
+     *  one render in the event loop, and at most one render per frame  */
+    void requestRender();
+
+    /*  getRenderTime: get the time of the last frame and the exponential
+     *  average of the frames in milliseconds
+     *  @return  the last and averaged render time  */
+    const double* getRenderTime() { return renderTime; }
+
+signals:
+    /*  rendered: the view is rendered, and the frame time is updated  */
+    void rendered();
+
+public:
     /*  configure the small widget in the render window  */
     void showCameraAxonometric();  // show the axonometric view
     void showCameraXY();           // set the camera to the XY plane
@@ -180,6 +239,13 @@ public:
      *  @return  the picker status  */
     bool isPickerActivated() { return pick->isPickerActivated(); }
 
+    /*  activeSectionMode: show or hide the section plane, which cuts through
+     *  the currently displayed model or field. The part in front of the
+     *  plane is clipped away, and the plane can be dragged interactively.
+     *  @param  mode: true to show the section, otherwise hide it
+     *  @return  true if the section is shown, which needs a loaded model  */
+    bool activeSectionMode(const bool& mode);
+
     /*  turnOffPickMode: turn off the picker mode  */
     void turnOffPickMode() {
         pick->turnOff();
@@ -206,6 +272,10 @@ public:
      *  it includes the nodal displacement, reaction force and so on  */
     void showFieldGeometry();
 
+    /*  showIsoSurface: display the iso-surface of the density in the topology
+     *  optimization on the deformed geometry  */
+    void showIsoSurface();
+
     /*  initMirrorField: show the reflected field according to the specified
      *  parameters  */
     void initMirrorField();
@@ -228,5 +298,38 @@ private:
 
     /*  update: update the displayed object using the current port  */
     void update();
+
+    /*  renderNow: render the dirty view, the frame time is measured by the
+     *  events of the render window, and the section follows the displayed
+     *  object  */
+    void renderNow();
+
+    /*  syncSection: make the section follow the current port and colors  */
+    void syncSection();
+
+    /*  onSectionEvent: callback of the plane widget
+     *  @param  caller: the object that invokes the event
+     *  @param  event: the id of the event
+     *  @param  client: the viewer object
+     *  @param  data: the data of the event  */
+    static void onSectionEvent(vtkObject* caller, unsigned long event,
+                               void* client, void* data);
+
+    /*  onProbeEvent: callback of the click to pick the probe points
+     *  @param  caller: the object that invokes the event
+     *  @param  event: the id of the event
+     *  @param  client: the viewer object
+     *  @param  data: the data of the event  */
+    static void onProbeEvent(vtkObject* caller, unsigned long event,
+                             void* client, void* data);
+
+    /*  onRenderEvent: callback of the render window to measure the time of
+     *  every frame, including those rendered by the interactor
+     *  @param  caller: the object that invokes the event
+     *  @param  event: the id of the event
+     *  @param  client: the viewer object
+     *  @param  data: the data of the event  */
+    static void onRenderEvent(vtkObject* caller, unsigned long event,
+                              void* client, void* data);
 };
 #endif  // VIEWER_H